@@ -1,7 +1,14 @@
 //! Core analyzer types and traits
 
+use once_cell::sync::Lazy;
+use rayon::{Scope, ThreadPool, ThreadPoolBuilder};
 use serde::{Deserialize, Serialize};
+use serde_json::Value;
+use std::collections::{BTreeMap, HashMap};
+use std::panic::{self, AssertUnwindSafe};
 use std::path::Path;
+use std::sync::atomic::{AtomicBool, Ordering};
+use std::sync::{mpsc, Arc, Mutex};
 
 /// Output from a game analyzer
 #[derive(Debug, Clone, Serialize, Deserialize)]
@@ -47,11 +54,434 @@ pub struct TextEntry {
     pub text: Option<String>,
 }
 
+/// Version of the `files` output schema written by the engines.
+///
+/// Version 1 was `{"strings": [TextEntry, ...]}`, repeating the file path in every entry.
+/// Version 2 stores the path once per file:
+/// `{"schemaVersion": 2, "files": [{"path": ..., "entries": [{"source": ..., "key": ...}]}]}`,
+/// optionally with a `pool` of unique texts that entries reference as `{"sourceId": n, "key": ...}`.
+pub const SCHEMA_VERSION: u32 = 2;
+
+/// A text entry inside a [`FileEntries`] record; the file path lives on the record
+#[derive(Debug, Clone, Serialize, Deserialize)]
+pub struct FileEntry {
+    /// Original source text
+    pub source: String,
+    /// Key path within the file
+    pub key: String,
+    /// Translated text, if any
+    #[serde(skip_serializing_if = "Option::is_none")]
+    pub text: Option<String>,
+}
+
+impl From<TextEntry> for FileEntry {
+    fn from(entry: TextEntry) -> Self {
+        Self {
+            source: entry.source,
+            key: entry.key,
+            text: entry.text,
+        }
+    }
+}
+
+/// All entries extracted from one file (schema version 2)
+#[derive(Debug, Clone, Serialize, Deserialize)]
+pub struct FileEntries {
+    /// File path shared by all entries
+    pub path: String,
+    /// Entries in extraction order
+    pub entries: Vec<FileEntry>,
+}
+
+impl FileEntries {
+    /// Builds the record of one file from entries extracted from it
+    pub fn new(path: impl Into<String>, entries: Vec<TextEntry>) -> Self {
+        Self {
+            path: path.into(),
+            entries: entries.into_iter().map(FileEntry::from).collect(),
+        }
+    }
+}
+
+/// Unique texts of an analysis, addressed by their position (the `pool` member of schema 2)
+#[derive(Debug, Default)]
+pub struct StringPool {
+    strings: Vec<String>,
+    ids: HashMap<String, u32>,
+}
+
+impl StringPool {
+    /// Returns the id of `text`, adding it if it is not pooled yet
+    pub fn intern(&mut self, text: String) -> u32 {
+        if let Some(&id) = self.ids.get(&text) {
+            return id;
+        }
+        let id = self.strings.len() as u32;
+        self.strings.push(text.clone());
+        self.ids.insert(text, id);
+        id
+    }
+
+    /// The pooled texts, in id order
+    pub fn into_strings(self) -> Vec<String> {
+        self.strings
+    }
+}
+
+/// Entry of a pooled record: its text is `pool[sourceId]`
+#[derive(Debug, Clone, Serialize, Deserialize)]
+pub struct PooledEntry {
+    /// Index into the pool
+    #[serde(rename = "sourceId")]
+    pub source_id: u32,
+    /// Key path within the file
+    pub key: String,
+}
+
+/// All entries extracted from one file, with their texts in a shared pool
+#[derive(Debug, Clone, Serialize, Deserialize)]
+pub struct PooledFileEntries {
+    /// File path shared by all entries
+    pub path: String,
+    /// Entries in extraction order
+    pub entries: Vec<PooledEntry>,
+}
+
+/// Moves the texts of `files` into a pool so repeated texts (names, choices, system lines) are
+/// written once. Returns the pool and the records referencing it.
+pub fn pool_files(files: Vec<FileEntries>) -> (Vec<String>, Vec<PooledFileEntries>) {
+    let mut pool = StringPool::default();
+    let pooled = files
+        .into_iter()
+        .map(|file| PooledFileEntries {
+            path: file.path,
+            entries: file
+                .entries
+                .into_iter()
+                .map(|entry| PooledEntry {
+                    source_id: pool.intern(entry.source),
+                    key: entry.key,
+                })
+                .collect(),
+        })
+        .collect();
+    (pool.into_strings(), pooled)
+}
+
+/// Reverses [`pool_files`]: the records of a schema 2 result, with pooled texts resolved.
+/// Entries whose `sourceId` is out of range are dropped.
+pub fn files_from_result(result: &Value) -> Vec<FileEntries> {
+    let pool: Vec<&str> = result["pool"]
+        .as_array()
+        .map(|pool| pool.iter().map(|text| text.as_str().unwrap_or_default()).collect())
+        .unwrap_or_default();
+
+    let Some(files) = result["files"].as_array() else {
+        return Vec::new();
+    };
+
+    files
+        .iter()
+        .map(|file| FileEntries {
+            path: file["path"].as_str().unwrap_or_default().to_string(),
+            entries: file["entries"]
+                .as_array()
+                .map(|entries| {
+                    entries
+                        .iter()
+                        .filter_map(|entry| {
+                            let source = match entry.get("sourceId").and_then(Value::as_u64) {
+                                Some(id) => pool.get(id as usize)?.to_string(),
+                                None => entry["source"].as_str()?.to_string(),
+                            };
+                            Some(FileEntry {
+                                source,
+                                key: entry["key"].as_str().unwrap_or_default().to_string(),
+                                text: None,
+                            })
+                        })
+                        .collect()
+                })
+                .unwrap_or_default(),
+        })
+        .collect()
+}
+
+/// How an [`GameAnalyzer::analyze_stream`] run ended
+#[derive(Debug, Clone, Copy, PartialEq, Eq)]
+pub enum StreamStatus {
+    /// Every file was delivered
+    Finished,
+    /// The sink asked to stop
+    Cancelled,
+}
+
+/// Receives an analysis file by file as the engine produces it
+pub trait AnalysisSink {
+    /// Fonts shipped with the project, before the first file. Returning `false` stops the analysis.
+    fn fonts(&mut self, _fonts: &[Value]) -> bool {
+        true
+    }
+
+    /// Entries extracted from one file. Returning `false` stops the analysis.
+    fn file(&mut self, file: FileEntries) -> bool;
+
+    /// `done` of `total` files have been read. Returning `false` stops the analysis.
+    fn progress(&mut self, _done: usize, _total: usize) -> bool {
+        true
+    }
+
+    /// Totals of a finished analysis
+    fn finished(&mut self, _files_processed: usize, _files_failed: usize) {}
+}
+
+/// Sink that keeps everything, for engines whose `analyze` is built on `analyze_stream`
+#[derive(Debug, Default)]
+pub struct CollectingSink {
+    pub fonts: Vec<Value>,
+    pub files: Vec<FileEntries>,
+    pub files_processed: usize,
+    pub files_failed: usize,
+}
+
+impl AnalysisSink for CollectingSink {
+    fn fonts(&mut self, fonts: &[Value]) -> bool {
+        self.fonts = fonts.to_vec();
+        true
+    }
+
+    fn file(&mut self, file: FileEntries) -> bool {
+        self.files.push(file);
+        true
+    }
+
+    fn finished(&mut self, files_processed: usize, files_failed: usize) {
+        self.files_processed = files_processed;
+        self.files_failed = files_failed;
+    }
+}
+
+/// How an engine spreads per-file work over threads.
+///
+/// Parsed from the `options_json` of the FFI, e.g. `{"threads": 4, "deterministic": true}`;
+/// missing members keep their default.
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Serialize, Deserialize)]
+#[serde(default)]
+pub struct AnalysisOptions {
+    /// Worker threads; 0 uses rayon's global pool (one per core), 1 runs serially on the
+    /// calling thread
+    pub threads: usize,
+    /// Deliver files in input order, so the output is byte-identical to a serial run. When
+    /// false, files are delivered as soon as they are done and only their order may differ.
+    pub deterministic: bool,
+}
+
+impl Default for AnalysisOptions {
+    fn default() -> Self {
+        Self {
+            threads: 0,
+            deterministic: true,
+        }
+    }
+}
+
+impl AnalysisOptions {
+    /// Parses `options_json`; an empty string gives the defaults
+    pub fn from_json(options_json: &str) -> Result<Self, String> {
+        if options_json.trim().is_empty() {
+            return Ok(Self::default());
+        }
+        serde_json::from_str(options_json).map_err(|e| format!("Invalid analysis options: {}", e))
+    }
+}
+
+/// Pools of a given size, built on first use and kept for the life of the process
+static SIZED_POOLS: Lazy<Mutex<HashMap<usize, Arc<ThreadPool>>>> = Lazy::new(Default::default);
+
+fn sized_pool(threads: usize) -> Result<Arc<ThreadPool>, String> {
+    let mut pools = SIZED_POOLS
+        .lock()
+        .unwrap_or_else(|poisoned| poisoned.into_inner());
+    if let Some(pool) = pools.get(&threads) {
+        return Ok(Arc::clone(pool));
+    }
+    let pool = ThreadPoolBuilder::new()
+        .num_threads(threads)
+        .build()
+        .map_err(|e| format!("Failed to start worker threads: {}", e))?;
+    let pool = Arc::new(pool);
+    pools.insert(threads, Arc::clone(&pool));
+    Ok(pool)
+}
+
+/// Runs `work` on every item on a pool of `options.threads` threads and hands the results to
+/// `deliver` on the calling thread, with the index of their item: in item order when
+/// `options.deterministic`, in completion order otherwise.
+///
+/// With `options.threads == 0` the work goes to rayon's global pool; other sizes get a pool
+/// that is built once and reused by every later analysis. At most two results per thread are
+/// running or waiting for their turn at any time, so a slow item does not make every later
+/// result pile up in memory.
+///
+/// Returns `Ok(false)` as soon as `deliver` returns `false`; items not started yet are skipped.
+pub fn for_each_parallel<T, R, W, D>(
+    options: &AnalysisOptions,
+    items: &[T],
+    work: W,
+    mut deliver: D,
+) -> Result<bool, String>
+where
+    T: Sync,
+    R: Send,
+    W: Fn(&T) -> R + Sync,
+    D: FnMut(usize, R) -> bool,
+{
+    if options.threads == 1 || items.len() < 2 {
+        for (index, item) in items.iter().enumerate() {
+            if !deliver(index, work(item)) {
+                return Ok(false);
+            }
+        }
+        return Ok(true);
+    }
+
+    let cancelled = AtomicBool::new(false);
+    let window = Window {
+        size: 2 * if options.threads == 0 {
+            rayon::current_num_threads()
+        } else {
+            options.threads
+        },
+        deterministic: options.deterministic,
+    };
+
+    // The calling thread only receives: sinks (and the C callbacks behind them) never see a worker
+    let finished = if options.threads == 0 {
+        rayon::in_place_scope(|scope| {
+            run_scoped(scope, items, &work, &cancelled, window, &mut deliver)
+        })
+    } else {
+        sized_pool(options.threads)?.in_place_scope(|scope| {
+            run_scoped(scope, items, &work, &cancelled, window, &mut deliver)
+        })
+    };
+
+    Ok(finished)
+}
+
+/// How many items [`for_each_parallel`] keeps in flight, and in which order it delivers them
+#[derive(Clone, Copy)]
+struct Window {
+    size: usize,
+    deterministic: bool,
+}
+
+/// Body of [`for_each_parallel`] inside a pool's scope
+fn run_scoped<'scope, T, R, W, D>(
+    scope: &Scope<'scope>,
+    items: &'scope [T],
+    work: &'scope W,
+    cancelled: &'scope AtomicBool,
+    window: Window,
+    deliver: &mut D,
+) -> bool
+where
+    T: Sync,
+    R: Send + 'scope,
+    W: Fn(&T) -> R + Sync,
+    D: FnMut(usize, R) -> bool,
+{
+    let (sender, receiver) = mpsc::channel();
+    let spawn = |index: usize| {
+        let sender = sender.clone();
+        let item = &items[index];
+        scope.spawn(move |_| {
+            if !cancelled.load(Ordering::Relaxed) {
+                // A panic is sent back too, so the receiving loop never waits for a lost result
+                let _ = sender.send((index, panic::catch_unwind(AssertUnwindSafe(|| work(item)))));
+            }
+        });
+    };
+
+    // Every received result starts the next item, so running plus pending stays within the window
+    let mut spawned = items.len().min(window.size.max(1));
+    (0..spawned).for_each(spawn);
+
+    // Results that arrived ahead of their turn
+    let mut pending = BTreeMap::new();
+    let mut next = 0;
+    for _ in 0..items.len() {
+        let Ok((index, result)) = receiver.recv() else {
+            break;
+        };
+        let result = match result {
+            Ok(result) => result,
+            Err(payload) => {
+                cancelled.store(true, Ordering::Relaxed);
+                panic::resume_unwind(payload);
+            }
+        };
+        if spawned < items.len() {
+            spawn(spawned);
+            spawned += 1;
+        }
+
+        if !window.deterministic {
+            if !deliver(index, result) {
+                cancelled.store(true, Ordering::Relaxed);
+                return false;
+            }
+            continue;
+        }
+        pending.insert(index, result);
+        while let Some(result) = pending.remove(&next) {
+            if !deliver(next, result) {
+                cancelled.store(true, Ordering::Relaxed);
+                return false;
+            }
+            next += 1;
+        }
+    }
+    true
+}
+
 /// Trait for game analyzers
 pub trait GameAnalyzer: Send + Sync {
     /// Analyze a game project and extract translatable strings
     fn analyze(&self, input_path: &Path) -> AnalyzerOutput;
 
+    /// Analyze a game project, handing each file's entries to `sink` as soon as it is extracted.
+    ///
+    /// The default implementation runs [`GameAnalyzer::analyze`] and replays its result.
+    fn analyze_stream(
+        &self,
+        input_path: &Path,
+        sink: &mut dyn AnalysisSink,
+    ) -> Result<StreamStatus, String> {
+        let output = self.analyze(input_path);
+        if let Some(error) = output.error_message {
+            return Err(error);
+        }
+        let result: Value = serde_json::from_str(&output.payload).map_err(|e| e.to_string())?;
+
+        let fonts = result["fonts"].as_array().cloned().unwrap_or_default();
+        if !sink.fonts(&fonts) {
+            return Ok(StreamStatus::Cancelled);
+        }
+        let files = files_from_result(&result);
+        let total = files.len();
+        for (done, file) in files.into_iter().enumerate() {
+            if !sink.file(file) || !sink.progress(done + 1, total) {
+                return Ok(StreamStatus::Cancelled);
+            }
+        }
+        sink.finished(
+            result["filesProcessed"].as_u64().unwrap_or(total as u64) as usize,
+            result["filesFailed"].as_u64().unwrap_or(0) as usize,
+        );
+        Ok(StreamStatus::Finished)
+    }
+
     /// Save translated texts back to the game files
     fn save(&self, texts: &[TextEntry]) -> Result<(), String>;
 
@@ -70,3 +500,83 @@ pub trait GameAnalyzer: Send + Sync {
         None
     }
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_file_entries_store_path_once() {
+        let entries = vec![
+            TextEntry {
+                source: "Hello".to_string(),
+                path: "data/Map001.json".to_string(),
+                key: "events[1].pages[0].list[0].parameters[0]".to_string(),
+                text: None,
+            },
+            TextEntry {
+                source: "Bye".to_string(),
+                path: "data/Map001.json".to_string(),
+                key: "events[1].pages[0].list[1].parameters[0]".to_string(),
+                text: Some("Au revoir".to_string()),
+            },
+        ];
+
+        let record = serde_json::to_value(FileEntries::new("data/Map001.json", entries)).unwrap();
+
+        assert_eq!(record["path"], "data/Map001.json");
+        assert_eq!(record["entries"][0]["source"], "Hello");
+        assert!(record["entries"][0].get("path").is_none());
+        assert!(record["entries"][0].get("text").is_none());
+        assert_eq!(record["entries"][1]["text"], "Au revoir");
+    }
+
+    #[test]
+    fn test_for_each_parallel_keeps_item_order() {
+        let items: Vec<usize> = (0..64).collect();
+        let options = AnalysisOptions::from_json(r#"{"threads": 4}"#).unwrap();
+        assert!(options.deterministic);
+
+        let mut delivered = Vec::new();
+        let finished = for_each_parallel(&options, &items, |item| item * 2, |index, result| {
+            delivered.push((index, result));
+            true
+        })
+        .unwrap();
+
+        assert!(finished);
+        let expected: Vec<_> = items.iter().map(|&item| (item, item * 2)).collect();
+        assert_eq!(delivered, expected);
+
+        let mut count = 0;
+        let finished = for_each_parallel(&options, &items, |item| *item, |_, _| {
+            count += 1;
+            count < 3
+        })
+        .unwrap();
+        assert!(!finished);
+        assert_eq!(count, 3);
+        assert!(AnalysisOptions::from_json("{").is_err());
+    }
+
+    #[test]
+    fn test_pool_files_shares_repeated_texts() {
+        let entry = |source: &str, key: &str| TextEntry {
+            source: source.to_string(),
+            path: String::new(),
+            key: key.to_string(),
+            text: None,
+        };
+        let files = vec![
+            FileEntries::new("a.json", vec![entry("Yes", "0"), entry("No", "1")]),
+            FileEntries::new("b.json", vec![entry("Yes", "0")]),
+        ];
+
+        let (pool, pooled) = pool_files(files);
+
+        assert_eq!(pool, vec!["Yes".to_string(), "No".to_string()]);
+        assert_eq!(pooled[0].entries[1].source_id, 1);
+        assert_eq!(pooled[1].entries[0].source_id, 0);
+        assert_eq!(pooled[1].path, "b.json");
+    }
+}
@@ -0,0 +1,155 @@
+//! Manifest of analyzed files for incremental re-analysis
+//!
+//! Same scheme as the C++ `core::AnalysisCache`: a file whose size and modification time are
+//! unchanged is reused without being read, a file that was only touched (same content hash)
+//! is reused without being parsed. The manifest is tied to an analyzer signature, so changes
+//! to the extraction rules invalidate it as a whole.
+
+use crate::analyzer::FileEntry;
+use serde::{Deserialize, Serialize};
+use std::collections::HashMap;
+use std::fs;
+use std::path::{Path, PathBuf};
+use std::time::UNIX_EPOCH;
+
+const MANIFEST_VERSION: u32 = 1;
+
+/// What the manifest remembers of one file
+#[derive(Debug, Clone, Serialize, Deserialize)]
+pub struct CachedFile {
+    pub size: u64,
+    /// Milliseconds since the epoch
+    pub mtime: u64,
+    /// FNV-1a of the contents, in hex
+    pub hash: String,
+    pub entries: Vec<FileEntry>,
+}
+
+#[derive(Serialize, Deserialize)]
+struct Manifest {
+    version: u32,
+    signature: String,
+    files: HashMap<String, CachedFile>,
+}
+
+/// An analysis manifest bound to a file and a signature
+pub struct AnalysisCache {
+    path: PathBuf,
+    signature: String,
+    files: HashMap<String, CachedFile>,
+}
+
+impl AnalysisCache {
+    /// Reads the manifest at `path`. It starts empty if the file does not exist, cannot be
+    /// parsed or was written for another signature.
+    pub fn load(path: &Path, signature: &str) -> Self {
+        let files = fs::read(path)
+            .ok()
+            .and_then(|bytes| serde_json::from_slice::<Manifest>(&bytes).ok())
+            .filter(|manifest| manifest.version == MANIFEST_VERSION && manifest.signature == signature)
+            .map(|manifest| manifest.files)
+            .unwrap_or_default();
+        Self {
+            path: path.to_path_buf(),
+            signature: signature.to_string(),
+            files,
+        }
+    }
+
+    pub fn len(&self) -> usize {
+        self.files.len()
+    }
+
+    pub fn is_empty(&self) -> bool {
+        self.files.is_empty()
+    }
+
+    /// The entry of `path` if the file still has the recorded size and modification time
+    pub fn find_current(&self, path: &str, metadata: &fs::Metadata) -> Option<&CachedFile> {
+        self.files
+            .get(path)
+            .filter(|cached| cached.size == metadata.len() && Some(cached.mtime) == mtime_millis(metadata))
+    }
+
+    /// The entry of `path` whatever its fingerprint, to compare content hashes
+    pub fn find(&self, path: &str) -> Option<&CachedFile> {
+        self.files.get(path)
+    }
+
+    /// Replaces the recorded files; files not in `files` are forgotten
+    pub fn replace(&mut self, files: HashMap<String, CachedFile>) {
+        self.files = files;
+    }
+
+    /// Writes the manifest through a temporary file renamed over the old one
+    pub fn save(&self) -> Result<(), String> {
+        let manifest = Manifest {
+            version: MANIFEST_VERSION,
+            signature: self.signature.clone(),
+            files: self.files.clone(),
+        };
+        let bytes = serde_json::to_vec(&manifest).map_err(|e| e.to_string())?;
+        let temp_path = self.path.with_extension("json.tmp");
+        fs::write(&temp_path, bytes)
+            .and_then(|()| fs::rename(&temp_path, &self.path))
+            .map_err(|e| format!("Failed to write {}: {}", self.path.display(), e))
+    }
+}
+
+/// Modification time of `metadata` in milliseconds since the epoch
+pub fn mtime_millis(metadata: &fs::Metadata) -> Option<u64> {
+    let modified = metadata.modified().ok()?;
+    Some(modified.duration_since(UNIX_EPOCH).ok()?.as_millis() as u64)
+}
+
+/// Content hash stored in the manifest. Only has to tell edited files from touched ones.
+pub fn hash_content(content: &[u8]) -> String {
+    let mut hash: u64 = 0xcbf2_9ce4_8422_2325;
+    for &byte in content {
+        hash ^= u64::from(byte);
+        hash = hash.wrapping_mul(0x0100_0000_01b3);
+    }
+    format!("{:016x}", hash)
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn test_manifest_round_trip_and_signature() {
+        let dir = std::env::temp_dir().join(format!("bga_rs_manifest_{}", std::process::id()));
+        fs::create_dir_all(&dir).unwrap();
+        let data_file = dir.join("System.json");
+        fs::write(&data_file, r#"{"gameTitle":"Title"}"#).unwrap();
+        let metadata = fs::metadata(&data_file).unwrap();
+        let manifest_path = dir.join("Game.analysis.json");
+        let key = data_file.to_string_lossy().to_string();
+
+        let mut cache = AnalysisCache::load(&manifest_path, "rpgm-rs/1");
+        assert!(cache.is_empty());
+        let mut files = HashMap::new();
+        files.insert(
+            key.clone(),
+            CachedFile {
+                size: metadata.len(),
+                mtime: mtime_millis(&metadata).unwrap(),
+                hash: hash_content(b"{\"gameTitle\":\"Title\"}"),
+                entries: vec![FileEntry {
+                    source: "Title".to_string(),
+                    key: "gameTitle".to_string(),
+                    text: None,
+                }],
+            },
+        );
+        cache.replace(files);
+        cache.save().unwrap();
+
+        let reloaded = AnalysisCache::load(&manifest_path, "rpgm-rs/1");
+        let foreign = AnalysisCache::load(&manifest_path, "another-analyzer");
+        fs::remove_dir_all(&dir).unwrap();
+
+        assert_eq!(reloaded.find_current(&key, &metadata).unwrap().entries[0].source, "Title");
+        assert!(foreign.is_empty());
+    }
+}
@@ -2,7 +2,10 @@
 //!
 //! Extracts and saves translatable strings from Ren'Py games.
 
-use crate::analyzer::{AnalyzerOutput, GameAnalyzer, TextEntry};
+use crate::analyzer::{
+    for_each_parallel, pool_files, AnalysisOptions, AnalysisSink, AnalyzerOutput, CollectingSink,
+    FileEntries, GameAnalyzer, StreamStatus, TextEntry, SCHEMA_VERSION,
+};
 use once_cell::sync::Lazy;
 use regex::Regex;
 use serde_json::json;
@@ -19,11 +22,17 @@ static DIALOG_PATTERN: Lazy<Regex> =
 static MENU_PATTERN: Lazy<Regex> =
     Lazy::new(|| Regex::new(r#"^\s*"([^"]+)"\s*:"#).unwrap());
 
-pub struct RenpyAnalyzer;
+pub struct RenpyAnalyzer {
+    options: AnalysisOptions,
+}
 
 impl RenpyAnalyzer {
     pub fn new() -> Self {
-        Self
+        Self::with_options(AnalysisOptions::default())
+    }
+
+    pub fn with_options(options: AnalysisOptions) -> Self {
+        Self { options }
     }
 
     /// Check if unrpyc is available and return the command to use
@@ -148,8 +157,34 @@ impl Default for RenpyAnalyzer {
 
 impl GameAnalyzer for RenpyAnalyzer {
     fn analyze(&self, input_path: &Path) -> AnalyzerOutput {
+        let mut sink = CollectingSink::default();
+        if let Err(error) = self.analyze_stream(input_path, &mut sink) {
+            return AnalyzerOutput::error(error);
+        }
+
+        if sink.files.is_empty() {
+            return AnalyzerOutput::error("No .rpy files found");
+        }
+
+        let (pool, files) = pool_files(sink.files);
+        let result = json!({
+            "schemaVersion": SCHEMA_VERSION,
+            "engine": "renpy",
+            "source": input_path.to_string_lossy(),
+            "pool": pool,
+            "files": files,
+        });
+
+        AnalyzerOutput::success(serde_json::to_string_pretty(&result).unwrap_or_default())
+    }
+
+    fn analyze_stream(
+        &self,
+        input_path: &Path,
+        sink: &mut dyn AnalysisSink,
+    ) -> Result<StreamStatus, String> {
         if !input_path.exists() {
-            return AnalyzerOutput::error("Path does not exist");
+            return Err("Path does not exist".to_string());
         }
 
         // Check for .rpyc files and decompile if necessary
@@ -163,46 +198,56 @@ impl GameAnalyzer for RenpyAnalyzer {
             });
 
         if has_rpyc {
-            if let Some(unrpyc_cmd) = Self::find_unrpyc() {
-                if let Err(e) = Self::decompile_rpyc(input_path, &unrpyc_cmd) {
-                    return AnalyzerOutput::error(e);
-                }
-            } else {
-                return AnalyzerOutput::error(
-                    "unrpyc not found. Install: pip install unrpyc-ng",
-                );
+            match Self::find_unrpyc() {
+                Some(unrpyc_cmd) => Self::decompile_rpyc(input_path, &unrpyc_cmd)?,
+                None => return Err("unrpyc not found. Install: pip install unrpyc-ng".to_string()),
             }
         }
 
         // Extract from .rpy files
-        let mut all_entries = Vec::new();
-
-        for entry in WalkDir::new(input_path)
+        let rpy_files: Vec<_> = WalkDir::new(input_path)
             .max_depth(1)
             .into_iter()
             .filter_map(|e| e.ok())
-        {
-            if entry.file_type().is_file() {
-                if let Some(ext) = entry.path().extension() {
-                    if ext == "rpy" {
-                        let entries = Self::extract_from_rpy(entry.path());
-                        all_entries.extend(entries);
-                    }
-                }
-            }
+            .filter(|e| {
+                e.file_type().is_file()
+                    && e.path().extension().map(|ext| ext == "rpy").unwrap_or(false)
+            })
+            .map(|e| e.into_path())
+            .collect();
+
+        if rpy_files.is_empty() {
+            return Err("No .rpy files found".to_string());
         }
 
-        if all_entries.is_empty() {
-            return AnalyzerOutput::error("No .rpy files found");
+        if !sink.fonts(&[]) {
+            return Ok(StreamStatus::Cancelled);
         }
 
-        let result = json!({
-            "engine": "renpy",
-            "source": input_path.to_string_lossy(),
-            "strings": all_entries,
-        });
+        let total = rpy_files.len();
+        let mut done = 0;
+        let finished = for_each_parallel(
+            &self.options,
+            &rpy_files,
+            |rpy_path| Self::extract_from_rpy(rpy_path),
+            |_, entries| {
+                done += 1;
+                if let Some(first) = entries.first() {
+                    let path = first.path.clone();
+                    if !sink.file(FileEntries::new(path, entries)) {
+                        return false;
+                    }
+                }
+                sink.progress(done, total)
+            },
+        )?;
 
-        AnalyzerOutput::success(serde_json::to_string_pretty(&result).unwrap_or_default())
+        if !finished {
+            return Ok(StreamStatus::Cancelled);
+        }
+
+        sink.finished(total, 0);
+        Ok(StreamStatus::Finished)
     }
 
     fn save(&self, texts: &[TextEntry]) -> Result<(), String> {
@@ -2,15 +2,23 @@
 //!
 //! Extracts and saves translatable strings from RPG Maker games.
 
-use crate::analyzer::{AnalyzerOutput, GameAnalyzer, TextEntry};
+use crate::analyzer::{
+    for_each_parallel, pool_files, AnalysisOptions, AnalysisSink, AnalyzerOutput, CollectingSink,
+    FileEntries, FileEntry, GameAnalyzer, StreamStatus, TextEntry, SCHEMA_VERSION,
+};
+use crate::cache::{hash_content, mtime_millis, AnalysisCache, CachedFile};
 use once_cell::sync::Lazy;
 use regex::Regex;
 use serde_json::{json, Map, Value};
 use std::collections::{HashMap, HashSet};
 use std::fs;
-use std::path::Path;
+use std::path::{Path, PathBuf};
 use walkdir::WalkDir;
 
+/// Signature of the analysis manifests written by this engine. Bump it whenever the extraction
+/// rules change what ends up in the entries.
+const CACHE_SIGNATURE: &str = "rpgm-rs/1";
+
 /// RPG Maker MV/MZ event command codes
 #[derive(Debug, Clone, Copy, PartialEq, Eq)]
 #[repr(u16)]
@@ -205,11 +213,47 @@ static SYSTEM_PREFIXES: &[&str] = &[
     "CommonEvent", "System", "MapInfo",
 ];
 
-pub struct RpgmAnalyzer;
+/// What reading one data file produced
+enum ParsedFile {
+    Extracted {
+        path: String,
+        /// Only kept when the caller asked for the documents
+        doc: Option<Value>,
+        entries: Vec<TextEntry>,
+        metadata: Option<fs::Metadata>,
+        /// Content hash, only computed while a manifest is in use
+        hash: Option<String>,
+    },
+    /// Unchanged since the manifest was written; the file was not parsed
+    Cached {
+        path: String,
+        file: CachedFile,
+    },
+    Failed,
+}
+
+pub struct RpgmAnalyzer {
+    options: AnalysisOptions,
+    cache_file: Option<PathBuf>,
+}
 
 impl RpgmAnalyzer {
     pub fn new() -> Self {
-        Self
+        Self::with_options(AnalysisOptions::default())
+    }
+
+    pub fn with_options(options: AnalysisOptions) -> Self {
+        Self {
+            options,
+            cache_file: None,
+        }
+    }
+
+    /// Keeps a manifest of the analyzed files at `cache_file` and only parses files that
+    /// changed since the last analysis; `None` turns it off
+    pub fn with_cache_file(mut self, cache_file: Option<PathBuf>) -> Self {
+        self.cache_file = cache_file;
+        self
     }
 
     /// Check if a string is a system/technical string that shouldn't be translated
@@ -640,6 +684,234 @@ impl RpgmAnalyzer {
         }
     }
 
+    /// The `analyze` result built from a collected analysis
+    pub(crate) fn result_output(input_path: &Path, sink: CollectingSink) -> AnalyzerOutput {
+        let (pool, files) = pool_files(sink.files);
+        let result = json!({
+            "schemaVersion": SCHEMA_VERSION,
+            "pool": pool,
+            "files": files,
+            "fonts": sink.fonts,
+            "engine": "rpgm",
+            "source": input_path.to_string_lossy(),
+            "filesProcessed": sink.files_processed,
+            "filesFailed": sink.files_failed,
+        });
+
+        AnalyzerOutput::success(serde_json::to_string_pretty(&result).unwrap_or_default())
+    }
+
+    /// [`GameAnalyzer::analyze_stream`] that can also hand every parsed document to `on_document`
+    /// together with the file's metadata, so a [`crate::project::Project`] can keep it resident.
+    /// Without `on_document`, each document is dropped on the worker that parsed it.
+    pub(crate) fn analyze_documents(
+        &self,
+        input_path: &Path,
+        sink: &mut dyn AnalysisSink,
+        mut on_document: Option<&mut dyn FnMut(String, Value, fs::Metadata)>,
+    ) -> Result<StreamStatus, String> {
+        if !sink.fonts(&Self::find_font_files(input_path)) {
+            return Ok(StreamStatus::Cancelled);
+        }
+
+        // Skip package.json
+        let json_files: Vec<_> = Self::find_json_files(input_path)
+            .into_iter()
+            .filter(|file_path| {
+                file_path
+                    .file_name()
+                    .map(|name| name.to_string_lossy().to_lowercase() != "package.json")
+                    .unwrap_or(true)
+            })
+            .collect();
+
+        let total = json_files.len();
+        let mut processed_count = 0;
+        let mut failed_count = 0;
+        let mut done = 0;
+
+        // Files unchanged since the last run are taken from the manifest; what this run saw
+        // becomes the next manifest
+        let mut cache = self
+            .cache_file
+            .as_deref()
+            .map(|cache_file| AnalysisCache::load(cache_file, CACHE_SIGNATURE));
+        let mut recorded = HashMap::new();
+        let cache_view = cache.as_ref();
+        let keep_documents = on_document.is_some();
+
+        // Files are read and parsed on the pool; the sink sees them one at a time
+        let finished = for_each_parallel(
+            &self.options,
+            &json_files,
+            |file_path| Self::parse_file(file_path, cache_view, keep_documents),
+            |_, parsed| {
+                done += 1;
+                match parsed {
+                    ParsedFile::Extracted {
+                        path,
+                        doc,
+                        entries,
+                        metadata,
+                        hash,
+                    } => {
+                        processed_count += 1;
+                        if let (Some(metadata), Some(hash)) = (&metadata, hash) {
+                            if let Some(mtime) = mtime_millis(metadata) {
+                                let file = CachedFile {
+                                    size: metadata.len(),
+                                    mtime,
+                                    hash,
+                                    entries: entries.iter().cloned().map(FileEntry::from).collect(),
+                                };
+                                recorded.insert(path.clone(), file);
+                            }
+                        }
+                        if !entries.is_empty() {
+                            if let (Some(on_document), Some(doc), Some(metadata)) =
+                                (on_document.as_mut(), doc, metadata)
+                            {
+                                on_document(path.clone(), doc, metadata);
+                            }
+                            if !sink.file(FileEntries::new(path, entries)) {
+                                return false;
+                            }
+                        }
+                    }
+                    ParsedFile::Cached { path, file } => {
+                        processed_count += 1;
+                        let entries = file.entries.clone();
+                        recorded.insert(path.clone(), file);
+                        if !entries.is_empty() && !sink.file(FileEntries { path, entries }) {
+                            return false;
+                        }
+                    }
+                    ParsedFile::Failed => failed_count += 1,
+                }
+                sink.progress(done, total)
+            },
+        )?;
+
+        if !finished {
+            // The manifest is left as it was: files that were not reached must keep their entries
+            return Ok(StreamStatus::Cancelled);
+        }
+
+        if let Some(cache) = cache.as_mut() {
+            cache.replace(recorded);
+            if let Err(error) = cache.save() {
+                eprintln!("Warning: {}", error);
+            }
+        }
+
+        sink.finished(processed_count, failed_count);
+        Ok(StreamStatus::Finished)
+    }
+
+    /// Reads, parses and extracts one data file, or takes its entries from `cache`. The parsed
+    /// document is only returned with `keep_document`.
+    fn parse_file(
+        file_path: &Path,
+        cache: Option<&AnalysisCache>,
+        keep_document: bool,
+    ) -> ParsedFile {
+        // Taken before reading, so a concurrent edit makes the fingerprint stale, not the document
+        let metadata = fs::metadata(file_path).ok();
+        let path = file_path.to_string_lossy().to_string();
+
+        if let (Some(cache), Some(metadata)) = (cache, &metadata) {
+            if let Some(file) = cache.find_current(&path, metadata) {
+                return ParsedFile::Cached {
+                    path,
+                    file: file.clone(),
+                };
+            }
+        }
+
+        let Ok(content) = fs::read_to_string(file_path) else {
+            return ParsedFile::Failed;
+        };
+
+        let hash = cache.map(|_| hash_content(content.as_bytes()));
+        if let (Some(cache), Some(hash), Some(metadata)) = (cache, &hash, &metadata) {
+            // Touched but not edited: same entries as before, under the new fingerprint
+            if let Some(cached) = cache.find(&path).filter(|cached| &cached.hash == hash) {
+                if let Some(mtime) = mtime_millis(metadata) {
+                    return ParsedFile::Cached {
+                        path,
+                        file: CachedFile {
+                            size: metadata.len(),
+                            mtime,
+                            hash: hash.clone(),
+                            entries: cached.entries.clone(),
+                        },
+                    };
+                }
+            }
+        }
+
+        let Ok(doc) = serde_json::from_str::<Value>(&content) else {
+            return ParsedFile::Failed;
+        };
+
+        let mut entries = Vec::new();
+        Self::extract_strings(&doc, &mut entries, &path, "");
+        ParsedFile::Extracted {
+            path,
+            doc: keep_document.then_some(doc),
+            entries,
+            metadata,
+            hash,
+        }
+    }
+
+    /// Translated entries grouped by file path, as (key path, text) pairs
+    pub(crate) fn group_updates(texts: &[TextEntry]) -> HashMap<String, Vec<(&str, &str)>> {
+        let mut updates_by_file: HashMap<String, Vec<(&str, &str)>> = HashMap::new();
+
+        for entry in texts {
+            if let Some(text) = &entry.text {
+                updates_by_file
+                    .entry(entry.path.clone())
+                    .or_default()
+                    .push((&entry.key, text));
+            }
+        }
+
+        updates_by_file
+    }
+
+    /// Apply all updates of one file to its parsed document
+    pub(crate) fn apply_updates(doc: &mut Value, file_path: &str, updates: &[(&str, &str)]) {
+        for (key_path, new_value) in updates {
+            if !Self::update_json_value(doc, key_path, new_value) {
+                eprintln!(
+                    "Warning: Failed to update value at {} in {}",
+                    key_path, file_path
+                );
+            }
+        }
+    }
+
+    /// Write a document back over `file_path`, keeping a backup until the write succeeded
+    pub(crate) fn write_document(file_path: &str, doc: &Value) -> Result<(), String> {
+        // Create backup
+        let backup_path = format!("{}.backup", file_path);
+        let _ = fs::remove_file(&backup_path);
+        fs::copy(file_path, &backup_path)
+            .map_err(|e| format!("Failed to create backup: {}", e))?;
+
+        // Write updated content
+        let output = serde_json::to_string_pretty(doc)
+            .map_err(|e| format!("Failed to serialize: {}", e))?;
+
+        fs::write(file_path, output).map_err(|e| format!("Failed to write {}: {}", file_path, e))?;
+
+        // Remove backup on success
+        let _ = fs::remove_file(&backup_path);
+        Ok(())
+    }
+
     /// Find JSON files in the project directory
     fn find_json_files(project_path: &Path) -> Vec<std::path::PathBuf> {
         let mut files = Vec::new();
@@ -761,69 +1033,24 @@ impl Default for RpgmAnalyzer {
 
 impl GameAnalyzer for RpgmAnalyzer {
     fn analyze(&self, input_path: &Path) -> AnalyzerOutput {
-        let json_files = Self::find_json_files(input_path);
-        let mut entries = Vec::new();
-        let mut processed_count = 0;
-        let mut failed_count = 0;
-
-        for file_path in &json_files {
-            // Skip package.json
-            if let Some(name) = file_path.file_name() {
-                if name.to_string_lossy().to_lowercase() == "package.json" {
-                    continue;
-                }
-            }
-
-            match fs::read_to_string(file_path) {
-                Ok(content) => match serde_json::from_str::<Value>(&content) {
-                    Ok(doc) => {
-                        Self::extract_strings(
-                            &doc,
-                            &mut entries,
-                            &file_path.to_string_lossy(),
-                            "",
-                        );
-                        processed_count += 1;
-                    }
-                    Err(_) => {
-                        failed_count += 1;
-                    }
-                },
-                Err(_) => {
-                    failed_count += 1;
-                }
-            }
+        let mut sink = CollectingSink::default();
+        if let Err(error) = self.analyze_stream(input_path, &mut sink) {
+            return AnalyzerOutput::error(error);
         }
+        Self::result_output(input_path, sink)
+    }
 
-        let fonts = Self::find_font_files(input_path);
-
-        let result = json!({
-            "strings": entries,
-            "fonts": fonts,
-            "engine": "rpgm",
-            "source": input_path.to_string_lossy(),
-            "filesProcessed": processed_count,
-            "filesFailed": failed_count,
-        });
-
-        AnalyzerOutput::success(serde_json::to_string_pretty(&result).unwrap_or_default())
+    fn analyze_stream(
+        &self,
+        input_path: &Path,
+        sink: &mut dyn AnalysisSink,
+    ) -> Result<StreamStatus, String> {
+        self.analyze_documents(input_path, sink, None)
     }
 
     fn save(&self, texts: &[TextEntry]) -> Result<(), String> {
-        // Group updates by file path
-        let mut updates_by_file: HashMap<String, Vec<(&str, &str)>> = HashMap::new();
-
-        for entry in texts {
-            if let Some(text) = &entry.text {
-                updates_by_file
-                    .entry(entry.path.clone())
-                    .or_default()
-                    .push((&entry.key, text));
-            }
-        }
-
         // Process each file
-        for (file_path, updates) in updates_by_file {
+        for (file_path, updates) in Self::group_updates(texts) {
             // Read the file
             let content = fs::read_to_string(&file_path)
                 .map_err(|e| format!("Failed to read {}: {}", file_path, e))?;
@@ -831,30 +1058,8 @@ impl GameAnalyzer for RpgmAnalyzer {
             let mut doc: Value = serde_json::from_str(&content)
                 .map_err(|e| format!("Failed to parse {}: {}", file_path, e))?;
 
-            // Apply all updates
-            for (key_path, new_value) in &updates {
-                if !Self::update_json_value(&mut doc, key_path, new_value) {
-                    eprintln!(
-                        "Warning: Failed to update value at {} in {}",
-                        key_path, file_path
-                    );
-                }
-            }
-
-            // Create backup
-            let backup_path = format!("{}.backup", file_path);
-            let _ = fs::remove_file(&backup_path);
-            fs::copy(&file_path, &backup_path)
-                .map_err(|e| format!("Failed to create backup: {}", e))?;
-
-            // Write updated content
-            let output = serde_json::to_string_pretty(&doc)
-                .map_err(|e| format!("Failed to serialize: {}", e))?;
-
-            fs::write(&file_path, output).map_err(|e| format!("Failed to write {}: {}", file_path, e))?;
-
-            // Remove backup on success
-            let _ = fs::remove_file(&backup_path);
+            Self::apply_updates(&mut doc, &file_path, &updates);
+            Self::write_document(&file_path, &doc)?;
         }
 
         Ok(())
@@ -908,6 +1113,33 @@ mod tests {
         assert!(!RpgmAnalyzer::is_system_string("こんにちは"));
     }
 
+    #[test]
+    fn test_analyze_stream_matches_analyze() {
+        let project = std::env::temp_dir().join(format!("bga_rs_stream_{}", std::process::id()));
+        let data = project.join("data");
+        fs::create_dir_all(&data).unwrap();
+        fs::write(
+            data.join("CommonEvents.json"),
+            r#"[null,{"id":1,"list":[{"code":401,"indent":0,"parameters":["Hello"]}],"name":"Greeting"}]"#,
+        )
+        .unwrap();
+        fs::write(data.join("Broken.json"), "{").unwrap();
+
+        let analyzer = RpgmAnalyzer::new();
+        let mut sink = CollectingSink::default();
+        let status = analyzer.analyze_stream(&project, &mut sink).unwrap();
+        let result: Value = serde_json::from_str(&analyzer.analyze(&project).payload).unwrap();
+        fs::remove_dir_all(&project).unwrap();
+
+        assert_eq!(status, StreamStatus::Finished);
+        assert_eq!(sink.files_processed, 1);
+        assert_eq!(sink.files_failed, 1);
+        let streamed = serde_json::to_value(&sink.files).unwrap();
+        let replayed = serde_json::to_value(crate::analyzer::files_from_result(&result)).unwrap();
+        assert_eq!(streamed, replayed);
+        assert_eq!(streamed[0]["entries"][0]["source"], "Hello");
+    }
+
     #[test]
     fn test_update_json_value() {
         let mut doc = json!({
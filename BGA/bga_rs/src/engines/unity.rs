@@ -2,30 +2,29 @@
 //!
 //! Basic file listing for Unity projects (asset/prefab scanning).
 
-use crate::analyzer::{AnalyzerOutput, GameAnalyzer, TextEntry};
-use serde_json::json;
-use std::path::Path;
+use crate::analyzer::{for_each_parallel, AnalysisOptions, AnalyzerOutput, GameAnalyzer, TextEntry};
+use serde_json::{json, Value};
+use std::path::{Path, PathBuf};
 use walkdir::WalkDir;
 
-pub struct UnityAnalyzer;
+pub struct UnityAnalyzer {
+    options: AnalysisOptions,
+}
 
 impl UnityAnalyzer {
     pub fn new() -> Self {
-        Self
+        Self::with_options(AnalysisOptions::default())
     }
-}
 
-impl Default for UnityAnalyzer {
-    fn default() -> Self {
-        Self::new()
+    pub fn with_options(options: AnalysisOptions) -> Self {
+        Self { options }
     }
-}
 
-impl GameAnalyzer for UnityAnalyzer {
-    fn analyze(&self, input_path: &Path) -> AnalyzerOutput {
+    /// Asset and prefab records of `root` and everything below it, in walk order
+    fn scan(root: &Path) -> Vec<Value> {
         let mut entries = Vec::new();
 
-        for entry in WalkDir::new(input_path)
+        for entry in WalkDir::new(root)
             .into_iter()
             .filter_map(|e| e.ok())
         {
@@ -42,6 +41,41 @@ impl GameAnalyzer for UnityAnalyzer {
             }
         }
 
+        entries
+    }
+}
+
+impl Default for UnityAnalyzer {
+    fn default() -> Self {
+        Self::new()
+    }
+}
+
+impl GameAnalyzer for UnityAnalyzer {
+    fn analyze(&self, input_path: &Path) -> AnalyzerOutput {
+        // Each top-level entry is walked on its own; concatenated in order, the records are the
+        // same as those of a single walk over `input_path`
+        let roots: Vec<PathBuf> = if input_path.is_dir() {
+            WalkDir::new(input_path)
+                .min_depth(1)
+                .max_depth(1)
+                .into_iter()
+                .filter_map(|e| e.ok())
+                .map(|e| e.into_path())
+                .collect()
+        } else {
+            vec![input_path.to_path_buf()]
+        };
+
+        let mut entries = Vec::new();
+        let scanned = for_each_parallel(&self.options, &roots, |root| Self::scan(root), |_, found| {
+            entries.extend(found);
+            true
+        });
+        if let Err(error) = scanned {
+            return AnalyzerOutput::error(error);
+        }
+
         let result = json!({
             "engine": "unity",
             "source": input_path.to_string_lossy(),
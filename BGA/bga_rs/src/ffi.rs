@@ -2,11 +2,90 @@
 //!
 //! These functions allow C/C++ code to call into the Rust library.
 
-use crate::analyzer::TextEntry;
+use crate::analyzer::{
+    AnalysisOptions, AnalysisSink, AnalyzerOutput, FileEntries, StreamStatus, TextEntry,
+};
 use crate::engines::{renpy::RenpyAnalyzer, rpgm::RpgmAnalyzer, unity::UnityAnalyzer};
+use crate::project::Project;
 use crate::GameAnalyzer;
-use std::ffi::{c_char, CStr, CString};
-use std::path::Path;
+use serde_json::{json, Value};
+use std::ffi::{c_char, c_void, CStr, CString};
+use std::path::{Path, PathBuf};
+
+/// Chunk kinds passed to a [`ChunkCallback`]. Every chunk is one UTF-8 JSON object.
+///
+/// `{"fonts": [...]}`, sent once before the first file
+pub const BGA_CHUNK_HEADER: i32 = 0;
+/// `{"path": ..., "entries": [{"source": ..., "key": ...}, ...]}`, one per file with entries
+pub const BGA_CHUNK_FILE: i32 = 1;
+/// `{"filesProcessed": n, "filesFailed": m}`, sent once after the last file
+pub const BGA_CHUNK_SUMMARY: i32 = 2;
+/// `{"error": ...}`, sent when the analysis fails
+pub const BGA_CHUNK_ERROR: i32 = 3;
+
+/// Receives one chunk. `data` is only valid during the call. A non-zero return cancels the analysis.
+pub type ChunkCallback =
+    unsafe extern "C" fn(user_data: *mut c_void, kind: i32, data: *const u8, len: usize) -> i32;
+
+/// Reports that `done` of `total` files were read. A non-zero return cancels the analysis.
+pub type ProgressCallback =
+    unsafe extern "C" fn(user_data: *mut c_void, done: usize, total: usize) -> i32;
+
+fn analyzer_for(engine: &str, options: AnalysisOptions) -> Option<Box<dyn GameAnalyzer>> {
+    match engine.to_lowercase().as_str() {
+        "rpgm" => Some(Box::new(RpgmAnalyzer::with_options(options))),
+        "unity" => Some(Box::new(UnityAnalyzer::with_options(options))),
+        "renpy" => Some(Box::new(RenpyAnalyzer::with_options(options))),
+        _ => None,
+    }
+}
+
+/// Forwards a streamed analysis to the C callbacks
+struct CallbackSink {
+    on_chunk: ChunkCallback,
+    on_progress: Option<ProgressCallback>,
+    user_data: *mut c_void,
+}
+
+impl CallbackSink {
+    fn send(&self, kind: i32, chunk: &[u8]) -> bool {
+        unsafe { (self.on_chunk)(self.user_data, kind, chunk.as_ptr(), chunk.len()) == 0 }
+    }
+
+    fn send_json(&self, kind: i32, chunk: &Value) -> bool {
+        match serde_json::to_vec(chunk) {
+            Ok(bytes) => self.send(kind, &bytes),
+            Err(_) => true,
+        }
+    }
+}
+
+impl AnalysisSink for CallbackSink {
+    fn fonts(&mut self, fonts: &[Value]) -> bool {
+        self.send_json(BGA_CHUNK_HEADER, &json!({ "fonts": fonts }))
+    }
+
+    fn file(&mut self, file: FileEntries) -> bool {
+        match serde_json::to_vec(&file) {
+            Ok(bytes) => self.send(BGA_CHUNK_FILE, &bytes),
+            Err(_) => true,
+        }
+    }
+
+    fn progress(&mut self, done: usize, total: usize) -> bool {
+        match self.on_progress {
+            Some(on_progress) => unsafe { on_progress(self.user_data, done, total) == 0 },
+            None => true,
+        }
+    }
+
+    fn finished(&mut self, files_processed: usize, files_failed: usize) {
+        self.send_json(
+            BGA_CHUNK_SUMMARY,
+            &json!({ "filesProcessed": files_processed, "filesFailed": files_failed }),
+        );
+    }
+}
 
 /// Analyze a game project
 ///
@@ -56,6 +135,408 @@ pub unsafe extern "C" fn bga_analyze(engine: *const c_char, path: *const c_char)
     }
 }
 
+/// Bytes handed to C without copying. Release with [`bga_buffer_free`].
+#[repr(C)]
+pub struct BgaBuffer {
+    pub ptr: *const u8,
+    pub len: usize,
+}
+
+impl BgaBuffer {
+    fn null() -> Self {
+        Self {
+            ptr: std::ptr::null(),
+            len: 0,
+        }
+    }
+
+    fn from_string(text: String) -> Self {
+        // A boxed slice has no spare capacity, so (ptr, len) is all that is needed to free it
+        let bytes = text.into_bytes().into_boxed_slice();
+        let len = bytes.len();
+        Self {
+            ptr: Box::into_raw(bytes) as *const u8,
+            len,
+        }
+    }
+}
+
+/// Hands `output` to C: the payload, or a null buffer with the error message written to `error`
+///
+/// # Safety
+/// `error` must be null or valid for writes.
+unsafe fn output_buffer(output: AnalyzerOutput, error: *mut BgaBuffer) -> BgaBuffer {
+    match output.error_message {
+        Some(message) => {
+            unsafe { set_error(error, message) };
+            BgaBuffer::null()
+        }
+        None => {
+            unsafe { set_error_none(error) };
+            BgaBuffer::from_string(output.payload)
+        }
+    }
+}
+
+/// Writes `message` to `error` unless it is null
+///
+/// # Safety
+/// `error` must be null or valid for writes.
+unsafe fn set_error(error: *mut BgaBuffer, message: impl Into<String>) {
+    if let Some(error) = unsafe { error.as_mut() } {
+        *error = BgaBuffer::from_string(message.into());
+    }
+}
+
+/// Clears `error` unless it is null
+///
+/// # Safety
+/// `error` must be null or valid for writes.
+unsafe fn set_error_none(error: *mut BgaBuffer) {
+    if let Some(error) = unsafe { error.as_mut() } {
+        *error = BgaBuffer::null();
+    }
+}
+
+/// Analyze a game project and return the payload without copying it
+///
+/// Unlike [`bga_analyze`], the JSON is not null-terminated and is handed over as it is, so the
+/// caller needs neither a `strlen` nor a copy.
+///
+/// # Arguments
+/// * `engine` - Engine name ("rpgm", "unity", "renpy")
+/// * `path` - Path to the game project
+/// * `error` - Optional (may be null); receives the UTF-8 error message when the analysis fails,
+///   a null buffer otherwise. The caller frees it with `bga_buffer_free`.
+///
+/// # Returns
+/// The payload (caller must free with `bga_buffer_free`), or a null buffer on error
+///
+/// # Safety
+/// Both `engine` and `path` must be valid null-terminated C strings, `error` null or valid for
+/// writes.
+#[no_mangle]
+pub unsafe extern "C" fn bga_analyze_buffer(
+    engine: *const c_char,
+    path: *const c_char,
+    error: *mut BgaBuffer,
+) -> BgaBuffer {
+    unsafe { bga_analyze_with_options(engine, path, std::ptr::null(), error) }
+}
+
+/// Analyze a game project with explicit threading options; same payload as `bga_analyze_buffer`
+///
+/// # Arguments
+/// * `engine` - Engine name ("rpgm", "unity", "renpy")
+/// * `path` - Path to the game project
+/// * `options_json` - JSON object, all members optional (null or "" for the defaults):
+///   `threads` - worker threads, 0 for one per core (default), 1 for a serial run;
+///   `deterministic` - keep the serial file order, so the payload is byte-identical to a serial
+///   run (default true)
+/// * `error` - Optional, as in `bga_analyze_buffer`
+///
+/// # Returns
+/// The payload (caller must free with `bga_buffer_free`), or a null buffer on error
+///
+/// # Safety
+/// `engine` and `path` must be valid null-terminated C strings, `options_json` null or one,
+/// `error` null or valid for writes.
+#[no_mangle]
+pub unsafe extern "C" fn bga_analyze_with_options(
+    engine: *const c_char,
+    path: *const c_char,
+    options_json: *const c_char,
+    error: *mut BgaBuffer,
+) -> BgaBuffer {
+    let output = match unsafe { analyze_from_c(engine, path, options_json) } {
+        Ok(output) => output,
+        Err(message) => AnalyzerOutput::error(message),
+    };
+    unsafe { output_buffer(output, error) }
+}
+
+/// Runs the analysis of `bga_analyze_with_options`; `Err` for arguments it cannot use
+unsafe fn analyze_from_c(
+    engine: *const c_char,
+    path: *const c_char,
+    options_json: *const c_char,
+) -> Result<AnalyzerOutput, String> {
+    let engine_str = unsafe { CStr::from_ptr(engine) }
+        .to_str()
+        .map_err(|_| "Engine name is not valid UTF-8".to_string())?;
+    let path_str = unsafe { CStr::from_ptr(path) }
+        .to_str()
+        .map_err(|_| "Project path is not valid UTF-8".to_string())?;
+    let options = unsafe { options_from_c(options_json) }
+        .ok_or_else(|| "Analysis options cannot be parsed".to_string())?;
+
+    let analyzer = analyzer_for(engine_str, options)
+        .ok_or_else(|| format!("Unknown engine: {}", engine_str))?;
+    Ok(analyzer.analyze(Path::new(path_str)))
+}
+
+/// Options of `options_json`, defaults for null; `None` if they cannot be parsed
+unsafe fn options_from_c(options_json: *const c_char) -> Option<AnalysisOptions> {
+    if options_json.is_null() {
+        return Some(AnalysisOptions::default());
+    }
+    let options_str = unsafe { CStr::from_ptr(options_json) }.to_str().ok()?;
+    AnalysisOptions::from_json(options_str).ok()
+}
+
+/// Free a buffer returned by `bga_analyze_buffer` and the other buffer functions, payload or error
+///
+/// # Safety
+/// `buffer` must be null or come from one of them, and must not be freed twice.
+#[no_mangle]
+pub unsafe extern "C" fn bga_buffer_free(buffer: BgaBuffer) {
+    if !buffer.ptr.is_null() {
+        let slice = std::ptr::slice_from_raw_parts_mut(buffer.ptr as *mut u8, buffer.len);
+        drop(unsafe { Box::from_raw(slice) });
+    }
+}
+
+/// Analyze a game project, delivering each file's entries as soon as they are extracted
+///
+/// Nothing is accumulated on the Rust side: every chunk is serialized, handed to `on_chunk` and
+/// dropped. Callbacks run on the calling thread, in file order.
+///
+/// # Arguments
+/// * `engine` - Engine name ("rpgm", "unity", "renpy")
+/// * `path` - Path to the game project
+/// * `on_chunk` - Receives the chunks (see `BGA_CHUNK_*`)
+/// * `user_data` - Passed back to both callbacks
+/// * `on_progress` - Optional progress callback (may be null)
+///
+/// # Returns
+/// 0 when finished, 1 when a callback cancelled, negative on error (-5 after an error chunk)
+///
+/// # Safety
+/// Both `engine` and `path` must be valid null-terminated C strings, and the callbacks must be
+/// safe to call with `user_data`.
+#[no_mangle]
+pub unsafe extern "C" fn bga_analyze_stream(
+    engine: *const c_char,
+    path: *const c_char,
+    on_chunk: Option<ChunkCallback>,
+    user_data: *mut c_void,
+    on_progress: Option<ProgressCallback>,
+) -> i32 {
+    let engine_str = match unsafe { CStr::from_ptr(engine) }.to_str() {
+        Ok(s) => s,
+        Err(_) => return -1,
+    };
+
+    let path_str = match unsafe { CStr::from_ptr(path) }.to_str() {
+        Ok(s) => s,
+        Err(_) => return -2,
+    };
+
+    let Some(on_chunk) = on_chunk else {
+        return -3;
+    };
+
+    let Some(analyzer) = analyzer_for(engine_str, AnalysisOptions::default()) else {
+        return -4;
+    };
+
+    let mut sink = CallbackSink {
+        on_chunk,
+        on_progress,
+        user_data,
+    };
+
+    match analyzer.analyze_stream(Path::new(path_str), &mut sink) {
+        Ok(StreamStatus::Finished) => 0,
+        Ok(StreamStatus::Cancelled) => 1,
+        Err(error) => {
+            sink.send_json(BGA_CHUNK_ERROR, &json!({ "error": error }));
+            -5
+        }
+    }
+}
+
+/// Open a game project whose parsed documents stay resident between analysis and save
+///
+/// # Arguments
+/// * `engine` - Engine name ("rpgm", "unity", "renpy")
+/// * `path` - Path to the game project
+/// * `memory_cap` - Upper bound on the estimated memory of resident documents, which is several
+///   times their source size; 0 keeps none. The least recently used documents are dropped first.
+///
+/// # Returns
+/// An opaque handle (caller must close it with `bga_close_project`), or null on error
+///
+/// # Safety
+/// Both `engine` and `path` must be valid null-terminated C strings.
+#[no_mangle]
+pub unsafe extern "C" fn bga_open_project(
+    engine: *const c_char,
+    path: *const c_char,
+    memory_cap: u64,
+) -> *mut Project {
+    let engine_str = match unsafe { CStr::from_ptr(engine) }.to_str() {
+        Ok(s) => s,
+        Err(_) => return std::ptr::null_mut(),
+    };
+
+    let path_str = match unsafe { CStr::from_ptr(path) }.to_str() {
+        Ok(s) => s,
+        Err(_) => return std::ptr::null_mut(),
+    };
+
+    match Project::open(engine_str, Path::new(path_str), memory_cap) {
+        Some(project) => Box::into_raw(Box::new(project)),
+        None => std::ptr::null_mut(),
+    }
+}
+
+/// Set the threading options of an opened project's next analyses (see `bga_analyze_with_options`)
+///
+/// # Returns
+/// 0 on success, -1 for a null handle, -2 if `options_json` cannot be parsed
+///
+/// # Safety
+/// `project` must be a live handle from `bga_open_project`, not used concurrently, and
+/// `options_json` null or a valid null-terminated C string.
+#[no_mangle]
+pub unsafe extern "C" fn bga_project_set_options(project: *mut Project, options_json: *const c_char) -> i32 {
+    let Some(project) = (unsafe { project.as_mut() }) else {
+        return -1;
+    };
+
+    match unsafe { options_from_c(options_json) } {
+        Some(options) => {
+            project.set_options(options);
+            0
+        }
+        None => -2,
+    }
+}
+
+/// Set the analysis manifest of an opened project's next analyses. Files unchanged since the
+/// manifest was written are not parsed again. A null or empty `cache_file` turns it off.
+///
+/// # Returns
+/// 0 on success, -1 for a null handle, -2 if `cache_file` is not valid UTF-8
+///
+/// # Safety
+/// `project` must be a live handle from `bga_open_project`, not used concurrently, and
+/// `cache_file` null or a valid null-terminated C string.
+#[no_mangle]
+pub unsafe extern "C" fn bga_project_set_cache_file(project: *mut Project, cache_file: *const c_char) -> i32 {
+    let Some(project) = (unsafe { project.as_mut() }) else {
+        return -1;
+    };
+
+    if cache_file.is_null() {
+        project.set_cache_file(None);
+        return 0;
+    }
+    match unsafe { CStr::from_ptr(cache_file) }.to_str() {
+        Ok(path) => {
+            project.set_cache_file((!path.is_empty()).then(|| PathBuf::from(path)));
+            0
+        }
+        Err(_) => -2,
+    }
+}
+
+/// Analyze an opened project; same payload and `error` as `bga_analyze_buffer`
+///
+/// # Safety
+/// `project` must be a live handle from `bga_open_project`, not used concurrently, and `error`
+/// null or valid for writes.
+#[no_mangle]
+pub unsafe extern "C" fn bga_project_analyze(
+    project: *mut Project,
+    error: *mut BgaBuffer,
+) -> BgaBuffer {
+    let output = match unsafe { project.as_mut() } {
+        Some(project) => project.analyze(),
+        None => AnalyzerOutput::error("No project"),
+    };
+    unsafe { output_buffer(output, error) }
+}
+
+/// Streaming analysis of an opened project; same chunks and results as `bga_analyze_stream`
+///
+/// # Safety
+/// `project` must be a live handle from `bga_open_project`, not used concurrently, and the
+/// callbacks must be safe to call with `user_data`.
+#[no_mangle]
+pub unsafe extern "C" fn bga_project_analyze_stream(
+    project: *mut Project,
+    on_chunk: Option<ChunkCallback>,
+    user_data: *mut c_void,
+    on_progress: Option<ProgressCallback>,
+) -> i32 {
+    let Some(project) = (unsafe { project.as_mut() }) else {
+        return -1;
+    };
+
+    let Some(on_chunk) = on_chunk else {
+        return -3;
+    };
+
+    let mut sink = CallbackSink {
+        on_chunk,
+        on_progress,
+        user_data,
+    };
+
+    match project.analyze_stream(&mut sink) {
+        Ok(StreamStatus::Finished) => 0,
+        Ok(StreamStatus::Cancelled) => 1,
+        Err(error) => {
+            sink.send_json(BGA_CHUNK_ERROR, &json!({ "error": error }));
+            -5
+        }
+    }
+}
+
+/// Save translated texts through an opened project: resident documents are patched in memory
+/// and written, only files that changed on disk since are read again
+///
+/// # Returns
+/// 0 on success, non-zero on error (same codes as `bga_save`)
+///
+/// # Safety
+/// `project` must be a live handle from `bga_open_project`, not used concurrently, and
+/// `texts_json` a valid null-terminated C string.
+#[no_mangle]
+pub unsafe extern "C" fn bga_project_save(project: *mut Project, texts_json: *const c_char) -> i32 {
+    let Some(project) = (unsafe { project.as_mut() }) else {
+        return -1;
+    };
+
+    let json_str = match unsafe { CStr::from_ptr(texts_json) }.to_str() {
+        Ok(s) => s,
+        Err(_) => return -2,
+    };
+
+    let texts: Vec<TextEntry> = match serde_json::from_str(json_str) {
+        Ok(t) => t,
+        Err(_) => return -3,
+    };
+
+    match project.save(&texts) {
+        Ok(()) => 0,
+        Err(_) => -5,
+    }
+}
+
+/// Close a project handle and drop its resident documents
+///
+/// # Safety
+/// `project` must be null or a handle from `bga_open_project` that is not used afterwards.
+#[no_mangle]
+pub unsafe extern "C" fn bga_close_project(project: *mut Project) {
+    if !project.is_null() {
+        drop(unsafe { Box::from_raw(project) });
+    }
+}
+
 /// Save translated texts back to game files
 ///
 /// # Arguments
@@ -138,3 +619,72 @@ pub extern "C" fn bga_version() -> *const c_char {
     static VERSION: &[u8] = b"0.1.0\0";
     VERSION.as_ptr() as *const c_char
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    /// Reads `buffer` as a string, frees it and leaves a null buffer behind
+    unsafe fn take_string(buffer: &mut BgaBuffer) -> String {
+        let buffer = std::mem::replace(buffer, BgaBuffer::null());
+        let bytes = unsafe { std::slice::from_raw_parts(buffer.ptr, buffer.len) };
+        let text = String::from_utf8_lossy(bytes).into_owned();
+        unsafe { bga_buffer_free(buffer) };
+        text
+    }
+
+    #[test]
+    fn test_analyze_buffer_round_trip() {
+        let engine = CString::new("rpgm").unwrap();
+        let path = CString::new("/nonexistent/bga_rs_project").unwrap();
+
+        let mut error = BgaBuffer::null();
+        let buffer = unsafe { bga_analyze_buffer(engine.as_ptr(), path.as_ptr(), &mut error) };
+        assert!(!buffer.ptr.is_null());
+        assert!(error.ptr.is_null());
+        let payload = unsafe { std::slice::from_raw_parts(buffer.ptr, buffer.len) };
+        let result: Value = serde_json::from_slice(payload).unwrap();
+        assert_eq!(result["engine"], "rpgm");
+        unsafe { bga_buffer_free(buffer) };
+
+        let options = CString::new(r#"{"threads": 1}"#).unwrap();
+        let buffer = unsafe {
+            bga_analyze_with_options(
+                engine.as_ptr(),
+                path.as_ptr(),
+                options.as_ptr(),
+                std::ptr::null_mut(),
+            )
+        };
+        assert!(!buffer.ptr.is_null());
+        unsafe { bga_buffer_free(buffer) };
+    }
+
+    #[test]
+    fn test_analyze_buffer_reports_errors() {
+        let path = CString::new("/nonexistent/bga_rs_project").unwrap();
+        let mut error = BgaBuffer::null();
+
+        let unknown = CString::new("nope").unwrap();
+        let buffer = unsafe { bga_analyze_buffer(unknown.as_ptr(), path.as_ptr(), &mut error) };
+        assert!(buffer.ptr.is_null());
+        assert_eq!(unsafe { take_string(&mut error) }, "Unknown engine: nope");
+
+        // The analyzer's own error comes through, not just an empty payload
+        let renpy = CString::new("renpy").unwrap();
+        let buffer = unsafe { bga_analyze_buffer(renpy.as_ptr(), path.as_ptr(), &mut error) };
+        assert!(buffer.ptr.is_null());
+        assert_eq!(unsafe { take_string(&mut error) }, "Path does not exist");
+
+        let options = CString::new("{").unwrap();
+        let buffer = unsafe {
+            bga_analyze_with_options(renpy.as_ptr(), path.as_ptr(), options.as_ptr(), &mut error)
+        };
+        assert!(buffer.ptr.is_null());
+        assert!(!unsafe { take_string(&mut error) }.is_empty());
+
+        let buffer = unsafe { bga_project_analyze(std::ptr::null_mut(), &mut error) };
+        assert!(buffer.ptr.is_null());
+        assert!(!unsafe { take_string(&mut error) }.is_empty());
+    }
+}
@@ -3,11 +3,17 @@
 //! This library provides game string extraction and injection for various game engines.
 
 pub mod analyzer;
+pub mod cache;
 pub mod engines;
 mod ffi;
+pub mod project;
 
-pub use analyzer::{AnalyzerOutput, GameAnalyzer, TextEntry};
+pub use analyzer::{
+    files_from_result, for_each_parallel, pool_files, AnalysisOptions, AnalysisSink, AnalyzerOutput, CollectingSink, FileEntries, FileEntry, GameAnalyzer,
+    PooledEntry, PooledFileEntries, StreamStatus, StringPool, TextEntry, SCHEMA_VERSION,
+};
 pub use engines::{renpy::RenpyAnalyzer, rpgm::RpgmAnalyzer, unity::UnityAnalyzer};
+pub use project::{Project, ProjectStats};
 
 // Re-export FFI functions
 pub use ffi::*;
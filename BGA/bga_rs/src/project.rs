@@ -0,0 +1,339 @@
+//! Persistent project handles
+//!
+//! A [`Project`] keeps what an analysis parsed so a later save does not read and parse the
+//! game files again. RPG Maker documents stay resident, keyed by file path and validated
+//! against the file's size and modification time; other engines simply delegate to their
+//! analyzer.
+
+use crate::analyzer::{
+    AnalysisOptions, AnalysisSink, AnalyzerOutput, CollectingSink, StreamStatus, TextEntry,
+};
+use crate::engines::{renpy::RenpyAnalyzer, rpgm::RpgmAnalyzer, unity::UnityAnalyzer};
+use crate::GameAnalyzer;
+use serde_json::Value;
+use std::collections::{BTreeMap, HashMap};
+use std::fs;
+use std::mem::size_of;
+use std::path::{Path, PathBuf};
+use std::time::SystemTime;
+
+/// A parsed document and the fingerprint of the file it was parsed from
+struct ResidentDocument {
+    doc: Value,
+    len: u64,
+    modified: Option<SystemTime>,
+    /// Estimated memory of `doc`, see [`resident_size`]
+    cost: u64,
+    last_used: u64,
+}
+
+impl ResidentDocument {
+    fn matches(&self, metadata: &fs::Metadata) -> bool {
+        self.len == metadata.len() && self.modified == metadata.modified().ok()
+    }
+}
+
+/// Counters of a project's document cache
+#[derive(Debug, Default, Clone, Copy, PartialEq, Eq)]
+pub struct ProjectStats {
+    /// Documents currently resident
+    pub resident_documents: usize,
+    /// Estimated memory of the resident documents
+    pub resident_bytes: u64,
+    /// Saves that found their document resident
+    pub hits: u64,
+    /// Saves that had to read and parse the file
+    pub misses: u64,
+    /// Documents dropped to stay under the memory cap
+    pub evictions: u64,
+}
+
+/// An opened game project
+pub struct Project {
+    engine: String,
+    root: PathBuf,
+    /// Upper bound on the estimated memory of resident documents; 0 keeps none
+    memory_cap: u64,
+    options: AnalysisOptions,
+    /// Analysis manifest for incremental re-analysis, if any
+    cache_file: Option<PathBuf>,
+    documents: HashMap<String, ResidentDocument>,
+    /// Paths of `documents` by `last_used`, least recently used first
+    lru: BTreeMap<u64, String>,
+    clock: u64,
+    stats: ProjectStats,
+}
+
+impl Project {
+    /// Opens `root` for `engine`. Returns `None` for an unknown engine.
+    pub fn open(engine: &str, root: &Path, memory_cap: u64) -> Option<Self> {
+        let engine = engine.to_lowercase();
+        if !matches!(engine.as_str(), "rpgm" | "unity" | "renpy") {
+            return None;
+        }
+        Some(Self {
+            engine,
+            root: root.to_path_buf(),
+            memory_cap,
+            options: AnalysisOptions::default(),
+            cache_file: None,
+            documents: HashMap::new(),
+            lru: BTreeMap::new(),
+            clock: 0,
+            stats: ProjectStats::default(),
+        })
+    }
+
+    pub fn root(&self) -> &Path {
+        &self.root
+    }
+
+    /// Threading of the next analyses
+    pub fn set_options(&mut self, options: AnalysisOptions) {
+        self.options = options;
+    }
+
+    /// Manifest of the next analyses; `None` analyzes every file from scratch. Only the RPG
+    /// Maker engine keeps one.
+    pub fn set_cache_file(&mut self, cache_file: Option<PathBuf>) {
+        self.cache_file = cache_file;
+    }
+
+    pub fn stats(&self) -> ProjectStats {
+        ProjectStats {
+            resident_documents: self.documents.len(),
+            ..self.stats
+        }
+    }
+
+    fn analyzer(&self) -> Box<dyn GameAnalyzer> {
+        match self.engine.as_str() {
+            "rpgm" => Box::new(RpgmAnalyzer::with_options(self.options)),
+            "renpy" => Box::new(RenpyAnalyzer::with_options(self.options)),
+            _ => Box::new(UnityAnalyzer::with_options(self.options)),
+        }
+    }
+
+    /// Same output as the engine's `analyze`, keeping the parsed documents resident
+    pub fn analyze(&mut self) -> AnalyzerOutput {
+        if self.engine != "rpgm" {
+            return self.analyzer().analyze(&self.root);
+        }
+
+        let mut sink = CollectingSink::default();
+        if let Err(error) = self.analyze_stream(&mut sink) {
+            return AnalyzerOutput::error(error);
+        }
+        let root = self.root.clone();
+        RpgmAnalyzer::result_output(&root, sink)
+    }
+
+    /// Same as the engine's `analyze_stream`, keeping the parsed documents resident
+    pub fn analyze_stream(&mut self, sink: &mut dyn AnalysisSink) -> Result<StreamStatus, String> {
+        if self.engine != "rpgm" {
+            return self.analyzer().analyze_stream(&self.root, sink);
+        }
+
+        // A new analysis replaces whatever an earlier one left behind
+        self.documents.clear();
+        self.lru.clear();
+        self.stats.resident_bytes = 0;
+
+        // Documents are inserted as they are parsed, so the cap already applies during analysis
+        let root = self.root.clone();
+        let analyzer = RpgmAnalyzer::with_options(self.options).with_cache_file(self.cache_file.clone());
+        analyzer.analyze_documents(
+            &root,
+            sink,
+            Some(&mut |path, doc, metadata| {
+                self.insert(path, doc, &metadata);
+            }),
+        )
+    }
+
+    /// Applies the translations of `texts` and writes the touched files
+    pub fn save(&mut self, texts: &[TextEntry]) -> Result<(), String> {
+        if self.engine != "rpgm" {
+            return self.analyzer().save(texts);
+        }
+
+        for (file_path, updates) in RpgmAnalyzer::group_updates(texts) {
+            let metadata = fs::metadata(&file_path)
+                .map_err(|e| format!("Failed to read {}: {}", file_path, e))?;
+
+            let mut doc = match self.remove(&file_path) {
+                Some(resident) if resident.matches(&metadata) => {
+                    self.stats.hits += 1;
+                    resident.doc
+                }
+                _ => {
+                    self.stats.misses += 1;
+                    let content = fs::read_to_string(&file_path)
+                        .map_err(|e| format!("Failed to read {}: {}", file_path, e))?;
+                    serde_json::from_str(&content)
+                        .map_err(|e| format!("Failed to parse {}: {}", file_path, e))?
+                }
+            };
+
+            RpgmAnalyzer::apply_updates(&mut doc, &file_path, &updates);
+            RpgmAnalyzer::write_document(&file_path, &doc)?;
+
+            // The document now matches what was written
+            if let Ok(metadata) = fs::metadata(&file_path) {
+                self.insert(file_path, doc, &metadata);
+            }
+        }
+
+        Ok(())
+    }
+
+    /// Keeps `doc` resident unless it alone exceeds the cap
+    fn insert(&mut self, path: String, doc: Value, metadata: &fs::Metadata) {
+        self.remove(&path);
+        let cost = resident_size(&doc);
+        if cost > self.memory_cap {
+            return;
+        }
+
+        self.clock += 1;
+        self.lru.insert(self.clock, path.clone());
+        self.documents.insert(
+            path,
+            ResidentDocument {
+                doc,
+                len: metadata.len(),
+                modified: metadata.modified().ok(),
+                cost,
+                last_used: self.clock,
+            },
+        );
+        self.stats.resident_bytes += cost;
+        self.evict();
+    }
+
+    fn remove(&mut self, path: &str) -> Option<ResidentDocument> {
+        let resident = self.documents.remove(path)?;
+        self.lru.remove(&resident.last_used);
+        self.stats.resident_bytes -= resident.cost;
+        Some(resident)
+    }
+
+    /// Drops the least recently used documents until the cap is respected
+    fn evict(&mut self) {
+        while self.stats.resident_bytes > self.memory_cap {
+            let Some((_, coldest)) = self.lru.pop_first() else {
+                break;
+            };
+            if let Some(resident) = self.documents.remove(&coldest) {
+                self.stats.resident_bytes -= resident.cost;
+                self.stats.evictions += 1;
+            }
+        }
+    }
+}
+
+/// Estimated heap and inline memory of a parsed document. A `Value` takes several times the
+/// size of its JSON text: every number, `null` and bracket becomes a full enum, and every object
+/// key its own `String`. The C++ `core::DocumentCache` charges its documents per value too, so
+/// a budget means the same on both backends.
+pub fn resident_size(value: &Value) -> u64 {
+    let heap = match value {
+        Value::String(text) => text.capacity(),
+        Value::Array(items) => items.iter().map(|item| resident_size(item) as usize).sum(),
+        Value::Object(map) => map
+            .iter()
+            .map(|(key, item)| size_of::<String>() + key.capacity() + resident_size(item) as usize)
+            .sum(),
+        _ => 0,
+    };
+    (size_of::<Value>() + heap) as u64
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn write_project(name: &str) -> PathBuf {
+        let project = std::env::temp_dir().join(format!("bga_rs_{}_{}", name, std::process::id()));
+        let data = project.join("data");
+        fs::create_dir_all(&data).unwrap();
+        for map in ["Map001.json", "Map002.json"] {
+            fs::write(
+                data.join(map),
+                r#"{"events":[null,{"pages":[{"list":[{"code":401,"indent":0,"parameters":["Hello"]}]}]}]}"#,
+            )
+            .unwrap();
+        }
+        project
+    }
+
+    fn translation(path: &Path, text: &str) -> TextEntry {
+        TextEntry {
+            source: "Hello".to_string(),
+            path: path.to_string_lossy().to_string(),
+            key: "events[1].pages[0].list[0].parameters[0]".to_string(),
+            text: Some(text.to_string()),
+        }
+    }
+
+    #[test]
+    fn test_save_uses_resident_documents() {
+        let root = write_project("resident");
+        let map = root.join("data").join("Map001.json");
+
+        let mut project = Project::open("rpgm", &root, u64::MAX).unwrap();
+        let result: Value = serde_json::from_str(&project.analyze().payload).unwrap();
+        assert_eq!(result["files"].as_array().unwrap().len(), 2);
+        assert_eq!(project.stats().resident_documents, 2);
+
+        project.save(&[translation(&map, "Bonjour")]).unwrap();
+        project.save(&[translation(&map, "Salut")]).unwrap();
+        let saved: Value = serde_json::from_str(&fs::read_to_string(&map).unwrap()).unwrap();
+        fs::remove_dir_all(&root).unwrap();
+
+        assert_eq!(saved["events"][1]["pages"][0]["list"][0]["parameters"][0], "Salut");
+        assert_eq!(project.stats().hits, 2);
+        assert_eq!(project.stats().misses, 0);
+    }
+
+    #[test]
+    fn test_manifest_skips_unchanged_files() {
+        let root = write_project("manifest");
+        let manifest = root.join("Game.analysis.json");
+
+        let mut project = Project::open("rpgm", &root, u64::MAX).unwrap();
+        project.set_cache_file(Some(manifest.clone()));
+        let first: Value = serde_json::from_str(&project.analyze().payload).unwrap();
+        assert!(manifest.exists());
+        assert_eq!(project.stats().resident_documents, 2);
+
+        // Nothing changed: every file comes from the manifest and none is parsed
+        let second: Value = serde_json::from_str(&project.analyze().payload).unwrap();
+        let resident = project.stats().resident_documents;
+        fs::remove_dir_all(&root).unwrap();
+
+        assert_eq!(first["files"], second["files"]);
+        assert_eq!(resident, 0);
+    }
+
+    #[test]
+    fn test_memory_cap_evicts_cold_documents() {
+        let root = write_project("evict");
+        let map = fs::read_to_string(root.join("data").join("Map001.json")).unwrap();
+        let map_len = map.len() as u64;
+        let map_cost = resident_size(&serde_json::from_str(&map).unwrap());
+
+        let mut project = Project::open("rpgm", &root, map_cost).unwrap();
+        project.analyze();
+        let mut disabled = Project::open("rpgm", &root, 0).unwrap();
+        disabled.analyze();
+        fs::remove_dir_all(&root).unwrap();
+
+        let stats = project.stats();
+        assert!(map_cost > 2 * map_len);
+        assert_eq!(stats.resident_documents, 1);
+        assert_eq!(stats.evictions, 1);
+        assert_eq!(stats.resident_bytes, map_cost);
+        assert_eq!(disabled.stats().resident_documents, 0);
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef CORE_ANALYSISCACHE_H
+#define CORE_ANALYSISCACHE_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QByteArrayView>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QJsonArray>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+
+namespace core {
+
+/// Manifest of the files an analyzer has read, with the entries extracted from each of them.
+/// A file whose size and modification time are unchanged is reused without being read; a file
+/// that was only touched (same content hash) is reused after hashing it. Everything else is
+/// analyzed again.
+///
+/// The manifest lives next to the .nst workspace (see pathForWorkspace()) and is tied to an
+/// analyzer signature, so changes to the extraction rules invalidate it as a whole.
+class AnalysisCache {
+public:
+    struct FileEntry {
+        qint64 size = -1;
+        qint64 lastModified = 0; // Milliseconds since the epoch, UTC
+        QByteArray contentHash;
+        QJsonArray strings;
+    };
+
+    AnalysisCache(const QString &manifestPath, const QString &signature);
+
+    /// Reads the manifest. Returns false, leaving the cache empty, if it does not exist, cannot be
+    /// parsed or was written for another signature.
+    bool load();
+
+    /// Writes the manifest atomically.
+    bool save() const;
+
+    /// Entry recorded for `filePath`, or nullptr.
+    const FileEntry *find(const QString &filePath) const;
+
+    void insert(const QString &filePath, const FileEntry &entry);
+
+    /// Drops the entries of files that are not in `filePaths` (deleted or no longer analyzed).
+    void retain(const QSet<QString> &filePaths);
+
+    qsizetype size() const { return m_files.size(); }
+    const QString &manifestPath() const { return m_manifestPath; }
+
+    /// True if `info` still has the size and modification time recorded in `entry`.
+    static bool matchesFingerprint(const FileEntry &entry, const QFileInfo &info);
+    static QByteArray hashContent(QByteArrayView content);
+
+    /// "Game_Translation.nst" -> "Game_Translation.analysis.json" in the same directory.
+    static QString pathForWorkspace(const QString &workspaceFile);
+
+private:
+    QString m_manifestPath;
+    QString m_signature;
+    QHash<QString, FileEntry> m_files;
+};
+
+} // namespace core
+
+#endif // CORE_ANALYSISCACHE_H
@@ -0,0 +1,57 @@
+#ifndef CORE_ANALYZERPAYLOAD_H
+#define CORE_ANALYZERPAYLOAD_H
+
+#include "core/gameanalyzer.h"
+#include "core/stringpool.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QList>
+#include <QtCore/QString>
+
+namespace core {
+
+/// Serialization of the analyzer result object ({"strings": [...], "fonts": [...], ...}).
+///
+/// JSON payloads are plain QJsonDocument text. CBOR payloads carry the same tree written with
+/// QCborStreamWriter: maps, arrays, UTF-8 strings, integers, doubles, booleans and null, with no
+/// tags, so they can be read back without going through QCborValue.
+class AnalyzerPayload {
+public:
+    /// Layout of the result object.
+    /// 1: {"strings": [{"source", "key", "path"}, ...]}, the file path repeated in every entry.
+    /// 2: {"schemaVersion": 2, "files": [{"path", "entries": [{"source", "key"}, ...]}, ...]}.
+    ///    With an optional "pool" array of unique texts, entries reference their text as
+    ///    {"sourceId": n, "key"} instead of repeating it.
+    static constexpr int SchemaVersion = 2;
+
+    struct FileRecord {
+        QString path;
+        QJsonArray entries;
+    };
+
+    /// Encodes `root` as kCborPayloadFormat, or as compact JSON for any other format.
+    static QByteArray encode(const QJsonObject &root, QStringView format);
+
+    /// Decodes a payload of either format. A JSON array payload (older analyzers) is returned
+    /// as {"strings": [...]}. Returns false and sets `errorMessage` on malformed input.
+    static bool decode(const AnalyzerOutput &output, QJsonObject *root, QString *errorMessage = nullptr);
+
+    /// Entries of a decoded result grouped by file, in output order, with pooled texts resolved
+    /// back to "source". Schema 1 results are grouped by the "path" of their entries, which keep
+    /// that member.
+    static QList<FileRecord> files(const QJsonObject &root);
+
+    /// Flat schema 1 view of a decoded result: every entry carries its "path".
+    static QJsonArray strings(const QJsonObject &root);
+
+    /// Schema 2 result object for `files`; `extra` members (engine, fonts, ...) are copied over.
+    /// If `pool` is given, every "source" is interned into it and the result carries the pool.
+    static QJsonObject makeResult(const QList<FileRecord> &files, const QJsonObject &extra = {},
+                                  StringPool *pool = nullptr);
+};
+
+} // namespace core
+
+#endif // CORE_ANALYZERPAYLOAD_H
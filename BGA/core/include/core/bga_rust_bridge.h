@@ -4,6 +4,8 @@
 #include "core/gameanalyzer.h"
 #include <QString>
 #include <QJsonArray>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 
 // C FFI declarations from Rust library
@@ -14,6 +16,92 @@ extern "C" {
     /// @return JSON string (must be freed with bga_free_string)
     char* bga_analyze(const char* engine, const char* path);
 
+    /// Chunk kinds of bga_analyze_stream; every chunk is one UTF-8 JSON object
+    enum {
+        BGA_CHUNK_HEADER = 0,  ///< {"fonts": [...]}, once before the first file
+        BGA_CHUNK_FILE = 1,    ///< {"path": ..., "entries": [...]}, one per file with entries
+        BGA_CHUNK_SUMMARY = 2, ///< {"filesProcessed": n, "filesFailed": m}, once at the end
+        BGA_CHUNK_ERROR = 3    ///< {"error": ...}, when the analysis fails
+    };
+
+    /// Receives one chunk; `data` is only valid during the call. Non-zero cancels the analysis.
+    typedef int (*bga_chunk_callback)(void* user_data, int kind, const char* data, size_t len);
+
+    /// Reports that `done` of `total` files were read. Non-zero cancels the analysis.
+    typedef int (*bga_progress_callback)(void* user_data, size_t done, size_t total);
+
+    /// Analyze a game project, delivering each file's entries as soon as they are extracted.
+    /// Callbacks run on the calling thread, in file order.
+    /// @param engine Engine name ("rpgm", "unity", "renpy")
+    /// @param path Path to the game project
+    /// @param on_chunk Receives the chunks
+    /// @param user_data Passed back to both callbacks
+    /// @param on_progress Optional progress callback (may be null)
+    /// @return 0 when finished, 1 when cancelled, negative on error (-5 after an error chunk)
+    int bga_analyze_stream(const char* engine, const char* path, bga_chunk_callback on_chunk,
+                           void* user_data, bga_progress_callback on_progress);
+
+    /// Bytes owned by the Rust library; release with bga_buffer_free
+    typedef struct bga_buffer {
+        const uint8_t* ptr;
+        size_t len;
+    } bga_buffer;
+
+    /// Analyze a game project without copying the result: the JSON payload (not null-terminated)
+    /// stays in Rust memory until bga_buffer_free
+    /// @param engine Engine name ("rpgm", "unity", "renpy")
+    /// @param path Path to the game project
+    /// @param error Optional (may be null); receives the UTF-8 error message when the analysis
+    ///        fails, {nullptr, 0} otherwise. Free it with bga_buffer_free.
+    /// @return The payload, or {nullptr, 0} on error
+    bga_buffer bga_analyze_buffer(const char* engine, const char* path, bga_buffer* error);
+
+    /// Analyze a game project with threading options; same payload as bga_analyze_buffer
+    /// @param engine Engine name ("rpgm", "unity", "renpy")
+    /// @param path Path to the game project
+    /// @param options_json JSON object, null for the defaults: {"threads": n} (0 = one per core,
+    ///        1 = serial), {"deterministic": bool} (keep the serial file order, default true)
+    /// @param error Optional, as in bga_analyze_buffer
+    /// @return The payload, or {nullptr, 0} on error
+    bga_buffer bga_analyze_with_options(const char* engine, const char* path, const char* options_json,
+                                        bga_buffer* error);
+
+    /// Free a payload or error buffer returned by the functions above
+    void bga_buffer_free(bga_buffer buffer);
+
+    /// Opened game project whose parsed documents stay resident between analysis and save
+    typedef struct bga_project bga_project;
+
+    /// Open a game project
+    /// @param engine Engine name ("rpgm", "unity", "renpy")
+    /// @param path Path to the game project
+    /// @param memory_cap Upper bound on the estimated memory of resident documents, 0 keeps none
+    /// @return Handle (must be closed with bga_close_project), or null on error
+    bga_project* bga_open_project(const char* engine, const char* path, uint64_t memory_cap);
+
+    /// Set the threading options of an opened project's next analyses, as in
+    /// bga_analyze_with_options
+    /// @return 0 on success, -1 for a null handle, -2 for unreadable options
+    int bga_project_set_options(bga_project* project, const char* options_json);
+
+    /// Set the analysis manifest of an opened project's next analyses; null or empty turns it off
+    /// @return 0 on success, -1 for a null handle, -2 for a path that is not UTF-8
+    int bga_project_set_cache_file(bga_project* project, const char* cache_file);
+
+    /// Analyze an opened project; same payload and error as bga_analyze_buffer
+    bga_buffer bga_project_analyze(bga_project* project, bga_buffer* error);
+
+    /// Streaming analysis of an opened project; same chunks and results as bga_analyze_stream
+    int bga_project_analyze_stream(bga_project* project, bga_chunk_callback on_chunk,
+                                   void* user_data, bga_progress_callback on_progress);
+
+    /// Save through an opened project: resident documents are patched in memory and written
+    /// @return 0 on success, non-zero on error (same codes as bga_save)
+    int bga_project_save(bga_project* project, const char* texts_json);
+
+    /// Close a project handle and drop its resident documents
+    void bga_close_project(bga_project* project);
+
     /// Save translated texts back to game files
     /// @param engine Engine name
     /// @param texts_json JSON array of text entries
@@ -37,14 +125,31 @@ namespace core {
 class RustAnalyzerBridge : public IGameAnalyzer {
 public:
     explicit RustAnalyzerBridge(const QString& engineName);
-    ~RustAnalyzerBridge() override = default;
+    ~RustAnalyzerBridge() override;
+
+    RustAnalyzerBridge(const RustAnalyzerBridge&) = delete;
+    RustAnalyzerBridge& operator=(const RustAnalyzerBridge&) = delete;
 
     /// Analyze the game project at the given path
     AnalyzerOutput analyze(const QString& inputPath) override;
 
-    /// Save translated texts back to the game files
+    /// Forward the files to `sink` while the Rust side is still walking the project
+    AnalysisStatus analyzeStream(const QString& inputPath, IAnalysisSink& sink, QString* errorMessage = nullptr) override;
+
+    /// Save translated texts back to the game files. Files parsed by the last analysis of this
+    /// bridge are patched from memory instead of being read and parsed again.
     bool save(const QString& outputPath, const QJsonArray& texts) override;
 
+    /// Upper bound on the estimated memory of documents kept between analysis and save, charged
+    /// like core::DocumentCache::cost(); 0 keeps none. Applies from the next analysis.
+    void setDocumentCacheBudget(qint64 bytes) override;
+
+    /// Manifest for incremental re-analysis of RPG Maker projects; applies from the next analysis
+    void setCacheFile(const QString& manifestPath) override;
+
+    /// Rayon worker threads of the Rust engines; applies from the next analysis
+    void setParallelism(int threads, bool deterministicOrder = true) override;
+
     /// Check if script editing is supported
     bool canEditScript() const override { return m_engine == "rpgm"; }
 
@@ -55,7 +160,19 @@ public:
     QString getScriptTarget() const override;
 
 private:
+    /// Handle for `inputPath`, reopened when the project changes
+    bga_project* projectFor(const QString& inputPath);
+
+    /// `options_json` of the FFI for the current parallelism settings
+    QByteArray optionsJson() const;
+
     QString m_engine;
+    bga_project* m_project = nullptr;
+    QString m_projectPath;
+    quint64 m_documentMemoryCap = 0;
+    int m_threadCount = 0;
+    bool m_deterministicOrder = true;
+    QString m_cacheFile;
 };
 
 /// Create an analyzer using the Rust backend
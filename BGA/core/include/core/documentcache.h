@@ -0,0 +1,92 @@
+#ifndef CORE_DOCUMENTCACHE_H
+#define CORE_DOCUMENTCACHE_H
+
+#include "core/jsonscanner.h"
+
+#include <QtCore/QByteArray>
+#include <QtCore/QDateTime>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QMutex>
+#include <QtCore/QString>
+
+#include <list>
+
+namespace core {
+
+/// In-memory cache of the game files an analyzer has read, kept from analysis to save so that
+/// saving does not read and parse them again. Entries are keyed by file path and only returned
+/// while the file still has the size and modification time they were recorded with.
+///
+/// The cache is bounded by a budget on the estimated memory of its entries (see cost()); the
+/// least recently used entries are evicted first. A budget of 0 turns it off. All members are
+/// thread-safe.
+class DocumentCache {
+public:
+    struct Entry {
+        qint64 size = -1;
+        QDateTime lastModified;
+        QByteArray content;             // Bytes of the file, null if not kept
+        QJsonDocument document;         // The whole file parsed, null if not kept
+        QHash<QString, JsonSpan> spans; // Key path -> string literal in `content`
+    };
+
+    struct Stats {
+        qsizetype documents = 0;   // Entries currently resident
+        qint64 residentBytes = 0;  // Estimated memory of the resident entries
+        quint64 hits = 0;          // Lookups that found a current entry
+        quint64 misses = 0;        // Lookups that found nothing or a stale entry
+        quint64 evictions = 0;     // Entries dropped to stay within the budget
+    };
+
+    explicit DocumentCache(qint64 budget = 0) : m_budget(budget) {}
+
+    DocumentCache(const DocumentCache &) = delete;
+    DocumentCache &operator=(const DocumentCache &) = delete;
+
+    /// Shrinking the budget evicts right away; 0 drops every entry and turns the cache off.
+    void setBudget(qint64 bytes);
+    qint64 budget() const;
+    bool isEnabled() const { return budget() > 0; }
+
+    /// Copies the entry of `filePath` to `entry` if it matches `info`. A stale entry is dropped.
+    bool find(const QString &filePath, const QFileInfo &info, Entry *entry);
+
+    /// Adds or replaces the entry of `filePath`. Ignored while the cache is off or if the entry
+    /// alone exceeds the budget.
+    void insert(const QString &filePath, const Entry &entry);
+
+    void remove(const QString &filePath);
+
+    /// Drops every entry; the counters are kept.
+    void clear();
+
+    Stats stats() const;
+
+    /// Estimated memory held by `entry`. A parsed document is charged per value it holds, which
+    /// comes to several times its source text; the Rust backend estimates its documents the same
+    /// way, so one budget means the same on both.
+    static qint64 cost(const Entry &entry);
+
+private:
+    struct Node {
+        Entry entry;
+        qint64 cost = 0;
+        std::list<QString>::iterator lruPosition;
+    };
+
+    // Callers hold m_mutex
+    void evict();
+    void removeNode(QHash<QString, Node>::iterator it);
+
+    mutable QMutex m_mutex;
+    qint64 m_budget;
+    QHash<QString, Node> m_nodes;
+    std::list<QString> m_lru; // Keys of m_nodes, least recently used first
+    Stats m_stats;
+};
+
+} // namespace core
+
+#endif // CORE_DOCUMENTCACHE_H
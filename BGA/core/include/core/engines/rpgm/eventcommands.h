@@ -0,0 +1,130 @@
+#ifndef RPGM_EVENTCOMMANDS_H
+#define RPGM_EVENTCOMMANDS_H
+
+#include <array>
+#include <iterator>
+
+namespace core {
+namespace engines {
+namespace rpgm {
+
+/// What an event command keeps in its `parameters` array.
+enum class EventParameterText {
+    None,      // No text at a known position
+    String,    // parameters[textParameter] is a translatable string
+    ChoiceList // parameters[textParameter] is an array of choice strings
+};
+
+/// Extraction descriptor of one RPG Maker event command code.
+struct EventCommandRule {
+    int code = 0;
+    EventParameterText text = EventParameterText::None;
+    int textParameter = -1;
+    // Never look inside `parameters` (file names, scripts, pure logic). When false, the
+    // parameters are walked generically unless text was found at textParameter.
+    bool skipParameters = false;
+};
+
+/// Built-in rules, one per known code. Codes missing here are "unknown": their parameters are
+/// walked generically and they are counted per file.
+inline constexpr EventCommandRule kEventCommandRules[] = {
+    // === Text Display Commands ===
+    {101, EventParameterText::String, 4},     // Show Text: actor name
+    {401, EventParameterText::String, 0},     // Show Text: dialogue line
+    {102, EventParameterText::ChoiceList, 0}, // Show Choices
+    {103},                                    // Input Number
+    {104},                                    // Select Item
+    {105, EventParameterText::String, 0},     // Show Scrolling Text
+    {405, EventParameterText::String, 0},     // Show Scrolling Text continuation
+
+    // === Comments and flow control ===
+    {108, EventParameterText::None, -1, true}, // Comment
+    {408, EventParameterText::None, -1, true}, // Comment continuation
+    {111, EventParameterText::None, -1, true}, // Conditional Branch
+    {112, EventParameterText::None, -1, true}, // Loop
+    {113, EventParameterText::None, -1, true}, // Break Loop
+    {115, EventParameterText::None, -1, true}, // Exit Event Processing
+    {117, EventParameterText::None, -1, true}, // Common Event
+    {118, EventParameterText::None, -1, true}, // Label
+    {119, EventParameterText::None, -1, true}, // Jump to Label
+    {121, EventParameterText::None, -1, true}, // Control Switches
+    {122, EventParameterText::None, -1, true}, // Control Variables
+    {123, EventParameterText::None, -1, true}, // Control Self Switch
+    {124, EventParameterText::None, -1, true}, // Control Timer
+
+    // === Game Progression Commands ===
+    {125, EventParameterText::None, -1, true}, // Change Gold
+    {126, EventParameterText::None, -1, true}, // Change Items
+    {127, EventParameterText::None, -1, true}, // Change Weapons
+    {128, EventParameterText::None, -1, true}, // Change Armors
+    {129, EventParameterText::None, -1, true}, // Change Party Member
+
+    // === Screen Commands ===
+    {201, EventParameterText::None, -1, true}, // Transfer Player
+    {202, EventParameterText::None, -1, true}, // Set Vehicle Location
+    {203, EventParameterText::None, -1, true}, // Set Event Location
+    {204, EventParameterText::None, -1, true}, // Scroll Map
+    {205, EventParameterText::None, -1, true}, // Set Movement Route
+    {231, EventParameterText::None, -1, true}, // Show Picture (picture name is a file name)
+
+    // === Audio Commands ({name, volume, pitch, pan} parameters hold file names) ===
+    {241, EventParameterText::None, -1, true}, // Play BGM
+    {242, EventParameterText::None, -1, true}, // Fadeout BGM
+    {245, EventParameterText::None, -1, true}, // Play BGS
+    {246, EventParameterText::None, -1, true}, // Fadeout BGS
+    {249, EventParameterText::None, -1, true}, // Play ME
+    {250, EventParameterText::None, -1, true}, // Play SE
+
+    // === Battle Commands ===
+    {301, EventParameterText::None, -1, true}, // Battle Processing
+    {311, EventParameterText::None, -1, true}, // Change HP
+    {312, EventParameterText::None, -1, true}, // Change MP
+    {313, EventParameterText::None, -1, true}, // Change State
+    {314, EventParameterText::None, -1, true}, // Recover All
+    {339, EventParameterText::None, -1, true}, // Force Action
+
+    // === Actor Commands ===
+    {320, EventParameterText::String, 1}, // Change Name
+    {324, EventParameterText::String, 1}, // Change Nickname
+
+    // === Plugin and Script Commands ===
+    // Plugin commands are usually technical ("EnemyBook open"); projects whose plugins take
+    // text can override 356/357 with RpgmAnalyzer::setEventCommandRule().
+    {356, EventParameterText::None, -1, true}, // Plugin Command (MV)
+    {357, EventParameterText::None, -1, true}, // Plugin Command (MZ)
+    {355, EventParameterText::None, -1, true}, // Script
+    {655, EventParameterText::None, -1, true}, // Script continuation
+};
+
+/// Codes are looked up through a direct index built at compile time.
+inline constexpr int kMaxEventCommandCode = 1000;
+
+inline constexpr auto kEventCommandIndex = [] {
+    std::array<short, kMaxEventCommandCode> index{};
+    for (auto &slot : index) {
+        slot = -1;
+    }
+    for (int i = 0; i < static_cast<int>(std::size(kEventCommandRules)); ++i) {
+        index[kEventCommandRules[i].code] = static_cast<short>(i);
+    }
+    return index;
+}();
+
+/// Built-in rule for `code`, or nullptr for an unknown code.
+constexpr const EventCommandRule *findEventCommandRule(int code)
+{
+    if (code < 0 || code >= kMaxEventCommandCode || kEventCommandIndex[code] < 0) {
+        return nullptr;
+    }
+    return &kEventCommandRules[kEventCommandIndex[code]];
+}
+
+static_assert(findEventCommandRule(401)->textParameter == 0);
+static_assert(findEventCommandRule(102)->text == EventParameterText::ChoiceList);
+static_assert(findEventCommandRule(0) == nullptr);
+
+} // namespace rpgm
+} // namespace engines
+} // namespace core
+
+#endif // RPGM_EVENTCOMMANDS_H
@@ -1,7 +1,18 @@
 #ifndef RPGM_ANALYZER_H
 #define RPGM_ANALYZER_H
 
+#include "core/engines/rpgm/eventcommands.h"
+#include "core/analysiscache.h"
+#include "core/documentcache.h"
 #include "core/gameanalyzer.h"
+#include "core/jsonpatchtree.h"
+#include "core/jsonscanner.h"
+#include "core/keypath.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QFileInfo>
+#include <QtCore/QHash>
+#include <QtCore/QMap>
 
 namespace core {
 namespace engines {
@@ -10,18 +21,113 @@ namespace rpgm {
 class RpgmAnalyzer : public core::IGameAnalyzer {
 public:
     core::    AnalyzerOutput analyze(const QString &inputPath) override;
+    core::AnalysisStatus analyzeStream(const QString &inputPath, core::IAnalysisSink &sink, QString *errorMessage = nullptr) override;
     bool save(const QString &outputPath, const QJsonArray &texts) override;
+    void setOutputFormat(const QString &format) override { m_outputFormat = format; }
+    void setCacheFile(const QString &manifestPath) override { m_cacheFile = manifestPath; }
+    // Keeps the bytes, parsed documents and string offsets of analyzed files for save(), within
+    // `bytes` of memory. Off (0) by default; save() then reads every file again.
+    void setDocumentCacheBudget(qint64 bytes) override { m_documents.setBudget(bytes); }
+    core::DocumentCache::Stats documentCacheStats() const { return m_documents.stats(); }
 
     bool canEditScript() const override { return true; }
     QString getScriptPath(const QString &projectPath) const override;
     QString getScriptTarget() const override; // Matching base class signature
+
+    // Extracts the translatable strings ({"source", "key"} entries) of an already parsed data file.
+    // Event codes without a rule are counted into `unknownEventCodes` if given, otherwise they are
+    // logged once for the file.
+    QJsonArray extractStrings(const QJsonDocument &doc, const QString &filePath, QMap<int, int> *unknownEventCodes = nullptr);
+
+    // Overrides the built-in rule of kEventCommandRules for rule.code (e.g. plugin commands 356/357
+    // of projects whose plugins take text).
+    void setEventCommandRule(const EventCommandRule &rule);
+    void resetEventCommandRules();
+
+    // Subtrees dropped at raw-byte speed before a data file is parsed (tile data, animation frames, ...).
+    static core::JsonSkipRules defaultSkipRules();
+    void setSkipRules(const core::JsonSkipRules &rules)
+    {
+        m_skipRules = rules;
+        m_skipMatcher = core::JsonSkipMatcher(rules);
+    }
+    const core::JsonSkipRules &skipRules() const { return m_skipRules; }
+
+    // Emits each run of two or more 401 (Show Text) or 405 (Scrolling Text) lines as one entry
+    // whose text joins the lines with "\n" and whose key names the range of commands, e.g.
+    // "1.list[3..5].parameters[0]". save() spreads the translation back over those lines.
+    void setMergeDialogue(bool merge) { m_mergeDialogue = merge; }
+    bool mergeDialogue() const { return m_mergeDialogue; }
+
+    // How save() writes a data file back.
+    enum class SaveMode {
+        Patch,      // Splice the changed string literals into the original bytes; formatting is kept
+        Reserialize // Parse, update and write the whole document with QJsonDocument::Indented
+    };
+    void setSaveMode(SaveMode mode) { m_saveMode = mode; }
+    SaveMode saveMode() const { return m_saveMode; }
  // Implement save method
 private:
-    void extractStringsFromJsonValue(const QJsonValue &jsonValue, QJsonArray &extractedStrings, const QString &filePath, const QString &currentKeyPath = "");
-    bool updateJsonValue(QJsonDocument &doc, const QString &keyPath, const QString &newValue);
-    bool updateJsonObject(QJsonObject &obj, const QStringList &keys, int index, const QString &newValue);
-    bool updateJsonArray(QJsonArray &arr, const QStringList &keys, int index, const QString &newValue);
-    bool isSystemString(const QString &text);
+    // Byte offsets of the extracted string literals of one file, valid while the file is unchanged.
+    struct FileSpans {
+        qint64 size = -1;
+        QDateTime lastModified;
+        QHash<QString, core::JsonSpan> spans; // key path -> literal
+    };
+
+    // Result of analyzing one JSON file; produced on a worker thread and merged in file order.
+    struct FileExtraction {
+        QJsonArray strings;
+        bool parsed = false;
+        QString error;
+        FileSpans spans;
+        QMap<int, int> unknownEventCodes;
+        QByteArray contentHash; // Only computed when a cache is in use
+        bool fromCache = false;
+        core::DocumentCache::Entry resident; // Only filled while the document cache is on
+    };
+
+    // Translations bound for one data file
+    struct FileUpdates {
+        core::JsonPatchTree tree;
+        QHash<QString, QString> values; // Normalized key path -> newValue, for recorded spans
+    };
+
+    // Outcome of writing one file back; produced on a worker thread.
+    struct FileSave {
+        QString filePath;
+        QString error; // Empty when the file was written
+        QList<core::KeyPath> unresolved;
+    };
+
+    struct AnalysisTotals {
+        int processed = 0;
+        int failed = 0;
+    };
+
+    // Shared by analyze() and analyzeStream(): entries go to `sink` file by file. Fails when
+    // there is nothing to analyze or no file could be read.
+    core::AnalysisStatus analyzeFiles(const QString &inputPath, core::IAnalysisSink &sink,
+                                      AnalysisTotals &totals, QString *errorMessage);
+    FileExtraction extractFile(const QFileInfo &info, const core::AnalysisCache *cache, bool keepResident);
+    QString cacheSignature() const;
+    FileSave saveFile(const QString &filePath, const FileUpdates &updates);
+    QByteArray patchFile(const QString &filePath, const QByteArray &content, const core::JsonPatchTree &updates,
+                         const QHash<QString, QString> &values, const QHash<QString, core::JsonSpan> *recorded,
+                         QList<core::KeyPath> *unresolved) const;
+    void extractStringsFromJsonValue(const QJsonValue &jsonValue, QJsonArray &extractedStrings, core::KeyPath &keyPath, QMap<int, int> &unknownEventCodes) const;
+    const EventCommandRule *eventCommandRule(int code) const;
+    bool isSystemString(const QString &text) const;
+
+    core::JsonSkipRules m_skipRules = defaultSkipRules();
+    core::JsonSkipMatcher m_skipMatcher{m_skipRules};
+    SaveMode m_saveMode = SaveMode::Patch;
+    bool m_mergeDialogue = false;
+    QHash<int, EventCommandRule> m_eventCommandOverrides;
+    QString m_cacheFile;
+    QString m_outputFormat;
+    QHash<QString, FileSpans> m_fileSpans; // Recorded by analyze() for Patch saves while m_documents is off
+    core::DocumentCache m_documents;
 };
 
 } // namespace rpgm
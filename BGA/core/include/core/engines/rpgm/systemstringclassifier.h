@@ -0,0 +1,29 @@
+#ifndef RPGM_SYSTEMSTRINGCLASSIFIER_H
+#define RPGM_SYSTEMSTRINGCLASSIFIER_H
+
+#include <QtCore/QString>
+#include <QtCore/QStringView>
+
+namespace core {
+namespace engines {
+namespace rpgm {
+
+/// Decides whether a string found in an RPG Maker data file is technical (numbers, file names,
+/// resource prefixes, control codes, plugin commands, ...) rather than translatable text.
+class SystemStringClassifier {
+public:
+    /// Single pass over the string with hand-written scanners for every rule. The regular
+    /// expressions of the reference implementation are only consulted for the few inputs whose
+    /// verdict depends on Unicode case folding or script properties.
+    static bool isSystemString(const QString &text);
+
+    /// Rule-by-rule implementation built on QRegularExpression. Kept as the specification that
+    /// isSystemString() must agree with.
+    static bool isSystemStringReference(const QString &text);
+};
+
+} // namespace rpgm
+} // namespace engines
+} // namespace core
+
+#endif // RPGM_SYSTEMSTRINGCLASSIFIER_H
@@ -3,22 +3,88 @@
 
 #include <QtCore/QByteArray>
 #include <QtCore/QString>
+#include <QtCore/QStringList>
 #include <QtCore/QJsonArray> // Add this include for QJsonArray
 
+#include <memory>
+
 namespace core {
 
+/// Values of AnalyzerOutput::format. JSON is kept for debugging and external tools; CBOR is
+/// the compact format used between the analyzers and the application (see AnalyzerPayload).
+inline constexpr QLatin1String kJsonPayloadFormat("application/json");
+inline constexpr QLatin1String kCborPayloadFormat("cbor");
+
 struct AnalyzerOutput {
     QString format;
     QByteArray payload;
     QString errorMessage; // New field for error messages
+    // Unique source texts, when the analyzer pooled its output. Entries of the payload refer to
+    // them by "sourceId" (see AnalyzerPayload); in-process callers can use the list directly.
+    QStringList stringPool;
+    // Set when `payload` does not own its bytes (QByteArray::fromRawData over a buffer handed
+    // out by a backend): the buffer is released with the last copy of this owner. Keep the
+    // AnalyzerOutput alive while the payload is in use.
+    std::shared_ptr<const void> payloadOwner;
+};
+
+/// Receives the results of IGameAnalyzer::analyzeStream() while the analysis is running.
+/// Every call is made on the thread that called analyzeStream(), in output order, so the
+/// delivered files match the "files" records of analyze() (see AnalyzerPayload).
+class IAnalysisSink {
+public:
+    virtual ~IAnalysisSink() = default;
+
+    /// Fonts shipped with the project. Called at most once, before the first entries.
+    virtual void fontsFound(const QJsonArray &fonts) { Q_UNUSED(fonts); }
+
+    /// Entries extracted from one file. Files without entries are not reported. Entries need
+    /// not carry a "path" member; `filePath` is the file they belong to.
+    virtual void entriesExtracted(const QString &filePath, const QJsonArray &entries) = 0;
+
+    /// `done` of `total` files have been handled (extracted, reused or failed).
+    virtual void progress(int done, int total) { Q_UNUSED(done); Q_UNUSED(total); }
+
+    /// Polled between files; returning true stops the analysis as soon as possible.
+    virtual bool isCancelled() const { return false; }
+};
+
+enum class AnalysisStatus {
+    Finished,
+    Cancelled,
+    Failed
 };
 
 class IGameAnalyzer {
 public:
     virtual ~IGameAnalyzer() = default;
     virtual AnalyzerOutput analyze(const QString &inputPath) = 0;
+
+    // Streaming variant of analyze(): entries go to `sink` file by file instead of being
+    // collected into one payload. The default implementation runs analyze() and replays its
+    // payload, so every analyzer supports it; engines that work per file override it.
+    virtual AnalysisStatus analyzeStream(const QString &inputPath, IAnalysisSink &sink, QString *errorMessage = nullptr);
     virtual bool save(const QString &outputPath, const QJsonArray &texts) = 0; // New virtual method
 
+    // Payload format the caller wants from analyze(). Analyzers that cannot produce it keep
+    // JSON, so callers must still look at AnalyzerOutput::format (AnalyzerPayload::decode does).
+    virtual void setOutputFormat(const QString &format) { Q_UNUSED(format); }
+
+    // Incremental re-analysis: analyzers that work file by file keep a manifest of what they read
+    // at `manifestPath` and only parse files that changed since. An empty path turns it off.
+    virtual void setCacheFile(const QString &manifestPath) { Q_UNUSED(manifestPath); }
+
+    // Worker threads for per-file extraction: 0 picks one per core, 1 runs serially. With
+    // `deterministicOrder` the output is byte-identical to a serial run; without it, files are
+    // reported as soon as they are done. Analyzers that work on one thread ignore it.
+    virtual void setParallelism(int threads, bool deterministicOrder = true) { Q_UNUSED(threads); Q_UNUSED(deterministicOrder); }
+
+    // Memory an analyzer may spend keeping the game files parsed by analyze() for the next save(),
+    // so saving does not read and parse them again. It bounds the estimated size of the parsed
+    // documents, not of their files (see core::DocumentCache::cost()); 0 keeps none. Analyzers
+    // without such a cache ignore it.
+    virtual void setDocumentCacheBudget(qint64 bytes) { Q_UNUSED(bytes); }
+
     // Script Editing Support
     virtual bool canEditScript() const { return false; }
     virtual QString getScriptPath(const QString &projectPath) const { return QString(); }
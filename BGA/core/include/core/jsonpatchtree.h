@@ -0,0 +1,67 @@
+#ifndef CORE_JSONPATCHTREE_H
+#define CORE_JSONPATCHTREE_H
+
+#include "core/jsonscanner.h"
+#include "core/keypath.h"
+
+#include <QtCore/QHash>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QList>
+#include <QtCore/QString>
+
+#include <optional>
+
+namespace core {
+
+/// Prefix tree of pending string replacements for one JSON document.
+/// Updates sharing a prefix ("events[3].list[0]...", "events[3].list[1]...") share nodes, so
+/// apply() visits every container on the way to a replaced value exactly once and detaches it
+/// at most once, however many values below it change.
+class JsonPatchTree {
+public:
+    /// Queues `value` for `path`. A later insert for the same path replaces the earlier one.
+    void insert(const KeyPath &path, const QString &value);
+
+    /// Number of distinct paths queued.
+    qsizetype size() const { return m_valueCount; }
+    bool isEmpty() const { return m_valueCount == 0; }
+
+    /// Writes every queued value into `doc` in one traversal. Only existing values are replaced;
+    /// paths that do not resolve are appended to `unresolved` if given.
+    /// Index segments also match numeric member names and vice versa, like the analyzers'
+    /// dotted keys expect. Returns the number of values written.
+    qsizetype apply(QJsonDocument &doc, QList<KeyPath> *unresolved = nullptr) const;
+
+    /// Finds the byte span of every queued value in the raw bytes of a document without building
+    /// a DOM; subtrees no queued path enters are skipped at raw-byte speed. Resolution follows the
+    /// same rules as apply(). Returns false if `json` is not well-formed or a member on a queued
+    /// path appears twice, in which case the caller should parse and use apply() instead.
+    bool locate(QByteArrayView json, QList<JsonSplice> *splices, QList<KeyPath> *unresolved = nullptr) const;
+
+private:
+    struct Node {
+        std::optional<QString> value;
+        QHash<QString, int> keyChildren;     // Member name -> node index
+        QHash<qsizetype, int> indexChildren; // Array index -> node index
+    };
+
+    int child(int node, const KeyPath::Segment &segment);
+    qsizetype applyObject(int node, QJsonObject &obj, KeyPath &path, QList<KeyPath> *unresolved) const;
+    qsizetype applyArray(int node, QJsonArray &arr, KeyPath &path, QList<KeyPath> *unresolved) const;
+    qsizetype applyValue(int node, QJsonValue &value, KeyPath &path, QList<KeyPath> *unresolved) const;
+    void collectPaths(int node, KeyPath &path, QList<KeyPath> *out) const;
+
+    struct LocateState;
+    bool locateValue(int node, qsizetype &pos, int depth, LocateState &state) const;
+    bool locateObject(int node, qsizetype &pos, int depth, LocateState &state) const;
+    bool locateArray(int node, qsizetype &pos, int depth, LocateState &state) const;
+
+    QList<Node> m_nodes = QList<Node>(1); // m_nodes[0] is the document root
+    qsizetype m_valueCount = 0;
+};
+
+} // namespace core
+
+#endif // CORE_JSONPATCHTREE_H
@@ -0,0 +1,83 @@
+#ifndef CORE_JSONSCANNER_H
+#define CORE_JSONSCANNER_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QByteArrayView>
+#include <QtCore/QList>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QSet>
+#include <QtCore/QString>
+#include <QtCore/QStringView>
+
+namespace core {
+
+/// Object members whose values can never hold translatable text.
+/// A rule applies to every file whose name matches `filePattern` (wildcard, case-insensitive)
+/// and matches member names at any depth of the document.
+struct JsonSkipRule {
+    QString filePattern;
+    QSet<QByteArray> keys;
+};
+
+using JsonSkipRules = QList<JsonSkipRule>;
+
+/// Byte range of one value inside a raw JSON buffer.
+struct JsonSpan {
+    qsizetype offset = -1;
+    qsizetype length = 0;
+};
+
+/// Replacement of the value at `span` by the JSON string literal of `value`.
+struct JsonSplice {
+    JsonSpan span;
+    QString value;
+};
+
+/// Skip rules with their file patterns compiled once, to be matched against every file of a project.
+class JsonSkipMatcher {
+public:
+    JsonSkipMatcher() = default;
+    explicit JsonSkipMatcher(const JsonSkipRules &rules);
+
+    /// Union of the keys of every rule that applies to `fileName`.
+    QSet<QByteArray> keysForFile(const QString &fileName) const;
+
+private:
+    struct CompiledRule {
+        QRegularExpression pattern;
+        QSet<QByteArray> keys;
+    };
+    QList<CompiledRule> m_rules;
+};
+
+/// Minimal raw-byte JSON scanner. It never builds DOM nodes; it only finds where values start
+/// and end, which is enough to drop bulky non-text subtrees before a real parse.
+class JsonScanner {
+public:
+    /// Returns a copy of `json` in which the value of every member named in `skipKeys` is
+    /// replaced by an empty value of the same kind ([] / {} / ""). Numbers, booleans and null
+    /// are kept as they are.
+    /// Returns a null QByteArray if nothing was stripped or the input is not well-formed, in
+    /// which case the caller should parse the original bytes.
+    static QByteArray stripMembers(QByteArrayView json, const QSet<QByteArray> &skipKeys, qsizetype *skippedBytes = nullptr);
+
+    /// Index of the first non-whitespace byte at or after `pos`.
+    static qsizetype skipWhitespace(QByteArrayView json, qsizetype pos);
+
+    /// `pos` must point at an opening quote. Returns the index just past the closing quote, or -1.
+    static qsizetype skipString(QByteArrayView json, qsizetype pos);
+
+    /// `pos` must point at the first byte of a value. Returns the index just past it, or -1.
+    static qsizetype skipValue(QByteArrayView json, qsizetype pos);
+
+    /// `text` as a quoted UTF-8 JSON string literal, escaped the way JSON.stringify does.
+    static QByteArray escapeString(QStringView text);
+
+    /// Copy of `json` with every splice applied; all other bytes are kept as they are.
+    /// Returns a null QByteArray if a span lies outside `json` or two spans overlap.
+    static QByteArray applySplices(QByteArrayView json, QList<JsonSplice> splices);
+};
+
+} // namespace core
+
+#endif // CORE_JSONSCANNER_H
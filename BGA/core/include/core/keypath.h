@@ -0,0 +1,49 @@
+#ifndef CORE_KEYPATH_H
+#define CORE_KEYPATH_H
+
+#include <QtCore/QString>
+#include <QtCore/QStringView>
+#include <QtCore/QVarLengthArray>
+
+namespace core {
+
+/// Location of a value inside a JSON document, kept as a sequence of member names and array
+/// indices. The dotted form used in analyzer payloads ("events[3].list[12].parameters[0]", or
+/// "1.list[0]" when the root is an array) is only produced by toString().
+class KeyPath {
+public:
+    struct Segment {
+        QString key;          // Object member name (unused for array indices)
+        qsizetype index = -1; // Array index, or -1 for an object member
+
+        bool isIndex() const { return index >= 0; }
+        bool operator==(const Segment &other) const { return index == other.index && key == other.key; }
+    };
+
+    KeyPath() = default;
+
+    void pushKey(const QString &key) { m_segments.append(Segment{key, -1}); }
+    void pushIndex(qsizetype index) { m_segments.append(Segment{QString(), index}); }
+    void pop() { m_segments.removeLast(); }
+
+    qsizetype size() const { return m_segments.size(); }
+    bool isEmpty() const { return m_segments.isEmpty(); }
+    const Segment &at(qsizetype i) const { return m_segments.at(i); }
+
+    bool operator==(const KeyPath &other) const { return m_segments == other.m_segments; }
+    bool operator!=(const KeyPath &other) const { return !(*this == other); }
+
+    /// Dotted representation, e.g. "events[3].list[12].parameters[0]".
+    QString toString() const;
+
+    /// Parses the dotted representation. A leading all-digit segment ("1.list[0]") is read as an
+    /// index into a root array. Returns an empty path and sets `ok` to false on malformed input.
+    static KeyPath fromString(QStringView text, bool *ok = nullptr);
+
+private:
+    QVarLengthArray<Segment, 8> m_segments;
+};
+
+} // namespace core
+
+#endif // CORE_KEYPATH_H
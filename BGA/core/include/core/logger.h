@@ -0,0 +1,96 @@
+#ifndef CORE_LOGGER_H
+#define CORE_LOGGER_H
+
+#include <QtCore/QString>
+
+#include <atomic>
+#include <memory>
+
+/// Lowest level compiled into the binary (0 = trace ... 4 = error, 5 = off). Messages below it
+/// are removed at compile time together with the code that formats them. Release builds can
+/// pass -DBGA_LOG_MIN_LEVEL=5 to drop logging entirely.
+#ifndef BGA_LOG_MIN_LEVEL
+#define BGA_LOG_MIN_LEVEL 0
+#endif
+
+namespace core {
+
+enum class LogLevel : int {
+    Trace = 0,
+    Debug = 1,
+    Info = 2,
+    Warning = 3,
+    Error = 4,
+    Off = 5
+};
+
+inline constexpr LogLevel kCompiledLogLevel = static_cast<LogLevel>(BGA_LOG_MIN_LEVEL);
+
+/// Process-wide asynchronous log. Callers push records into a fixed-size lock-free ring buffer
+/// and return; a background thread drains it into the log file in batches. When the buffer is
+/// full, records are dropped and counted instead of blocking the caller.
+///
+/// Use the BGA_LOG_* macros rather than write(): they skip formatting the message when its
+/// level is disabled, at compile time or at run time.
+class Logger {
+public:
+    static Logger &instance();
+
+    /// Records below `level` are discarded. Info by default.
+    void setLevel(LogLevel level) { m_level.store(static_cast<int>(level), std::memory_order_relaxed); }
+    LogLevel level() const { return static_cast<LogLevel>(m_level.load(std::memory_order_relaxed)); }
+
+    bool isEnabled(LogLevel level) const
+    {
+        return level >= kCompiledLogLevel && static_cast<int>(level) >= m_level.load(std::memory_order_relaxed);
+    }
+
+    /// File the writer appends to; "nst_log.txt" in the temp directory by default. Returns once
+    /// the writer has switched over.
+    void setLogFile(const QString &filePath);
+    QString logFile() const;
+
+    /// `category` must be a string literal or otherwise outlive the logger.
+    void write(LogLevel level, const char *category, QString message);
+
+    /// Blocks until every record pushed so far is in the file.
+    void flush();
+
+    /// Writes out every queued record and stops the writer thread; later records are discarded.
+    /// Call it before the application exits: the static destructor may run after the thread is
+    /// gone, e.g. when the library is unloaded on Windows.
+    void shutdown();
+
+    /// Records lost because the buffer was full.
+    quint64 droppedCount() const;
+
+    ~Logger();
+
+private:
+    Logger();
+    Logger(const Logger &) = delete;
+    Logger &operator=(const Logger &) = delete;
+
+    struct Private;
+    std::unique_ptr<Private> d;
+    std::atomic<int> m_level{static_cast<int>(LogLevel::Info)};
+};
+
+} // namespace core
+
+#define BGA_LOG(level, category, message)                                                    \
+    do {                                                                                     \
+        if constexpr (core::LogLevel::level >= core::kCompiledLogLevel) {                    \
+            if (core::Logger::instance().isEnabled(core::LogLevel::level)) {                 \
+                core::Logger::instance().write(core::LogLevel::level, category, message);    \
+            }                                                                                \
+        }                                                                                    \
+    } while (false)
+
+#define BGA_LOG_TRACE(category, message) BGA_LOG(Trace, category, message)
+#define BGA_LOG_DEBUG(category, message) BGA_LOG(Debug, category, message)
+#define BGA_LOG_INFO(category, message) BGA_LOG(Info, category, message)
+#define BGA_LOG_WARNING(category, message) BGA_LOG(Warning, category, message)
+#define BGA_LOG_ERROR(category, message) BGA_LOG(Error, category, message)
+
+#endif // CORE_LOGGER_H
@@ -0,0 +1,55 @@
+#ifndef CORE_MAPPEDFILE_H
+#define CORE_MAPPEDFILE_H
+
+#include <QtCore/QByteArray>
+#include <QtCore/QByteArrayView>
+#include <QtCore/QFile>
+#include <QtCore/QString>
+
+namespace core {
+
+/// Read-only view of a whole file. Files of at least MinimumMapSize bytes are memory-mapped, so
+/// parsers run over the page cache instead of a heap copy; smaller files (and files that cannot
+/// be mapped) are read into a buffer owned by this object.
+///
+/// The bytes stay valid until the object is destroyed or close() is called. Close it before the
+/// file is written again: some platforms refuse to truncate a mapped file.
+class MappedFile {
+public:
+    /// Below this size a plain read is cheaper than setting up a mapping.
+    static constexpr qint64 MinimumMapSize = 64 * 1024;
+
+    MappedFile() = default;
+    explicit MappedFile(const QString &filePath) { open(filePath); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    /// Maps or reads `filePath`. Returns false, leaving the object empty, if it cannot be opened.
+    bool open(const QString &filePath);
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+    bool isMapped() const { return m_mapped != nullptr; }
+    QString errorString() const { return m_errorString; }
+
+    QByteArrayView data() const { return QByteArrayView(m_data, m_size); }
+    qsizetype size() const { return m_size; }
+
+    /// The contents as a QByteArray that does not own them (QByteArray::fromRawData), for APIs
+    /// that take a QByteArray. It must not outlive this object; copies made from it detach.
+    QByteArray bytes() const { return QByteArray::fromRawData(m_data, m_size); }
+
+private:
+    QFile m_file;
+    QByteArray m_buffer;
+    uchar *m_mapped = nullptr;
+    const char *m_data = nullptr;
+    qsizetype m_size = 0;
+    QString m_errorString;
+};
+
+} // namespace core
+
+#endif // CORE_MAPPEDFILE_H
@@ -0,0 +1,39 @@
+#ifndef CORE_STRINGPOOL_H
+#define CORE_STRINGPOOL_H
+
+#include <QtCore/QHash>
+#include <QtCore/QJsonArray>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+
+namespace core {
+
+/// Set of unique texts addressed by dense ids, in order of first insertion. Every text is held
+/// by a single QString; the lookup table shares its data, so a pooled text costs one allocation
+/// however often it occurs.
+class StringPool {
+public:
+    /// Id of `text`, adding it if it is not pooled yet.
+    int intern(const QString &text);
+
+    /// Id of `text`, or -1.
+    int indexOf(const QString &text) const { return m_ids.value(text, -1); }
+
+    const QString &at(int id) const { return m_strings.at(id); }
+    qsizetype size() const { return m_strings.size(); }
+    bool isEmpty() const { return m_strings.isEmpty(); }
+    const QStringList &strings() const { return m_strings; }
+
+    void clear();
+
+    QJsonArray toJson() const;
+    static StringPool fromJson(const QJsonArray &array);
+
+private:
+    QStringList m_strings;
+    QHash<QString, int> m_ids;
+};
+
+} // namespace core
+
+#endif // CORE_STRINGPOOL_H
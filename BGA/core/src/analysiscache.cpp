@@ -0,0 +1,135 @@
+#include "core/analysiscache.h"
+#include "core/logger.h"
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QSaveFile>
+
+namespace core {
+
+namespace {
+
+constexpr int kManifestVersion = 1;
+
+} // namespace
+
+AnalysisCache::AnalysisCache(const QString &manifestPath, const QString &signature)
+    : m_manifestPath(manifestPath), m_signature(signature)
+{
+}
+
+bool AnalysisCache::load()
+{
+    m_files.clear();
+
+    QFile file(m_manifestPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    file.close();
+    if (!doc.isObject()) {
+        BGA_LOG_WARNING("analysiscache", QStringLiteral("Ignoring unreadable manifest %1 (%2)")
+                                             .arg(m_manifestPath, parseError.errorString()));
+        return false;
+    }
+
+    const QJsonObject root = doc.object();
+    if (root.value(QStringLiteral("version")).toInt() != kManifestVersion
+        || root.value(QStringLiteral("signature")).toString() != m_signature) {
+        BGA_LOG_DEBUG("analysiscache", QStringLiteral("Manifest %1 was written by another analyzer version").arg(m_manifestPath));
+        return false;
+    }
+
+    const QJsonArray files = root.value(QStringLiteral("files")).toArray();
+    m_files.reserve(files.size());
+    for (const QJsonValue &value : files) {
+        const QJsonObject obj = value.toObject();
+        FileEntry entry;
+        entry.size = obj.value(QStringLiteral("size")).toInteger(-1);
+        entry.lastModified = obj.value(QStringLiteral("mtime")).toInteger();
+        entry.contentHash = QByteArray::fromHex(obj.value(QStringLiteral("hash")).toString().toLatin1());
+        entry.strings = obj.value(QStringLiteral("strings")).toArray();
+        m_files.insert(obj.value(QStringLiteral("path")).toString(), entry);
+    }
+    return true;
+}
+
+bool AnalysisCache::save() const
+{
+    QJsonArray files;
+    for (auto it = m_files.constBegin(); it != m_files.constEnd(); ++it) {
+        QJsonObject obj;
+        obj.insert(QStringLiteral("path"), it.key());
+        obj.insert(QStringLiteral("size"), it->size);
+        obj.insert(QStringLiteral("mtime"), it->lastModified);
+        obj.insert(QStringLiteral("hash"), QString::fromLatin1(it->contentHash.toHex()));
+        obj.insert(QStringLiteral("strings"), it->strings);
+        files.append(obj);
+    }
+
+    QJsonObject root;
+    root.insert(QStringLiteral("version"), kManifestVersion);
+    root.insert(QStringLiteral("signature"), m_signature);
+    root.insert(QStringLiteral("files"), files);
+
+    QSaveFile file(m_manifestPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        BGA_LOG_WARNING("analysiscache", QStringLiteral("Failed to open manifest for writing: %1").arg(m_manifestPath));
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        BGA_LOG_WARNING("analysiscache", QStringLiteral("Failed to write manifest: %1 (%2)").arg(m_manifestPath, file.errorString()));
+        return false;
+    }
+    return true;
+}
+
+const AnalysisCache::FileEntry *AnalysisCache::find(const QString &filePath) const
+{
+    const auto it = m_files.constFind(filePath);
+    return it != m_files.constEnd() ? &it.value() : nullptr;
+}
+
+void AnalysisCache::insert(const QString &filePath, const FileEntry &entry)
+{
+    m_files.insert(filePath, entry);
+}
+
+void AnalysisCache::retain(const QSet<QString> &filePaths)
+{
+    for (auto it = m_files.begin(); it != m_files.end();) {
+        if (filePaths.contains(it.key())) {
+            ++it;
+        } else {
+            it = m_files.erase(it);
+        }
+    }
+}
+
+bool AnalysisCache::matchesFingerprint(const FileEntry &entry, const QFileInfo &info)
+{
+    return entry.size == info.size()
+        && entry.lastModified == info.lastModified().toMSecsSinceEpoch();
+}
+
+QByteArray AnalysisCache::hashContent(QByteArrayView content)
+{
+    // Only has to tell edited files from touched ones, not resist tampering
+    return QCryptographicHash::hash(content, QCryptographicHash::Md5);
+}
+
+QString AnalysisCache::pathForWorkspace(const QString &workspaceFile)
+{
+    const QFileInfo info(workspaceFile);
+    return info.dir().filePath(info.completeBaseName() + QStringLiteral(".analysis.json"));
+}
+
+} // namespace core
@@ -0,0 +1,311 @@
+#include "core/analyzerpayload.h"
+
+#include <QtCore/QCborStreamReader>
+#include <QtCore/QCborStreamWriter>
+#include <QtCore/QHash>
+#include <QtCore/QJsonDocument>
+
+#include <cmath>
+
+namespace core {
+
+namespace {
+
+void writeValue(QCborStreamWriter &writer, const QJsonValue &value);
+
+void writeObject(QCborStreamWriter &writer, const QJsonObject &object)
+{
+    writer.startMap(object.size());
+    for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+        writer.append(it.key());
+        writeValue(writer, it.value());
+    }
+    writer.endMap();
+}
+
+void writeValue(QCborStreamWriter &writer, const QJsonValue &value)
+{
+    switch (value.type()) {
+    case QJsonValue::Null:
+    case QJsonValue::Undefined:
+        writer.append(nullptr);
+        break;
+    case QJsonValue::Bool:
+        writer.append(value.toBool());
+        break;
+    case QJsonValue::Double: {
+        // Integral numbers (ids, counts) are written as CBOR integers, which is what JSON
+        // readers would make of them anyway
+        const double number = value.toDouble();
+        const qint64 integer = value.toInteger();
+        if (static_cast<double>(integer) == number && !(number == 0 && std::signbit(number))) {
+            writer.append(integer);
+        } else {
+            writer.append(number);
+        }
+        break;
+    }
+    case QJsonValue::String:
+        writer.append(value.toString());
+        break;
+    case QJsonValue::Array: {
+        const QJsonArray array = value.toArray();
+        writer.startArray(array.size());
+        for (const QJsonValue &item : array) {
+            writeValue(writer, item);
+        }
+        writer.endArray();
+        break;
+    }
+    case QJsonValue::Object:
+        writeObject(writer, value.toObject());
+        break;
+    }
+}
+
+bool readString(QCborStreamReader &reader, QString *out)
+{
+    out->clear();
+    auto chunk = reader.readString();
+    while (chunk.status == QCborStreamReader::Ok) {
+        out->append(chunk.data);
+        chunk = reader.readString();
+    }
+    return chunk.status == QCborStreamReader::EndOfString;
+}
+
+bool readValue(QCborStreamReader &reader, QJsonValue *out, int depth)
+{
+    // Analyzer results are a few levels deep; anything deeper is not one of our payloads
+    if (depth > 64) {
+        return false;
+    }
+
+    switch (reader.type()) {
+    case QCborStreamReader::UnsignedInteger:
+    case QCborStreamReader::NegativeInteger:
+        *out = QJsonValue(reader.toInteger());
+        return reader.next();
+    case QCborStreamReader::Float16:
+        *out = QJsonValue(static_cast<double>(reader.toFloat16()));
+        return reader.next();
+    case QCborStreamReader::Float:
+        *out = QJsonValue(static_cast<double>(reader.toFloat()));
+        return reader.next();
+    case QCborStreamReader::Double:
+        *out = QJsonValue(reader.toDouble());
+        return reader.next();
+    case QCborStreamReader::SimpleType:
+        if (reader.isFalse() || reader.isTrue()) {
+            *out = QJsonValue(reader.isTrue());
+        } else if (reader.isNull() || reader.isUndefined()) {
+            *out = QJsonValue(QJsonValue::Null);
+        } else {
+            return false;
+        }
+        return reader.next();
+    case QCborStreamReader::String: {
+        QString text;
+        if (!readString(reader, &text)) {
+            return false;
+        }
+        *out = QJsonValue(text);
+        return true;
+    }
+    case QCborStreamReader::Array: {
+        QJsonArray array;
+        if (!reader.enterContainer()) {
+            return false;
+        }
+        while (reader.hasNext()) {
+            QJsonValue item;
+            if (!readValue(reader, &item, depth + 1)) {
+                return false;
+            }
+            array.append(item);
+        }
+        if (reader.lastError() != QCborError::NoError || !reader.leaveContainer()) {
+            return false;
+        }
+        *out = array;
+        return true;
+    }
+    case QCborStreamReader::Map: {
+        QJsonObject object;
+        if (!reader.enterContainer()) {
+            return false;
+        }
+        while (reader.hasNext()) {
+            QString key;
+            QJsonValue item;
+            if (!reader.isString() || !readString(reader, &key) || !readValue(reader, &item, depth + 1)) {
+                return false;
+            }
+            object.insert(key, item);
+        }
+        if (reader.lastError() != QCborError::NoError || !reader.leaveContainer()) {
+            return false;
+        }
+        *out = object;
+        return true;
+    }
+    default:
+        // Byte strings and tags are never written by encode()
+        return false;
+    }
+}
+
+void setError(QString *errorMessage, const QString &message)
+{
+    if (errorMessage) {
+        *errorMessage = message;
+    }
+}
+
+} // namespace
+
+QByteArray AnalyzerPayload::encode(const QJsonObject &root, QStringView format)
+{
+    if (format != kCborPayloadFormat) {
+        return QJsonDocument(root).toJson(QJsonDocument::Compact);
+    }
+
+    QByteArray payload;
+    QCborStreamWriter writer(&payload);
+    writeObject(writer, root);
+    return payload;
+}
+
+bool AnalyzerPayload::decode(const AnalyzerOutput &output, QJsonObject *root, QString *errorMessage)
+{
+    if (output.format == kCborPayloadFormat) {
+        QCborStreamReader reader(output.payload);
+        QJsonValue value;
+        if (!reader.isMap() || !readValue(reader, &value, 0)) {
+            setError(errorMessage, QStringLiteral("Invalid CBOR output from analyzer: %1")
+                                       .arg(reader.lastError().toString()));
+            return false;
+        }
+        *root = value.toObject();
+        return true;
+    }
+
+    if (output.format != kJsonPayloadFormat) {
+        setError(errorMessage, QStringLiteral("Unsupported analyzer output format: %1").arg(output.format));
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(output.payload, &parseError);
+    if (doc.isObject()) {
+        *root = doc.object();
+    } else if (doc.isArray()) {
+        *root = QJsonObject{{QStringLiteral("strings"), doc.array()}};
+    } else {
+        setError(errorMessage, QStringLiteral("Invalid JSON output from analyzer: %1").arg(parseError.errorString()));
+        return false;
+    }
+    return true;
+}
+
+QList<AnalyzerPayload::FileRecord> AnalyzerPayload::files(const QJsonObject &root)
+{
+    QList<FileRecord> records;
+
+    const QJsonValue filesValue = root.value(QStringLiteral("files"));
+    if (filesValue.isArray()) {
+        const QJsonArray files = filesValue.toArray();
+        const QJsonArray pool = root.value(QStringLiteral("pool")).toArray();
+        const QString sourceKey = QStringLiteral("source");
+        const QString sourceIdKey = QStringLiteral("sourceId");
+
+        records.reserve(files.size());
+        for (const QJsonValue &value : files) {
+            const QJsonObject file = value.toObject();
+            FileRecord record{file.value(QStringLiteral("path")).toString(),
+                              file.value(QStringLiteral("entries")).toArray()};
+            if (!pool.isEmpty()) {
+                for (qsizetype i = 0; i < record.entries.size(); ++i) {
+                    QJsonObject entry = record.entries.at(i).toObject();
+                    const int id = entry.value(sourceIdKey).toInt(-1);
+                    if (id >= 0 && id < pool.size()) {
+                        entry.remove(sourceIdKey);
+                        entry.insert(sourceKey, pool.at(id));
+                        record.entries.replace(i, entry);
+                    }
+                }
+            }
+            records.append(record);
+        }
+        return records;
+    }
+
+    // Schema 1: group the flat list, keeping files in the order they first appear
+    QHash<QString, qsizetype> recordIndex;
+    const QJsonArray strings = root.value(QStringLiteral("strings")).toArray();
+    for (const QJsonValue &value : strings) {
+        const QString path = value.toObject().value(QStringLiteral("path")).toString();
+        auto it = recordIndex.constFind(path);
+        if (it == recordIndex.constEnd()) {
+            it = recordIndex.insert(path, records.size());
+            records.append({path, QJsonArray()});
+        }
+        records[it.value()].entries.append(value);
+    }
+    return records;
+}
+
+QJsonArray AnalyzerPayload::strings(const QJsonObject &root)
+{
+    if (!root.contains(QStringLiteral("files"))) {
+        return root.value(QStringLiteral("strings")).toArray();
+    }
+
+    QJsonArray strings;
+    const QString pathKey = QStringLiteral("path");
+    for (const FileRecord &file : files(root)) {
+        for (const QJsonValue &value : file.entries) {
+            QJsonObject entry = value.toObject();
+            entry.insert(pathKey, file.path);
+            strings.append(entry);
+        }
+    }
+    return strings;
+}
+
+QJsonObject AnalyzerPayload::makeResult(const QList<FileRecord> &files, const QJsonObject &extra, StringPool *pool)
+{
+    const QString sourceKey = QStringLiteral("source");
+    const QString sourceIdKey = QStringLiteral("sourceId");
+
+    QJsonArray fileArray;
+    for (const FileRecord &file : files) {
+        QJsonObject record;
+        record.insert(QStringLiteral("path"), file.path);
+        if (pool) {
+            QJsonArray entries;
+            for (const QJsonValue &value : file.entries) {
+                QJsonObject entry = value.toObject();
+                const QJsonValue source = entry.take(sourceKey);
+                if (source.isString()) {
+                    entry.insert(sourceIdKey, pool->intern(source.toString()));
+                }
+                entries.append(entry);
+            }
+            record.insert(QStringLiteral("entries"), entries);
+        } else {
+            record.insert(QStringLiteral("entries"), file.entries);
+        }
+        fileArray.append(record);
+    }
+
+    QJsonObject root = extra;
+    root.insert(QStringLiteral("schemaVersion"), SchemaVersion);
+    if (pool) {
+        root.insert(QStringLiteral("pool"), pool->toJson());
+    }
+    root.insert(QStringLiteral("files"), fileArray);
+    return root;
+}
+
+} // namespace core
@@ -6,32 +6,175 @@
 
 namespace core {
 
+namespace {
+
+struct StreamContext {
+    IAnalysisSink* sink = nullptr;
+    QString errorMessage;
+};
+
+int onStreamChunk(void* userData, int kind, const char* data, size_t len)
+{
+    auto* context = static_cast<StreamContext*>(userData);
+
+    // The bytes belong to Rust and are gone after this call: parse them where they are
+    const QJsonObject chunk = QJsonDocument::fromJson(QByteArray::fromRawData(data, static_cast<qsizetype>(len))).object();
+    switch (kind) {
+    case BGA_CHUNK_HEADER:
+        context->sink->fontsFound(chunk.value(QStringLiteral("fonts")).toArray());
+        break;
+    case BGA_CHUNK_FILE: {
+        const QJsonArray entries = chunk.value(QStringLiteral("entries")).toArray();
+        if (!entries.isEmpty()) {
+            context->sink->entriesExtracted(chunk.value(QStringLiteral("path")).toString(), entries);
+        }
+        break;
+    }
+    case BGA_CHUNK_ERROR:
+        context->errorMessage = chunk.value(QStringLiteral("error")).toString();
+        break;
+    default:
+        break;
+    }
+    return context->sink->isCancelled() ? 1 : 0;
+}
+
+int onStreamProgress(void* userData, size_t done, size_t total)
+{
+    auto* context = static_cast<StreamContext*>(userData);
+    context->sink->progress(static_cast<int>(done), static_cast<int>(total));
+    return context->sink->isCancelled() ? 1 : 0;
+}
+
+} // namespace
+
 RustAnalyzerBridge::RustAnalyzerBridge(const QString& engineName)
     : m_engine(engineName.toLower())
 {
 }
 
+RustAnalyzerBridge::~RustAnalyzerBridge()
+{
+    bga_close_project(m_project);
+}
+
+bga_project* RustAnalyzerBridge::projectFor(const QString& inputPath)
+{
+    if (m_project && m_projectPath == inputPath) {
+        return m_project;
+    }
+
+    bga_close_project(m_project);
+    QByteArray engineBytes = m_engine.toUtf8();
+    QByteArray pathBytes = inputPath.toUtf8();
+    m_project = bga_open_project(engineBytes.constData(), pathBytes.constData(), m_documentMemoryCap);
+    m_projectPath = m_project ? inputPath : QString();
+    if (m_project) {
+        bga_project_set_options(m_project, optionsJson().constData());
+        bga_project_set_cache_file(m_project, m_cacheFile.toUtf8().constData());
+    }
+    return m_project;
+}
+
+void RustAnalyzerBridge::setCacheFile(const QString& manifestPath)
+{
+    m_cacheFile = manifestPath;
+    if (m_project) {
+        bga_project_set_cache_file(m_project, m_cacheFile.toUtf8().constData());
+    }
+}
+
+void RustAnalyzerBridge::setDocumentCacheBudget(qint64 bytes)
+{
+    const quint64 cap = bytes > 0 ? static_cast<quint64>(bytes) : 0;
+    if (cap == m_documentMemoryCap) {
+        return;
+    }
+    // The cap is fixed when a project is opened, so the next analysis opens it again
+    bga_close_project(m_project);
+    m_project = nullptr;
+    m_projectPath.clear();
+    m_documentMemoryCap = cap;
+}
+
+void RustAnalyzerBridge::setParallelism(int threads, bool deterministicOrder)
+{
+    m_threadCount = qMax(0, threads);
+    m_deterministicOrder = deterministicOrder;
+    if (m_project) {
+        bga_project_set_options(m_project, optionsJson().constData());
+    }
+}
+
+QByteArray RustAnalyzerBridge::optionsJson() const
+{
+    QJsonObject options;
+    options.insert(QStringLiteral("threads"), m_threadCount);
+    options.insert(QStringLiteral("deterministic"), m_deterministicOrder);
+    return QJsonDocument(options).toJson(QJsonDocument::Compact);
+}
+
 AnalyzerOutput RustAnalyzerBridge::analyze(const QString& inputPath)
 {
     AnalyzerOutput output;
     output.format = QStringLiteral("application/json");
 
-    QByteArray engineBytes = m_engine.toUtf8();
-    QByteArray pathBytes = inputPath.toUtf8();
+    bga_project* project = projectFor(inputPath);
+    if (!project) {
+        output.errorMessage = QStringLiteral("Unknown engine: %1").arg(m_engine);
+        return output;
+    }
 
-    char* result = bga_analyze(engineBytes.constData(), pathBytes.constData());
+    bga_buffer error{nullptr, 0};
+    const bga_buffer buffer = bga_project_analyze(project, &error);
 
-    if (result == nullptr) {
-        output.errorMessage = QStringLiteral("Rust analyzer returned null");
+    if (buffer.ptr == nullptr) {
+        output.errorMessage = error.ptr
+            ? QString::fromUtf8(reinterpret_cast<const char*>(error.ptr), static_cast<qsizetype>(error.len))
+            : QStringLiteral("Rust analyzer returned null");
+        bga_buffer_free(error);
         return output;
     }
 
-    output.payload = QByteArray(result);
-    bga_free_string(result);
+    // Wrap the Rust allocation instead of copying it; it is freed with the last output copy
+    output.payload = QByteArray::fromRawData(reinterpret_cast<const char*>(buffer.ptr),
+                                             static_cast<qsizetype>(buffer.len));
+    output.payloadOwner = std::shared_ptr<const void>(buffer.ptr, [buffer](const void*) {
+        bga_buffer_free(buffer);
+    });
 
     return output;
 }
 
+AnalysisStatus RustAnalyzerBridge::analyzeStream(const QString& inputPath, IAnalysisSink& sink, QString* errorMessage)
+{
+    bga_project* project = projectFor(inputPath);
+    if (!project) {
+        if (errorMessage) {
+            *errorMessage = QStringLiteral("Unknown engine: %1").arg(m_engine);
+        }
+        return AnalysisStatus::Failed;
+    }
+
+    StreamContext context;
+    context.sink = &sink;
+    const int result = bga_project_analyze_stream(project, &onStreamChunk, &context, &onStreamProgress);
+
+    if (result == 0) {
+        return AnalysisStatus::Finished;
+    }
+    if (result == 1) {
+        return AnalysisStatus::Cancelled;
+    }
+
+    if (errorMessage) {
+        *errorMessage = context.errorMessage.isEmpty()
+            ? QStringLiteral("Rust analyzer failed (code %1)").arg(result)
+            : context.errorMessage;
+    }
+    return AnalysisStatus::Failed;
+}
+
 bool RustAnalyzerBridge::save(const QString& outputPath, const QJsonArray& texts)
 {
     Q_UNUSED(outputPath);
@@ -40,9 +183,14 @@ bool RustAnalyzerBridge::save(const QString& outputPath, const QJsonArray& texts
     QJsonDocument doc(texts);
     QByteArray jsonBytes = doc.toJson(QJsonDocument::Compact);
 
-    QByteArray engineBytes = m_engine.toUtf8();
-
-    int result = bga_save(engineBytes.constData(), jsonBytes.constData());
+    // The project opened by the last analysis still holds the parsed documents
+    int result = 0;
+    if (m_project) {
+        result = bga_project_save(m_project, jsonBytes.constData());
+    } else {
+        QByteArray engineBytes = m_engine.toUtf8();
+        result = bga_save(engineBytes.constData(), jsonBytes.constData());
+    }
 
     return result == 0;
 }
@@ -0,0 +1,153 @@
+#include "core/documentcache.h"
+
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonObject>
+#include <QtCore/QMutexLocker>
+
+namespace core {
+
+namespace {
+
+// Per recorded literal: the key string and the hash node around the span
+constexpr qint64 kSpanCost = 64;
+// Per JSON value: the QtCbor::Element that holds it
+constexpr qint64 kElementCost = 16;
+// Per array or object: its QCborContainerPrivate and element list header
+constexpr qint64 kContainerCost = 64;
+
+qint64 valueCost(const QJsonValue &value)
+{
+    switch (value.type()) {
+    case QJsonValue::String:
+        return kElementCost + value.toString().size() * qint64(sizeof(QChar));
+    case QJsonValue::Array: {
+        qint64 bytes = kElementCost + kContainerCost;
+        for (const QJsonValue &item : value.toArray()) {
+            bytes += valueCost(item);
+        }
+        return bytes;
+    }
+    case QJsonValue::Object: {
+        const QJsonObject object = value.toObject();
+        qint64 bytes = kElementCost + kContainerCost;
+        for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+            bytes += kElementCost + it.key().size() * qint64(sizeof(QChar)) + valueCost(it.value());
+        }
+        return bytes;
+    }
+    default:
+        return kElementCost;
+    }
+}
+
+} // namespace
+
+void DocumentCache::setBudget(qint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_budget = qMax<qint64>(0, bytes);
+    evict();
+}
+
+qint64 DocumentCache::budget() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_budget;
+}
+
+bool DocumentCache::find(const QString &filePath, const QFileInfo &info, Entry *entry)
+{
+    QMutexLocker locker(&m_mutex);
+    const auto it = m_nodes.find(filePath);
+    if (it == m_nodes.end()) {
+        m_stats.misses++;
+        return false;
+    }
+    if (it->entry.size != info.size() || it->entry.lastModified != info.lastModified()) {
+        // Changed on disk since it was recorded
+        removeNode(it);
+        m_stats.misses++;
+        return false;
+    }
+
+    m_stats.hits++;
+    m_lru.splice(m_lru.end(), m_lru, it->lruPosition);
+    *entry = it->entry;
+    return true;
+}
+
+void DocumentCache::insert(const QString &filePath, const Entry &entry)
+{
+    // Walking the document is the expensive part, so it happens before taking the lock
+    const qint64 entryCost = cost(entry);
+
+    QMutexLocker locker(&m_mutex);
+    const auto previous = m_nodes.find(filePath);
+    if (previous != m_nodes.end()) {
+        removeNode(previous);
+    }
+    if (m_budget <= 0 || entryCost > m_budget) {
+        return;
+    }
+
+    Node node;
+    node.entry = entry;
+    node.cost = entryCost;
+    node.lruPosition = m_lru.insert(m_lru.end(), filePath);
+    m_nodes.insert(filePath, node);
+    m_stats.residentBytes += entryCost;
+    evict();
+}
+
+void DocumentCache::remove(const QString &filePath)
+{
+    QMutexLocker locker(&m_mutex);
+    const auto it = m_nodes.find(filePath);
+    if (it != m_nodes.end()) {
+        removeNode(it);
+    }
+}
+
+void DocumentCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_nodes.clear();
+    m_lru.clear();
+    m_stats.residentBytes = 0;
+}
+
+DocumentCache::Stats DocumentCache::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    Stats stats = m_stats;
+    stats.documents = m_nodes.size();
+    return stats;
+}
+
+qint64 DocumentCache::cost(const Entry &entry)
+{
+    qint64 bytes = entry.content.size() + entry.spans.size() * kSpanCost;
+    if (entry.document.isArray()) {
+        bytes += valueCost(entry.document.array());
+    } else if (entry.document.isObject()) {
+        bytes += valueCost(entry.document.object());
+    }
+    return bytes;
+}
+
+void DocumentCache::evict()
+{
+    while (m_stats.residentBytes > m_budget && !m_lru.empty()) {
+        removeNode(m_nodes.find(m_lru.front()));
+        m_stats.evictions++;
+    }
+}
+
+void DocumentCache::removeNode(QHash<QString, Node>::iterator it)
+{
+    m_stats.residentBytes -= it->cost;
+    m_lru.erase(it->lruPosition);
+    m_nodes.erase(it);
+}
+
+} // namespace core
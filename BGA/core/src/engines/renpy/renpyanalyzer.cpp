@@ -1,4 +1,5 @@
 #include "core/engines/renpy/renpyanalyzer.h"
+#include "core/mappedfile.h"
 #include <QFile>
 #include <QTextStream>
 #include <QJsonObject>
@@ -95,15 +96,26 @@ core::AnalyzerOutput RenpyAnalyzer::analyze(const QString &inputPath)
     static QRegularExpression menuPattern(R"(^\s*\"([^\"]+)\"\s*:)");
     
     for (const QFileInfo &fileInfo : files) {
-        QFile file(fileInfo.absoluteFilePath());
-        if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        core::MappedFile file(fileInfo.absoluteFilePath());
+        if (!file.isOpen())
             continue;
         
-        QTextStream in(&file);
+        // Lines are decoded one at a time straight from the mapped bytes. Like QTextStream, a
+        // UTF-8 byte order mark is skipped and "\n", "\r\n" and a lone "\r" all end a line.
+        const QByteArrayView content = file.data();
         int lineNumber = 0;
+        qsizetype lineStart = content.startsWith("\xEF\xBB\xBF") ? 3 : 0;
         
-        while (!in.atEnd()) {
-            QString line = in.readLine();
+        while (lineStart < content.size()) {
+            qsizetype lineEnd = lineStart;
+            while (lineEnd < content.size() && content[lineEnd] != '\n' && content[lineEnd] != '\r')
+                ++lineEnd;
+            const QByteArrayView lineBytes = content.sliced(lineStart, lineEnd - lineStart);
+            lineStart = lineEnd + 1;
+            if (lineEnd + 1 < content.size() && content[lineEnd] == '\r' && content[lineEnd + 1] == '\n')
+                ++lineStart;
+            
+            const QString line = QString::fromUtf8(lineBytes);
             lineNumber++;
             
             QRegularExpressionMatch match = dialogPattern.match(line);
@@ -122,7 +134,6 @@ core::AnalyzerOutput RenpyAnalyzer::analyze(const QString &inputPath)
                 }
             }
         }
-        file.close();
     }
     
     QJsonDocument doc(extractedStrings);
@@ -1,30 +1,178 @@
 #include "core/engines/rpgm/rpganalyzer.h"
-#include <QtCore/QDebug>
+#include "core/engines/rpgm/systemstringclassifier.h"
+#include "core/analysiscache.h"
+#include "core/analyzerpayload.h"
+#include "core/jsonpatchtree.h"
+#include "core/logger.h"
+#include "core/mappedfile.h"
 #include <QtCore/QDir>
 #include <QtCore/QFile>
-#include <QtCore/QTextStream>
 #include <QtCore/QFileInfoList>
 #include <QtCore/QJsonArray>
 #include <QtCore/QJsonDocument>
 #include <QtCore/QJsonObject>
-#include <QStandardPaths>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QSaveFile>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtCore/QSet>
+#include <QtCore/QThreadPool>
 #include <QOperatingSystemVersion>
-#include <QRegularExpression>
+
+#include <algorithm>
+#include <optional>
 
 namespace core { namespace engines { namespace rpgm {
 
+namespace {
+
+// "0 x120, 402 x3"
+QString formatEventCodeCounts(const QMap<int, int> &counts)
+{
+    QStringList parts;
+    for (auto it = counts.constBegin(); it != counts.constEnd(); ++it) {
+        parts.append(QStringLiteral("%1 x%2").arg(it.key()).arg(it.value()));
+    }
+    return parts.join(QStringLiteral(", "));
+}
+
+void appendEntry(QJsonArray &extractedStrings, const QString &text, const core::KeyPath &keyPath)
+{
+    // The dotted key is only built for strings that are actually emitted. The file path is
+    // stored once per file by the caller (schema 2).
+    QJsonObject entry;
+    entry.insert(QStringLiteral("source"), text);
+    entry.insert(QStringLiteral("key"), keyPath.toString());
+    extractedStrings.append(entry);
+}
+
+// Key of a merged message box: "1.list[3..5].parameters[0]" for lines 3 to 5 of `list`
+QString dialogueKey(const core::KeyPath &list, int first, int last)
+{
+    return list.toString() + QStringLiteral("[%1..%2].parameters[0]").arg(first).arg(last);
+}
+
+// Paths addressed by an entry key: one per line for a merged message box, otherwise the key itself
+QList<core::KeyPath> keyPaths(const QString &key, bool *ok)
+{
+    // Only the range dialogueKey() appends is expanded; any other ".." is left to KeyPath
+    static const QRegularExpression range(QStringLiteral("\\[(\\d+)\\.\\.(\\d+)\\](\\.parameters\\[0\\])$"));
+    const QRegularExpressionMatch match = range.match(key);
+    if (!match.hasMatch()) {
+        return {core::KeyPath::fromString(key, ok)};
+    }
+
+    bool firstOk = false;
+    bool lastOk = false;
+    const int first = match.capturedView(1).toInt(&firstOk);
+    const int last = match.capturedView(2).toInt(&lastOk);
+    *ok = firstOk && lastOk && first <= last;
+    if (!*ok) {
+        return {};
+    }
+
+    QList<core::KeyPath> paths;
+    paths.reserve(last - first + 1);
+    const QString prefix = key.left(match.capturedStart(0));
+    const QString suffix = match.captured(3);
+    for (int line = first; line <= last && *ok; ++line) {
+        paths.append(core::KeyPath::fromString(QStringLiteral("%1[%2]%3").arg(prefix).arg(line).arg(suffix), ok));
+    }
+    return *ok ? paths : QList<core::KeyPath>();
+}
+
+// Spreads a translated message box over its `lineCount` original lines. Missing lines become
+// empty; extra lines stay in the last one, where the game shows the "\n" as a line break.
+QStringList splitDialogue(const QString &text, qsizetype lineCount)
+{
+    QStringList lines = text.split(QLatin1Char('\n'));
+    if (lines.size() > lineCount) {
+        const QStringList overflow = lines.mid(lineCount - 1);
+        lines.resize(lineCount - 1);
+        lines.append(overflow.join(QLatin1Char('\n')));
+    }
+    while (lines.size() < lineCount) {
+        lines.append(QString());
+    }
+    return lines;
+}
+
+// Collects a streamed analysis back into the single payload of analyze()
+class CollectingSink : public core::IAnalysisSink {
+public:
+    void fontsFound(const QJsonArray &found) override { fonts = found; }
+
+    void entriesExtracted(const QString &filePath, const QJsonArray &entries) override
+    {
+        files.append({filePath, entries});
+    }
+
+    QJsonArray fonts;
+    QList<core::AnalyzerPayload::FileRecord> files;
+};
+
+} // namespace
+
 core::AnalyzerOutput RpgmAnalyzer::analyze(const QString &inputPath)
 {
-    QString logFilePath = QStandardPaths::writableLocation(QStandardPaths::TempLocation) + "/rpgm_analyzer_log.txt";
-    QFile logFile(logFilePath);
+    CollectingSink sink;
+    AnalysisTotals totals;
+    QString errorMessage;
+    if (analyzeFiles(inputPath, sink, totals, &errorMessage) == core::AnalysisStatus::Failed) {
+        core::AnalyzerOutput output;
+        output.errorMessage = errorMessage;
+        return output;
+    }
+
+    QJsonObject summary;
+    summary.insert(QStringLiteral("fonts"), sink.fonts);
+    summary.insert(QStringLiteral("engine"), QStringLiteral("rpgm"));
+    summary.insert(QStringLiteral("source"), inputPath);
+    summary.insert(QStringLiteral("filesProcessed"), totals.processed);
+    summary.insert(QStringLiteral("filesFailed"), totals.failed);
+    // Names, choices and system lines recur across maps: store each text once
+    core::StringPool pool;
+    const QJsonObject rootObject = core::AnalyzerPayload::makeResult(sink.files, summary, &pool);
 
-    // ตรวจสอบว่าเปิดไฟล์สำเร็จหรือไม่
-    if (!logFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
-        qWarning() << "Failed to open log file:" << logFilePath;
+    core::AnalyzerOutput output;
+    if (m_outputFormat == core::kCborPayloadFormat) {
+        output.format = m_outputFormat;
+        output.payload = core::AnalyzerPayload::encode(rootObject, output.format);
+    } else {
+        // Human-readable output for debugging and external tools
+        output.format = QStringLiteral("application/json");
+        output.payload = QJsonDocument(rootObject).toJson(QJsonDocument::Indented);
     }
 
-    QTextStream logStream(&logFile);
-    logStream << "RPGM Analyzer: Starting analysis for path: " << inputPath << "\n";
+    output.stringPool = pool.strings();
+
+    BGA_LOG_INFO("rpgm", QStringLiteral("Analysis complete. Payload size: %1 bytes, %2 unique texts")
+                             .arg(output.payload.size()).arg(pool.size()));
+
+    return output;
+}
+
+core::AnalysisStatus RpgmAnalyzer::analyzeStream(const QString &inputPath, core::IAnalysisSink &sink, QString *errorMessage)
+{
+    AnalysisTotals totals;
+    return analyzeFiles(inputPath, sink, totals, errorMessage);
+}
+
+core::AnalysisStatus RpgmAnalyzer::analyzeFiles(const QString &inputPath, core::IAnalysisSink &sink,
+                                                AnalysisTotals &totals, QString *errorMessage)
+{
+    BGA_LOG_INFO("rpgm", QStringLiteral("Starting analysis for path: %1").arg(inputPath));
+
+    auto fail = [errorMessage](const QString &message) {
+        BGA_LOG_WARNING("rpgm", message);
+        if (errorMessage) {
+            *errorMessage = message;
+        }
+        return core::AnalysisStatus::Failed;
+    };
+
+    if (!QFileInfo(inputPath).isDir()) {
+        return fail(QStringLiteral("Input path does not exist or is not a folder: %1").arg(inputPath));
+    }
 
     QDir projectDir(inputPath);
     QFileInfoList jsonFiles;
@@ -34,23 +182,23 @@ core::AnalyzerOutput RpgmAnalyzer::analyze(const QString &inputPath)
 
     if (isDataFolder) {
         // ถ้าชี้ไปที่ data folder โดยตรง
-        logStream << "RPGM Analyzer: Input path is data folder\n";
+        BGA_LOG_INFO("rpgm", QStringLiteral("Input path is data folder"));
         jsonFiles = projectDir.entryInfoList(QStringList{QStringLiteral("*.json")}, QDir::Files);
     } else {
         // ถ้าชี้ไปที่ project root ให้หาทั้ง root และ data folder
-        logStream << "RPGM Analyzer: Searching in project root\n";
+        BGA_LOG_INFO("rpgm", QStringLiteral("Searching in project root"));
 
         // ค้นหาในโฟลเดอร์ data (RPG Maker MV/MZ)
         QDir dataDir(projectDir.filePath("data"));
         if (dataDir.exists()) {
-            logStream << "RPGM Analyzer: Found 'data' folder\n";
+            BGA_LOG_INFO("rpgm", QStringLiteral("Found 'data' folder"));
             jsonFiles += dataDir.entryInfoList(QStringList{QStringLiteral("*.json")}, QDir::Files);
         }
 
         // ค้นหาในโฟลเดอร์ Data (case-insensitive)
         QDir dataDirAlt(projectDir.filePath("Data"));
         if (dataDirAlt.exists() && dataDirAlt.path() != dataDir.path()) {
-            logStream << "RPGM Analyzer: Found 'Data' folder\n";
+            BGA_LOG_INFO("rpgm", QStringLiteral("Found 'Data' folder"));
             jsonFiles += dataDirAlt.entryInfoList(QStringList{QStringLiteral("*.json")}, QDir::Files);
         }
 
@@ -74,12 +222,12 @@ core::AnalyzerOutput RpgmAnalyzer::analyze(const QString &inputPath)
         // ค้นหาใน js/plugins (สำหรับ RPG Maker MV/MZ)
         QDir pluginsDir(projectDir.filePath("js/plugins"));
         if (pluginsDir.exists()) {
-            logStream << "RPGM Analyzer: Found 'js/plugins' folder\n";
+            BGA_LOG_INFO("rpgm", QStringLiteral("Found 'js/plugins' folder"));
             jsonFiles += pluginsDir.entryInfoList(QStringList{QStringLiteral("*.json")}, QDir::Files);
         }
     }
 
-    logStream << "RPGM Analyzer: Found " << jsonFiles.size() << " JSON files.\n";
+    BGA_LOG_INFO("rpgm", QStringLiteral("Found %1 JSON files.").arg(jsonFiles.size()));
 
     // Font searching logic (แก้ไขให้ดีขึ้น)
     QDir parentDir;
@@ -97,7 +245,7 @@ core::AnalyzerOutput RpgmAnalyzer::analyze(const QString &inputPath)
 
     QJsonArray fontEntries;
     if (fontDir.exists()) {
-        logStream << "RPGM Analyzer: Found fonts folder at: " << fontDir.path() << "\n";
+        BGA_LOG_INFO("rpgm", QStringLiteral("Found fonts folder at: %1").arg(fontDir.path()));
         const QFileInfoList fontFiles = fontDir.entryInfoList(
             QStringList() << "*.ttf" << "*.otf" << "*.woff" << "*.woff2",
             QDir::Files
@@ -112,440 +260,529 @@ core::AnalyzerOutput RpgmAnalyzer::analyze(const QString &inputPath)
             fontEntry.insert(QStringLiteral("path"), fontFilePath);
             fontEntries.append(fontEntry);
         }
-        logStream << "RPGM Analyzer: Found " << fontFiles.size() << " font files.\n";
+        BGA_LOG_INFO("rpgm", QStringLiteral("Found %1 font files.").arg(fontFiles.size()));
     } else {
-        logStream << "RPGM Analyzer: No fonts folder found\n";
+        BGA_LOG_INFO("rpgm", QStringLiteral("No fonts folder found"));
     }
 
-    QJsonArray extractedStrings;
-    logStream << "RPGM Analyzer: Processing JSON files...\n";
+    sink.fontsFound(fontEntries);
 
-    int processedCount = 0;
-    int failedCount = 0;
+    BGA_LOG_INFO("rpgm", QStringLiteral("Processing JSON files..."));
 
+    // Skip package.json as it's usually not for translation
+    QFileInfoList filesToProcess;
     for (const QFileInfo &info : jsonFiles) {
-        qDebug() << "RpgmAnalyzer: Processing file:" << info.absoluteFilePath();
-        // Skip package.json as it's usually not for translation
         if (info.fileName().toLower() == "package.json") {
-            qDebug() << "RpgmAnalyzer: Skipping package.json";
+            BGA_LOG_DEBUG("rpgm", QStringLiteral("Skipping package.json"));
             continue;
         }
+        filesToProcess.append(info);
+    }
+    if (filesToProcess.isEmpty()) {
+        return fail(QStringLiteral("No RPG Maker data files found in %1").arg(inputPath));
+    }
 
-        QFile file(info.absoluteFilePath());
-        if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            QByteArray content = file.readAll();
-            file.close();
-
-            QJsonParseError parseError;
-            QJsonDocument doc = QJsonDocument::fromJson(content, &parseError);
-
-            if (!doc.isNull()) {
-                int prevCount = extractedStrings.size();
-                extractStringsFromJsonValue(
-                    QJsonValue::fromVariant(doc.toVariant()),
-                    extractedStrings,
-                    info.absoluteFilePath(),
-                    ""
-                    );
-                qDebug() << "RpgmAnalyzer: Processed" << info.fileName() << "Extracted" << (extractedStrings.size() - prevCount) << "strings.";
-                processedCount++;
-            } else {
-                logStream << "RPGM Analyzer: Failed to parse JSON from file: "
-                          << info.absoluteFilePath()
-                          << " Error: " << parseError.errorString() << "\n";
-                qWarning() << "RpgmAnalyzer: Failed to parse JSON from file:" << info.absoluteFilePath() << "Error:" << parseError.errorString();
+    // Files unchanged since the last run are taken from the manifest next to the workspace
+    std::optional<core::AnalysisCache> cache;
+    if (!m_cacheFile.isEmpty()) {
+        cache.emplace(m_cacheFile, cacheSignature());
+        if (cache->load()) {
+            BGA_LOG_INFO("rpgm", QStringLiteral("Loaded analysis cache with %1 files").arg(cache->size()));
+        }
+    }
+    const core::AnalysisCache *cacheView = cache ? &*cache : nullptr;
+    const bool keepResident = m_documents.isEnabled();
+
+    // One task per file on the global thread pool. Results are taken in input order while the
+    // workers run ahead, so the sink sees exactly the output of a serial run. Files are mapped
+    // in windows of a few per worker and a window is released before the next one starts, so
+    // only that many extracted files (and their resident copies) are held at any time.
+    const int window = qMax(1, QThreadPool::globalInstance()->maxThreadCount() * 2);
+    auto extract = [this, cacheView, keepResident](const QFileInfo &info) { return extractFile(info, cacheView, keepResident); };
+
+    core::AnalysisStatus status = core::AnalysisStatus::Finished;
+    const int fileCount = static_cast<int>(filesToProcess.size());
+    int processedCount = 0;
+    int failedCount = 0;
+    int cachedCount = 0;
+    qsizetype extractedCount = 0;
+    QMap<int, int> unknownEventCodes; // code -> occurrences over all files
+    QSet<QString> cachedPaths;
+    m_fileSpans.clear();
+    // A new analysis replaces whatever an earlier one left behind
+    m_documents.clear();
+
+    for (int windowStart = 0; windowStart < fileCount && status == core::AnalysisStatus::Finished; windowStart += window) {
+        const QFileInfoList batch = filesToProcess.mid(windowStart, window);
+        QFuture<FileExtraction> results = QtConcurrent::mapped(batch, extract);
+
+        for (int j = 0; j < batch.size(); ++j) {
+            const int i = windowStart + j;
+            if (sink.isCancelled()) {
+                results.cancel();
+                results.waitForFinished();
+                status = core::AnalysisStatus::Cancelled;
+                break;
+            }
+
+            const FileExtraction result = results.resultAt(j);
+            const QFileInfo &info = batch.at(j);
+            if (!result.parsed) {
+                BGA_LOG_WARNING("rpgm", QStringLiteral("%1: %2").arg(result.error, info.absoluteFilePath()));
                 failedCount++;
+                sink.progress(i + 1, fileCount);
+                continue;
             }
-        } else {
-            logStream << "RPGM Analyzer: Failed to open file for reading: "
-                      << info.absoluteFilePath() << "\n";
-            failedCount++;
+
+            if (cache) {
+                core::AnalysisCache::FileEntry fileEntry;
+                fileEntry.size = info.size();
+                fileEntry.lastModified = info.lastModified().toMSecsSinceEpoch();
+                fileEntry.contentHash = result.contentHash;
+                fileEntry.strings = result.strings;
+                cache->insert(info.absoluteFilePath(), fileEntry);
+                cachedPaths.insert(info.absoluteFilePath());
+            }
+            if (result.fromCache) {
+                cachedCount++;
+            }
+
+            if (!result.strings.isEmpty()) {
+                sink.entriesExtracted(info.absoluteFilePath(), result.strings);
+                extractedCount += result.strings.size();
+            }
+            for (auto code = result.unknownEventCodes.constBegin(); code != result.unknownEventCodes.constEnd(); ++code) {
+                unknownEventCodes[code.key()] += code.value();
+            }
+            if (result.resident.size >= 0) {
+                // Inserted in file order: together with the window above, the budget bounds
+                // what analysis keeps
+                m_documents.insert(info.absoluteFilePath(), result.resident);
+            } else if (result.spans.size >= 0) {
+                m_fileSpans.insert(info.absoluteFilePath(), result.spans);
+            }
+            processedCount++;
+            sink.progress(i + 1, fileCount);
         }
     }
 
-    logStream << "RPGM Analyzer: Processing complete.\n";
-    logStream << "  - Processed: " << processedCount << " files\n";
-    logStream << "  - Failed: " << failedCount << " files\n";
-    logStream << "  - Total extracted strings: " << extractedStrings.size() << "\n";
+    totals.processed = processedCount;
+    totals.failed = failedCount;
 
-    QJsonObject rootObject;
-    rootObject.insert(QStringLiteral("strings"), extractedStrings);
-    rootObject.insert(QStringLiteral("fonts"), fontEntries);
-    rootObject.insert(QStringLiteral("engine"), QStringLiteral("rpgm"));
-    rootObject.insert(QStringLiteral("source"), inputPath);
-    rootObject.insert(QStringLiteral("filesProcessed"), processedCount);
-    rootObject.insert(QStringLiteral("filesFailed"), failedCount);
+    if (status == core::AnalysisStatus::Cancelled) {
+        // The manifest is left as it was: files that were not reached must keep their entries
+        BGA_LOG_INFO("rpgm", QStringLiteral("Analysis cancelled after %1 of %2 files")
+                                 .arg(processedCount + failedCount).arg(fileCount));
+        return status;
+    }
 
-    QJsonDocument doc(rootObject);
+    if (failedCount == fileCount) {
+        // Nothing was extracted, so the manifest is left as it was
+        return fail(QStringLiteral("None of the %1 data files in %2 could be read").arg(fileCount).arg(inputPath));
+    }
 
-    core::AnalyzerOutput output;
-    output.format = QStringLiteral("application/json");
-    output.payload = doc.toJson(QJsonDocument::Indented);
+    BGA_LOG_INFO("rpgm", QStringLiteral("Processing complete. Processed: %1 files, failed: %2 files, "
+                                        "reused from cache: %3 files, extracted strings: %4")
+                             .arg(processedCount).arg(failedCount).arg(cachedCount).arg(extractedCount));
+    if (cache) {
+        cache->retain(cachedPaths);
+        cache->save();
+    }
+    if (!unknownEventCodes.isEmpty()) {
+        BGA_LOG_INFO("rpgm", QStringLiteral("Unknown event codes: %1").arg(formatEventCodeCounts(unknownEventCodes)));
+    }
 
-    logStream << "RPGM Analyzer: Analysis complete. Payload size: "
-              << output.payload.size() << " bytes\n";
-    logFile.close();
+    return status;
+}
 
-    return output;
+core::JsonSkipRules RpgmAnalyzer::defaultSkipRules()
+{
+    // Only purely numeric/structural data belongs here: skipping must never change what
+    // extractStringsFromJsonValue() would have found.
+    return {
+        {QStringLiteral("Map[0-9]*.json"), {"data", "encounterList"}},   // tile IDs, random encounters
+        {QStringLiteral("Animations.json"), {"frames", "timings"}},     // cell data, flash/SE timings
+        {QStringLiteral("Tilesets.json"), {"flags"}},                   // passability flags
+    };
 }
 
-bool RpgmAnalyzer::save(const QString &outputPath, const QJsonArray &texts)
+RpgmAnalyzer::FileExtraction RpgmAnalyzer::extractFile(const QFileInfo &info, const core::AnalysisCache *cache, bool keepResident)
 {
-    // จัดกลุ่มข้อมูลตาม file path เพื่อลด I/O operations
-    QMap<QString, QVector<QPair<QString, QString>>> fileUpdates; // filePath -> [(keyPath, newValue)]
+    // Runs on a worker thread: touch only locals, the (stateless) extraction helpers and the
+    // read-only cache.
+    FileExtraction result;
+
+    const core::AnalysisCache::FileEntry *cached = cache ? cache->find(info.absoluteFilePath()) : nullptr;
+    if (cached && core::AnalysisCache::matchesFingerprint(*cached, info)) {
+        result.strings = cached->strings;
+        result.contentHash = cached->contentHash;
+        result.parsed = true;
+        result.fromCache = true;
+        return result;
+    }
 
-    for (const QJsonValue &value : texts) {
-        QJsonObject textObject = value.toObject();
-        QString filePath = textObject["path"].toString();
-        QString keyPath = textObject["key"].toString();
-        QString translatedText = textObject["text"].toString();
+    BGA_LOG_DEBUG("rpgm", QStringLiteral("Processing file: %1").arg(info.absoluteFilePath()));
 
-        if (filePath.isEmpty() || keyPath.isEmpty()) {
-            qWarning() << "Invalid data for saving: filePath or keyPath is empty.";
-            continue;
+    // Parsed straight from the page cache; the only copies made are the stripped buffer, if any
+    core::MappedFile file(info.absoluteFilePath());
+    if (!file.isOpen()) {
+        result.error = QStringLiteral("Failed to open file for reading");
+        return result;
+    }
+
+    const QByteArray original = file.bytes();
+
+    if (cache) {
+        // Touched but not edited (e.g. re-extracted by a patcher): same entries as before
+        result.contentHash = core::AnalysisCache::hashContent(original);
+        if (cached && cached->contentHash == result.contentHash) {
+            result.strings = cached->strings;
+            result.parsed = true;
+            result.fromCache = true;
+            return result;
         }
+    }
 
-        fileUpdates[filePath].append(qMakePair(keyPath, translatedText));
+    QByteArray content = original;
+    bool wholeFile = true;
+
+    // Drop subtrees that can never hold text before the DOM is built for them
+    const QSet<QByteArray> skipKeys = m_skipMatcher.keysForFile(info.fileName());
+    if (!skipKeys.isEmpty()) {
+        qsizetype skippedBytes = 0;
+        const QByteArray stripped = core::JsonScanner::stripMembers(content, skipKeys, &skippedBytes);
+        if (!stripped.isNull()) {
+            BGA_LOG_TRACE("rpgm", QStringLiteral("Skipped %1 bytes of non-text data in %2").arg(skippedBytes).arg(info.fileName()));
+            content = stripped;
+            wholeFile = false;
+        }
     }
 
-    // อ่านและอัพเดทแต่ละไฟล์
-    QMap<QString, QJsonDocument> filesToUpdate;
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(content, &parseError);
 
-    for (auto it = fileUpdates.constBegin(); it != fileUpdates.constEnd(); ++it) {
-        const QString &filePath = it.key();
+    if (doc.isNull()) {
+        result.error = QStringLiteral("Failed to parse JSON from file (%1)").arg(parseError.errorString());
+        BGA_LOG_WARNING("rpgm", QStringLiteral("Failed to parse JSON from file: %1 (%2)")
+                                    .arg(info.absoluteFilePath(), parseError.errorString()));
+        return result;
+    }
 
-        QFile file(filePath);
-        if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-            qWarning() << "Failed to open file for reading:" << filePath;
-            return false;
+    result.strings = extractStrings(doc, info.absoluteFilePath(), &result.unknownEventCodes);
+    BGA_LOG_DEBUG("rpgm", QStringLiteral("Processed %1, extracted %2 strings").arg(info.fileName()).arg(result.strings.size()));
+    result.parsed = true;
+
+    if (m_saveMode == SaveMode::Patch && !result.strings.isEmpty()) {
+        // Remember where each literal sits in the original bytes so save() can splice directly
+        core::JsonPatchTree keys;
+        for (const QJsonValue &entry : std::as_const(result.strings)) {
+            bool ok = false;
+            const QString key = entry.toObject().value(QStringLiteral("key")).toString();
+            for (const core::KeyPath &path : keyPaths(key, &ok)) {
+                keys.insert(path, path.toString());
+            }
         }
+        QList<core::JsonSplice> spans;
+        if (keys.locate(original, &spans)) {
+            result.spans.size = info.size();
+            result.spans.lastModified = info.lastModified();
+            for (const core::JsonSplice &span : std::as_const(spans)) {
+                result.spans.spans.insert(span.value, span.span);
+            }
+        }
+    }
 
-        QJsonParseError parseError;
-        QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
-        file.close();
-
-        if (doc.isNull()) {
-            qWarning() << "Failed to parse JSON from file:" << filePath
-                       << "Error:" << parseError.errorString();
-            return false;
+    if (keepResident && original.size() <= m_documents.budget()) {
+        // Handed to the document cache so save() neither reads nor parses the file again. A
+        // file larger than the whole budget would be turned away, so it is not copied.
+        result.resident.size = info.size();
+        result.resident.lastModified = info.lastModified();
+        if (m_saveMode == SaveMode::Reserialize && wholeFile) {
+            // A document parsed without the skipped subtrees could not be written back
+            result.resident.document = doc;
+        } else {
+            result.resident.content = QByteArray(original.constData(), original.size()); // Detached from the mapping
+            result.resident.spans = result.spans.spans;
         }
+    }
+    return result;
+}
 
-        // อัพเดทค่าทั้งหมดสำหรับไฟล์นี้
-        for (const auto &update : it.value()) {
-            const QString &keyPath = update.first;
-            const QString &newValue = update.second;
+QJsonArray RpgmAnalyzer::extractStrings(const QJsonDocument &doc, const QString &filePath, QMap<int, int> *unknownEventCodes)
+{
+    // Walk the parsed document in place. The containers returned by array()/object() share
+    // the document's storage, so no intermediate QVariant tree is built.
+    QJsonArray extractedStrings;
+    const QJsonValue root = doc.isArray() ? QJsonValue(doc.array()) : QJsonValue(doc.object());
+    core::KeyPath keyPath;
+    QMap<int, int> unknownCodes;
+    extractStringsFromJsonValue(root, extractedStrings, keyPath, unknownCodes);
+
+    if (unknownEventCodes) {
+        *unknownEventCodes = unknownCodes;
+    } else if (!unknownCodes.isEmpty()) {
+        BGA_LOG_DEBUG("rpgm", QStringLiteral("Unknown event codes in %1: %2").arg(filePath, formatEventCodeCounts(unknownCodes)));
+    }
+    return extractedStrings;
+}
 
-            if (!updateJsonValue(doc, keyPath, newValue)) {
-                qWarning() << "Failed to update value at keyPath:" << keyPath
-                           << "in file:" << filePath;
-            }
+QString RpgmAnalyzer::cacheSignature() const
+{
+    // Bump the version whenever the extraction rules change what ends up in the entries
+    QString signature = QStringLiteral("rpgm-cpp/3");
+    if (m_mergeDialogue) {
+        signature += QStringLiteral(";merge-dialogue");
+    }
+    QList<int> codes = m_eventCommandOverrides.keys();
+    std::sort(codes.begin(), codes.end());
+    for (const int code : std::as_const(codes)) {
+        const EventCommandRule &rule = m_eventCommandOverrides[code];
+        signature += QStringLiteral(";%1:%2:%3:%4").arg(code).arg(static_cast<int>(rule.text))
+                         .arg(rule.textParameter).arg(rule.skipParameters ? 1 : 0);
+    }
+    // Skipped subtrees are never searched for text, so other rules can mean other entries
+    QStringList skipRules;
+    for (const core::JsonSkipRule &rule : std::as_const(m_skipRules)) {
+        QStringList keys;
+        for (const QByteArray &key : rule.keys) {
+            keys.append(QString::fromUtf8(key));
         }
-
-        filesToUpdate.insert(filePath, doc);
+        keys.sort();
+        skipRules.append(QStringLiteral("%1=%2").arg(rule.filePattern.toLower(), keys.join(QLatin1Char(','))));
     }
+    skipRules.sort();
+    signature += QStringLiteral(";skip:") + skipRules.join(QLatin1Char('|'));
+    return signature;
+}
 
-    // เขียนกลับไปยังไฟล์ทั้งหมด (transaction-like approach)
-    for (auto it = filesToUpdate.constBegin(); it != filesToUpdate.constEnd(); ++it) {
-        const QString &filePath = it.key();
-        const QJsonDocument &doc = it.value();
+void RpgmAnalyzer::setEventCommandRule(const EventCommandRule &rule)
+{
+    m_eventCommandOverrides.insert(rule.code, rule);
+}
 
-        // สร้าง backup ก่อน (optional)
-        QString backupPath = filePath + ".backup";
-        QFile::remove(backupPath); // ลบ backup เก่าถ้ามี
-        QFile::copy(filePath, backupPath);
+void RpgmAnalyzer::resetEventCommandRules()
+{
+    m_eventCommandOverrides.clear();
+}
 
-        QFile file(filePath);
-        if (!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
-            qWarning() << "Failed to open file for writing:" << filePath;
-            // พยายาม restore จาก backup
-            QFile::remove(filePath);
-            QFile::copy(backupPath, filePath);
-            return false;
+const EventCommandRule *RpgmAnalyzer::eventCommandRule(int code) const
+{
+    if (!m_eventCommandOverrides.isEmpty()) {
+        const auto it = m_eventCommandOverrides.constFind(code);
+        if (it != m_eventCommandOverrides.constEnd()) {
+            return &it.value();
         }
+    }
+    return findEventCommandRule(code);
+}
+
+bool RpgmAnalyzer::save(const QString &outputPath, const QJsonArray &texts)
+{
+    // จัดกลุ่มข้อมูลตาม file path เพื่อลด I/O operations
+    QMap<QString, FileUpdates> fileUpdates; // filePath -> pending (keyPath, newValue) updates
+
+    for (const QJsonValue &value : texts) {
+        QJsonObject textObject = value.toObject();
+        QString filePath = textObject["path"].toString();
+        QString keyPath = textObject["key"].toString();
+        QString translatedText = textObject["text"].toString();
 
-        QByteArray jsonData = doc.toJson(QJsonDocument::Indented);
-        if (file.write(jsonData) != jsonData.size()) {
-            qWarning() << "Failed to write complete data to file:" << filePath;
-            file.close();
-            // พยายาม restore จาก backup
-            QFile::remove(filePath);
-            QFile::copy(backupPath, filePath);
-            return false;
+        if (filePath.isEmpty() || keyPath.isEmpty()) {
+            BGA_LOG_WARNING("rpgm", QStringLiteral("Invalid data for saving: filePath or keyPath is empty."));
+            continue;
         }
 
-        file.close();
+        bool ok = false;
+        const QList<core::KeyPath> paths = keyPaths(keyPath, &ok);
+        if (!ok) {
+            BGA_LOG_WARNING("rpgm", QStringLiteral("Failed to update value at keyPath: %1 in file: %2").arg(keyPath, filePath));
+            continue;
+        }
 
-        // ลบ backup เมื่อสำเร็จ
-        QFile::remove(backupPath);
+        // A merged message box is written back line by line
+        const QStringList lines = paths.size() > 1 ? splitDialogue(translatedText, paths.size())
+                                                   : QStringList{translatedText};
+        FileUpdates &updates = fileUpdates[filePath];
+        for (qsizetype i = 0; i < paths.size(); ++i) {
+            updates.tree.insert(paths.at(i), lines.at(i));
+            updates.values.insert(paths.at(i).toString(), lines.at(i));
+        }
     }
 
-    return true;
-}
-
-bool RpgmAnalyzer::updateJsonValue(QJsonDocument &doc, const QString &keyPath, const QString &newValue)
-{
-    QStringList keys = keyPath.split('.');
+    // อ่าน อัพเดท และเขียนแต่ละไฟล์
+    // Files are independent, so each one is patched and written on the global thread pool.
+    // A failing file does not stop the others; errors are reported together afterwards.
+    const QStringList filePaths = fileUpdates.keys();
+    const QList<FileSave> results = QtConcurrent::blockingMapped(
+        filePaths,
+        [this, &fileUpdates](const QString &filePath) { return saveFile(filePath, fileUpdates.constFind(filePath).value()); });
 
-    if (doc.isObject()) {
-        QJsonObject obj = doc.object();
-        if (updateJsonObject(obj, keys, 0, newValue)) {
-            doc.setObject(obj);
-            return true;
+    int failedCount = 0;
+    for (const FileSave &result : results) {
+        if (!result.unresolved.isEmpty()) {
+            BGA_LOG_WARNING("rpgm", QStringLiteral("%1 key paths not found in %2, first: %3")
+                                        .arg(result.unresolved.size())
+                                        .arg(result.filePath, result.unresolved.constFirst().toString()));
         }
-    } else if (doc.isArray()) {
-        QJsonArray arr = doc.array();
-        if (updateJsonArray(arr, keys, 0, newValue)) {
-            doc.setArray(arr);
-            return true;
+        if (!result.error.isEmpty()) {
+            BGA_LOG_WARNING("rpgm", QStringLiteral("%1: %2").arg(result.error, result.filePath));
+            failedCount++;
+            continue;
         }
+        // The recorded offsets describe the old contents
+        m_fileSpans.remove(result.filePath);
     }
 
-    return false;
+    if (m_documents.isEnabled()) {
+        const core::DocumentCache::Stats stats = m_documents.stats();
+        BGA_LOG_DEBUG("rpgm", QStringLiteral("Document cache: %1 documents, %2 bytes, %3 hits, %4 misses, %5 evictions")
+                                  .arg(stats.documents).arg(stats.residentBytes).arg(stats.hits)
+                                  .arg(stats.misses).arg(stats.evictions));
+    }
+
+    if (failedCount > 0) {
+        BGA_LOG_WARNING("rpgm", QStringLiteral("Save failed for %1 of %2 files").arg(failedCount).arg(results.size()));
+        return false;
+    }
+    return true;
 }
 
-bool RpgmAnalyzer::updateJsonObject(QJsonObject &obj, const QStringList &keys, int index, const QString &newValue)
+RpgmAnalyzer::FileSave RpgmAnalyzer::saveFile(const QString &filePath, const FileUpdates &updates)
 {
-    if (index >= keys.size()) return false;
-
-    QString currentKey = keys[index];
-
-    // Check if key contains array notation [n] (possibly multiple like [0][0])
-    if (currentKey.contains('[')) {
-        int bracketPos = currentKey.indexOf('[');
-        QString baseKey = currentKey.left(bracketPos);
-        
-        // Extract all array indices from the key (e.g., "parameters[0][0]" -> [0, 0])
-        QList<int> arrayIndices;
-        QString remaining = currentKey.mid(bracketPos);
-        QRegularExpression re("\\[(\\d+)\\]");
-        QRegularExpressionMatchIterator it = re.globalMatch(remaining);
-        while (it.hasNext()) {
-            QRegularExpressionMatch match = it.next();
-            arrayIndices.append(match.captured(1).toInt());
-        }
-        
-        if (arrayIndices.isEmpty()) return false;
-        if (!obj.contains(baseKey)) return false;
-        
-        // Navigate through the nested arrays
-        QJsonValue currentVal = obj[baseKey];
-        QList<QPair<QJsonArray, int>> pathStack; // Stack to track path for reconstruction
-        
-        for (int i = 0; i < arrayIndices.size(); ++i) {
-            int idx = arrayIndices[i];
-            
-            if (!currentVal.isArray()) return false;
-            QJsonArray arr = currentVal.toArray();
-            if (idx < 0 || idx >= arr.size()) return false;
-            
-            pathStack.append(qMakePair(arr, idx));
-            currentVal = arr[idx];
-        }
-        
-        // Now currentVal is the value we need to update or navigate into
-        if (index == keys.size() - 1) {
-            // This is the last key, replace the value
-            // Reconstruct the path backwards
-            QJsonValue newVal = QJsonValue(newValue);
-            for (int i = pathStack.size() - 1; i >= 0; --i) {
-                QJsonArray arr = pathStack[i].first;
-                int idx = pathStack[i].second;
-                arr.replace(idx, newVal);
-                newVal = arr;
+    // Runs on a worker thread: m_fileSpans is only read, m_documents is thread-safe
+    FileSave result;
+    result.filePath = filePath;
+
+    const QFileInfo info(filePath);
+    core::DocumentCache::Entry resident;
+    const bool isResident = m_documents.isEnabled() && m_documents.find(filePath, info, &resident);
+
+    QByteArray data;
+    bool textMode = false; // Re-serialized documents are written with platform line endings
+    QJsonDocument written;
+    {
+        // Released before the file is replaced
+        core::MappedFile file;
+        // A resident document is enough when the file has to be re-serialized anyway
+        QByteArray content = resident.content;
+        if (content.isNull() && resident.document.isNull()) {
+            if (!file.open(filePath)) {
+                result.error = QStringLiteral("Failed to open file for reading (%1)").arg(file.errorString());
+                return result;
             }
-            obj[baseKey] = newVal.toArray();
-            return true;
-        } else {
-            // Navigate into the element
-            if (currentVal.isObject()) {
-                QJsonObject elementObj = currentVal.toObject();
-                if (updateJsonObject(elementObj, keys, index + 1, newValue)) {
-                    // Reconstruct the path backwards
-                    QJsonValue newVal = elementObj;
-                    for (int i = pathStack.size() - 1; i >= 0; --i) {
-                        QJsonArray arr = pathStack[i].first;
-                        int idx = pathStack[i].second;
-                        arr.replace(idx, newVal);
-                        newVal = arr;
-                    }
-                    obj[baseKey] = newVal.toArray();
-                    return true;
-                }
-            } else if (currentVal.isArray()) {
-                QJsonArray elementArr = currentVal.toArray();
-                if (updateJsonArray(elementArr, keys, index + 1, newValue)) {
-                    // Reconstruct the path backwards
-                    QJsonValue newVal = elementArr;
-                    for (int i = pathStack.size() - 1; i >= 0; --i) {
-                        QJsonArray arr = pathStack[i].first;
-                        int idx = pathStack[i].second;
-                        arr.replace(idx, newVal);
-                        newVal = arr;
-                    }
-                    obj[baseKey] = newVal.toArray();
-                    return true;
+            content = file.bytes();
+        }
+
+        if (m_saveMode == SaveMode::Patch && !content.isNull()) {
+            // Spans recorded by analyze() are used as they are while the file is the one that was analyzed
+            const QHash<QString, core::JsonSpan> *recorded = nullptr;
+            if (isResident) {
+                recorded = &resident.spans;
+            } else {
+                const auto spans = m_fileSpans.constFind(filePath);
+                if (spans != m_fileSpans.constEnd() && info.size() == spans->size && info.lastModified() == spans->lastModified) {
+                    recorded = &spans->spans;
                 }
             }
+            data = patchFile(filePath, content, updates.tree, updates.values, recorded, &result.unresolved);
         }
-    } else {
-        if (!obj.contains(currentKey)) return false;
 
-        if (index == keys.size() - 1) {
-            obj[currentKey] = newValue;
-            return true;
-        } else {
-            QJsonValue value = obj[currentKey];
-            if (value.isObject()) {
-                QJsonObject nestedObj = value.toObject();
-                if (updateJsonObject(nestedObj, keys, index + 1, newValue)) {
-                    obj[currentKey] = nestedObj;
-                    return true;
-                }
-            } else if (value.isArray()) {
-                QJsonArray nestedArr = value.toArray();
-                if (updateJsonArray(nestedArr, keys, index + 1, newValue)) {
-                    obj[currentKey] = nestedArr;
-                    return true;
+        if (data.isNull()) {
+            // Re-serialize when patching is off or the file could not be patched in place
+            QJsonDocument doc = resident.document;
+            if (doc.isNull()) {
+                QJsonParseError parseError;
+                doc = QJsonDocument::fromJson(content, &parseError);
+                if (doc.isNull()) {
+                    result.error = QStringLiteral("Failed to parse JSON (%1)").arg(parseError.errorString());
+                    return result;
                 }
             }
+
+            // อัพเดทค่าทั้งหมดสำหรับไฟล์นี้
+            // All updates share one traversal, so each container on the way is copied at most once
+            result.unresolved.clear();
+            updates.tree.apply(doc, &result.unresolved);
+            data = doc.toJson(QJsonDocument::Indented);
+            textMode = true;
+            written = doc;
         }
     }
 
-    return false;
+    // เขียนไฟล์ชั่วคราวแล้ว rename ทับของเดิม: the original stays intact until commit() succeeds
+    QSaveFile file(filePath);
+    QIODevice::OpenMode mode = QIODevice::WriteOnly;
+    if (textMode) {
+        mode |= QIODevice::Text;
+    }
+    if (!file.open(mode)) {
+        result.error = QStringLiteral("Failed to open file for writing (%1)").arg(file.errorString());
+        return result;
+    }
+    if (file.write(data) != data.size() || !file.commit()) {
+        result.error = QStringLiteral("Failed to write file (%1)").arg(file.errorString());
+        return result;
+    }
+
+    if (m_documents.isEnabled()) {
+        // What was just written becomes the resident copy. The old offsets and parse no longer
+        // apply; a later patch locates the literals in the resident bytes instead.
+        const QFileInfo writtenInfo(filePath);
+        core::DocumentCache::Entry entry;
+        entry.size = writtenInfo.size();
+        entry.lastModified = writtenInfo.lastModified();
+        if (textMode) {
+            // The bytes on disk may differ from `data` by their line endings
+            entry.document = written;
+        } else {
+            entry.content = data;
+        }
+        m_documents.insert(filePath, entry);
+    }
+    return result;
 }
 
-bool RpgmAnalyzer::updateJsonArray(QJsonArray &arr, const QStringList &keys, int index, const QString &newValue)
+QByteArray RpgmAnalyzer::patchFile(const QString &filePath, const QByteArray &content, const core::JsonPatchTree &updates,
+                                   const QHash<QString, QString> &values, const QHash<QString, core::JsonSpan> *recorded,
+                                   QList<core::KeyPath> *unresolved) const
 {
-    if (index >= keys.size()) return false;
-
-    QString currentKey = keys[index];
-
-    // Check if it's an array index (possibly multiple like [0][0])
-    if (currentKey.contains('[')) {
-        // Extract all array indices from the key
-        QList<int> arrayIndices;
-        QRegularExpression re("\\[(\\d+)\\]");
-        QRegularExpressionMatchIterator it = re.globalMatch(currentKey);
-        while (it.hasNext()) {
-            QRegularExpressionMatch match = it.next();
-            arrayIndices.append(match.captured(1).toInt());
-        }
-        
-        if (arrayIndices.isEmpty()) return false;
-        
-        // Navigate through the nested arrays
-        QJsonValue currentVal = arr[arrayIndices[0]];
-        if (arrayIndices[0] < 0 || arrayIndices[0] >= arr.size()) return false;
-        
-        QList<QPair<QJsonArray, int>> pathStack;
-        pathStack.append(qMakePair(arr, arrayIndices[0]));
-        
-        for (int i = 1; i < arrayIndices.size(); ++i) {
-            int idx = arrayIndices[i];
-            
-            if (!currentVal.isArray()) return false;
-            QJsonArray nestedArr = currentVal.toArray();
-            if (idx < 0 || idx >= nestedArr.size()) return false;
-            
-            pathStack.append(qMakePair(nestedArr, idx));
-            currentVal = nestedArr[idx];
-        }
-        
-        if (index == keys.size() - 1) {
-            // This is the last key, replace the value
-            QJsonValue newVal = QJsonValue(newValue);
-            for (int i = pathStack.size() - 1; i >= 0; --i) {
-                QJsonArray stackArr = pathStack[i].first;
-                int idx = pathStack[i].second;
-                stackArr.replace(idx, newVal);
-                newVal = stackArr;
-            }
-            // Copy back to arr (first level)
-            QJsonArray resultArr = newVal.toArray();
-            for (int i = 0; i < resultArr.size(); ++i) {
-                arr.replace(i, resultArr[i]);
-            }
-            return true;
-        } else {
-            QJsonValue value = currentVal;
-            if (value.isObject()) {
-                QJsonObject obj = value.toObject();
-                if (updateJsonObject(obj, keys, index + 1, newValue)) {
-                    QJsonValue newVal = obj;
-                    for (int i = pathStack.size() - 1; i >= 0; --i) {
-                        QJsonArray stackArr = pathStack[i].first;
-                        int idx = pathStack[i].second;
-                        stackArr.replace(idx, newVal);
-                        newVal = stackArr;
-                    }
-                    QJsonArray resultArr = newVal.toArray();
-                    for (int i = 0; i < resultArr.size(); ++i) {
-                        arr.replace(i, resultArr[i]);
-                    }
-                    return true;
-                }
-            } else if (value.isArray()) {
-                QJsonArray nestedArr = value.toArray();
-                if (updateJsonArray(nestedArr, keys, index + 1, newValue)) {
-                    QJsonValue newVal = nestedArr;
-                    for (int i = pathStack.size() - 1; i >= 0; --i) {
-                        QJsonArray stackArr = pathStack[i].first;
-                        int idx = pathStack[i].second;
-                        stackArr.replace(idx, newVal);
-                        newVal = stackArr;
-                    }
-                    QJsonArray resultArr = newVal.toArray();
-                    for (int i = 0; i < resultArr.size(); ++i) {
-                        arr.replace(i, resultArr[i]);
-                    }
-                    return true;
-                }
+    if (recorded && !recorded->isEmpty()) {
+        QList<core::JsonSplice> splices;
+        splices.reserve(values.size());
+        for (auto it = values.constBegin(); it != values.constEnd(); ++it) {
+            const auto span = recorded->constFind(it.key());
+            if (span == recorded->constEnd() || span->offset >= content.size() || content.at(span->offset) != '"') {
+                break;
             }
+            splices.append(core::JsonSplice{span.value(), it.value()});
         }
-    } else {
-        bool ok;
-        int arrayIndex = currentKey.toInt(&ok);
-
-        if (ok && arrayIndex >= 0 && arrayIndex < arr.size()) {
-            if (index == keys.size() - 1) {
-                arr.replace(arrayIndex, newValue);
-                return true;
-            } else {
-                QJsonValue value = arr[arrayIndex];
-                if (value.isObject()) {
-                    QJsonObject obj = value.toObject();
-                    if (updateJsonObject(obj, keys, index + 1, newValue)) {
-                        arr.replace(arrayIndex, obj);
-                        return true;
-                    }
-                } else if (value.isArray()) {
-                    QJsonArray nestedArr = value.toArray();
-                    if (updateJsonArray(nestedArr, keys, index + 1, newValue)) {
-                        arr.replace(arrayIndex, nestedArr);
-                        return true;
-                    }
-                }
+        if (splices.size() == values.size()) {
+            const QByteArray patched = core::JsonScanner::applySplices(content, splices);
+            if (!patched.isNull()) {
+                return patched;
             }
         }
     }
 
-    return false;
+    // Otherwise find the literals with one raw-byte walk guided by the pending paths
+    QList<core::JsonSplice> splices;
+    if (!updates.locate(content, &splices, unresolved)) {
+        BGA_LOG_DEBUG("rpgm", QStringLiteral("Cannot patch %1 in place, re-serializing").arg(filePath));
+        return QByteArray();
+    }
+    return core::JsonScanner::applySplices(content, splices);
 }
 
-void RpgmAnalyzer::extractStringsFromJsonValue(const QJsonValue &jsonValue, QJsonArray &extractedStrings, const QString &filePath, const QString &currentKeyPath)
+void RpgmAnalyzer::extractStringsFromJsonValue(const QJsonValue &jsonValue, QJsonArray &extractedStrings, core::KeyPath &keyPath, QMap<int, int> &unknownEventCodes) const
 {
     if (jsonValue.isString()) {
         QString text = jsonValue.toString();
         
         if (!text.isEmpty() && !isSystemString(text)) {
-            QJsonObject entry;
-            entry.insert(QStringLiteral("source"), text);
-            entry.insert(QStringLiteral("path"), filePath);
-            entry.insert(QStringLiteral("key"), currentKeyPath);
-            extractedStrings.append(entry);
+            appendEntry(extractedStrings, text, keyPath);
         }
     } else if (jsonValue.isObject()) {
-        QJsonObject obj = jsonValue.toObject();
+        const QJsonObject obj = jsonValue.toObject();
 
         // Check for Audio Object structure (name, volume, pitch, pan) and skip
         if (obj.contains("name") && obj.contains("volume") && obj.contains("pitch") && obj.contains("pan")) {
@@ -557,241 +794,53 @@ void RpgmAnalyzer::extractStringsFromJsonValue(const QJsonValue &jsonValue, QJso
         // ===== Rule 1: Event Command Handling (Complete) =====
         if (obj.contains("code") && obj.contains("parameters") && obj["parameters"].isArray()) {
             int code = obj["code"].toInt();
-            QJsonArray params = obj["parameters"].toArray();
+            const QJsonArray params = obj["parameters"].toArray();
             
             bool extractedFromCommand = false;
+            static const QString parametersKey = QStringLiteral("parameters");
 
-            switch (code) {
-                // === Text Display Commands ===
-                case 101: // Show Text: Character Name/Face Setup
-                    // parameters[4] = actor name (TRANSLATABLE!)
-                    if (params.size() > 4 && params[4].isString()) {
-                        QString actorName = params[4].toString();
-                        QString newKeyPath = currentKeyPath.isEmpty() ? "parameters[4]" : currentKeyPath + ".parameters[4]";
-                        
-                        if (!actorName.isEmpty() && !isSystemString(actorName)) {
-                            QJsonObject entry;
-                            entry.insert(QStringLiteral("source"), actorName);
-                            entry.insert(QStringLiteral("path"), filePath);
-                            entry.insert(QStringLiteral("key"), newKeyPath);
-                            extractedStrings.append(entry);
-                            extractedFromCommand = true;
-                        }
-                    }
-                    break;
-                    
-                case 401: // Show Text: Dialogue Line
-                    if (params.size() > 0 && params[0].isString()) {
-                        QString text = params[0].toString();
-                        QString newKeyPath = currentKeyPath.isEmpty() ? "parameters[0]" : currentKeyPath + ".parameters[0]";
-                        
-                        if (!text.isEmpty() && !isSystemString(text)) {
-                            QJsonObject entry;
-                            entry.insert(QStringLiteral("source"), text);
-                            entry.insert(QStringLiteral("path"), filePath);
-                            entry.insert(QStringLiteral("key"), newKeyPath);
-                            extractedStrings.append(entry);
-                            extractedFromCommand = true;
-                        }
-                    }
-                    break;
-                
-                case 102: // Show Choices
-                    // parameters[0] = array of choice texts
-                    if (params.size() > 0 && params[0].isArray()) {
-                        QJsonArray choices = params[0].toArray();
-                        for (int i = 0; i < choices.size(); ++i) {
-                            if (choices[i].isString()) {
-                                QString choiceText = choices[i].toString();
-                                QString newKeyPath = currentKeyPath.isEmpty() 
-                                    ? QString("parameters[0][%1]").arg(i)
-                                    : QString("%1.parameters[0][%2]").arg(currentKeyPath).arg(i);
-                                
-                                if (!choiceText.isEmpty() && !isSystemString(choiceText)) {
-                                    QJsonObject entry;
-                                    entry.insert(QStringLiteral("source"), choiceText);
-                                    entry.insert(QStringLiteral("path"), filePath);
-                                    entry.insert(QStringLiteral("key"), newKeyPath);
-                                    extractedStrings.append(entry);
-                                }
-                            }
-                        }
-                        extractedFromCommand = true;
-                    }
-                    break;
-                
-                case 103: // Input Number
-                    // No translatable text
-                    break;
-                
-                case 104: // Select Item
-                    // parameters[1] = item type (system value)
-                    break;
-                
-                case 105: // Show Scrolling Text
-                    // Similar to 401 but for scrolling
-                    if (params.size() > 0 && params[0].isString()) {
-                        QString text = params[0].toString();
-                        QString newKeyPath = currentKeyPath.isEmpty() ? "parameters[0]" : currentKeyPath + ".parameters[0]";
-                        
-                        if (!text.isEmpty() && !isSystemString(text)) {
-                            QJsonObject entry;
-                            entry.insert(QStringLiteral("source"), text);
-                            entry.insert(QStringLiteral("path"), filePath);
-                            entry.insert(QStringLiteral("key"), newKeyPath);
-                            extractedStrings.append(entry);
-                            extractedFromCommand = true;
-                        }
-                    }
-                    break;
-                
-                case 405: // Show Scrolling Text continuation
-                    if (params.size() > 0 && params[0].isString()) {
-                        QString text = params[0].toString();
-                        QString newKeyPath = currentKeyPath.isEmpty() ? "parameters[0]" : currentKeyPath + ".parameters[0]";
-                        
-                        if (!text.isEmpty() && !isSystemString(text)) {
-                            QJsonObject entry;
-                            entry.insert(QStringLiteral("source"), text);
-                            entry.insert(QStringLiteral("path"), filePath);
-                            entry.insert(QStringLiteral("key"), newKeyPath);
-                            extractedStrings.append(entry);
-                            extractedFromCommand = true;
-                        }
+            // Emits one string element of the parameters when it holds translatable text
+            auto extractText = [&](const QJsonValue &value) {
+                if (!value.isString()) {
+                    return false;
+                }
+                const QString text = value.toString();
+                if (text.isEmpty() || isSystemString(text)) {
+                    return false;
+                }
+                appendEntry(extractedStrings, text, keyPath);
+                return true;
+            };
+
+            const EventCommandRule *rule = eventCommandRule(code);
+            if (!rule) {
+                // Unknown command - counted and reported once per file, parameters walked below
+                ++unknownEventCodes[code];
+            } else if (rule->skipParameters) {
+                extractedFromCommand = true;
+            } else if (rule->textParameter >= 0 && rule->textParameter < params.size()) {
+                const QJsonValue value = params.at(rule->textParameter);
+                keyPath.pushKey(parametersKey);
+                keyPath.pushIndex(rule->textParameter);
+                if (rule->text == EventParameterText::String) {
+                    extractedFromCommand = extractText(value);
+                } else if (rule->text == EventParameterText::ChoiceList && value.isArray()) {
+                    const QJsonArray choices = value.toArray();
+                    for (int i = 0; i < choices.size(); ++i) {
+                        keyPath.pushIndex(i);
+                        extractText(choices.at(i));
+                        keyPath.pop();
                     }
-                    break;
-                
-                // === System Commands (Usually No Translation) ===
-                case 108: // Comment
-                case 408: // Comment continuation
-                    // Developer comments - usually skip, but could add option to extract
-                    extractedFromCommand = true; // Fix: Prevent recursion
-                    break;
-                
-                case 111: // Conditional Branch
-                case 112: // Loop
-                case 113: // Break Loop
-                case 115: // Exit Event Processing
-                case 117: // Common Event
-                case 118: // Label
-                case 119: // Jump to Label
-                case 121: // Control Switches
-                case 122: // Control Variables
-                case 123: // Control Self Switch
-                case 124: // Control Timer
-                    // Pure logic - no translatable content
                     extractedFromCommand = true;
-                    break;
-                
-                // === Game Progression Commands ===
-                case 125: // Change Gold
-                case 126: // Change Items
-                case 127: // Change Weapons
-                case 128: // Change Armors
-                case 129: // Change Party Member
-                    // System commands - no text
-                    extractedFromCommand = true;
-                    break;
-                
-                // === Screen Commands ===
-                case 201: // Transfer Player
-                case 202: // Set Vehicle Location
-                case 203: // Set Event Location
-                case 204: // Scroll Map
-                case 205: // Set Movement Route
-                    // Map/movement commands - no text
-                    extractedFromCommand = true;
-                    break;
-                
-                case 231: // Show Picture
-                    // parameters[1] = picture name (filename - skip)
-                    extractedFromCommand = true; // Fix: Prevent recursion so "PictureZIndex" isn't extracted
-                    break;
-                
-                case 241: // Play BGM
-                case 242: // Fadeout BGM
-                case 245: // Play BGS
-                case 246: // Fadeout BGS
-                case 249: // Play ME
-                case 250: // Play SE
-                    // Audio commands - filenames only (parameters contain {name, volume, pitch, pan})
-                    // Mark as handled to prevent recursing into parameters which would incorrectly extract 'name'
-                    extractedFromCommand = true;
-                    break;
-                
-                // === Battle Commands ===
-                case 301: // Battle Processing
-                case 311: // Change HP
-                case 312: // Change MP
-                case 313: // Change State
-                case 314: // Recover All
-                case 339: // Force Action
-                    // Battle system commands - no text
-                    extractedFromCommand = true;
-                    break;
-                
-                // === Actor Commands ===
-                case 320: // Change Name
-                    // parameters[1] = new actor name (TRANSLATABLE!)
-                    if (params.size() > 1 && params[1].isString()) {
-                        QString actorName = params[1].toString();
-                        QString newKeyPath = currentKeyPath.isEmpty() ? "parameters[1]" : currentKeyPath + ".parameters[1]";
-                        
-                        if (!actorName.isEmpty() && !isSystemString(actorName)) {
-                            QJsonObject entry;
-                            entry.insert(QStringLiteral("source"), actorName);
-                            entry.insert(QStringLiteral("path"), filePath);
-                            entry.insert(QStringLiteral("key"), newKeyPath);
-                            extractedStrings.append(entry);
-                            extractedFromCommand = true;
-                        }
-                    }
-                    break;
-                
-                case 324: // Change Nickname
-                    // parameters[1] = new nickname (TRANSLATABLE!)
-                    if (params.size() > 1 && params[1].isString()) {
-                        QString nickname = params[1].toString();
-                        QString newKeyPath = currentKeyPath.isEmpty() ? "parameters[1]" : currentKeyPath + ".parameters[1]";
-                        
-                        if (!nickname.isEmpty() && !isSystemString(nickname)) {
-                            QJsonObject entry;
-                            entry.insert(QStringLiteral("source"), nickname);
-                            entry.insert(QStringLiteral("path"), filePath);
-                            entry.insert(QStringLiteral("key"), newKeyPath);
-                            extractedStrings.append(entry);
-                            extractedFromCommand = true;
-                        }
-                    }
-                    break;
-                
-                // === Plugin Commands ===
-                case 356: // Plugin Command (MV)
-                case 357: // Plugin Command (MZ)
-                    // parameters[0] = plugin command string
-                    // Usually technical (like "EnemyBook open"), but some plugins use translatable text
-                    // Best to skip unless specifically needed
-                    // Add to blacklist or use heuristic
-                    extractedFromCommand = true; // Fix: Prevent recursion
-                    break;
-                
-                // === Script Commands ===
-                case 355: // Script
-                case 655: // Script continuation
-                    // JavaScript code - never translate
-                    extractedFromCommand = true; // Fix: Prevent recursion
-                    break;
-                
-                default:
-                    // Unknown command - log but don't extract
-                    qDebug() << "RpgmAnalyzer: Unknown event code:" << code 
-                             << "in file:" << filePath;
-                    break;
+                }
+                keyPath.pop();
+                keyPath.pop();
             }
             
             // Recurse into nested structures (like lists within events)
             // But skip parameters array if we already extracted from it
-            for (const QString &key : obj.keys()) {
+            for (auto it = obj.constBegin(); it != obj.constEnd(); ++it) {
+                const QString key = it.key();
                 if (key == "parameters" && extractedFromCommand) {
                     continue; // Already handled above
                 }
@@ -804,11 +853,12 @@ void RpgmAnalyzer::extractStringsFromJsonValue(const QJsonValue &jsonValue, QJso
                     continue;
                 }
                 
-                QJsonValue val = obj[key];
-                QString newKeyPath = currentKeyPath.isEmpty() ? key : currentKeyPath + "." + key;
+                const QJsonValue val = it.value();
                 
                 if (val.isArray() || val.isObject()) {
-                    extractStringsFromJsonValue(val, extractedStrings, filePath, newKeyPath);
+                    keyPath.pushKey(key);
+                    extractStringsFromJsonValue(val, extractedStrings, keyPath, unknownEventCodes);
+                    keyPath.pop();
                 }
             }
             
@@ -858,130 +908,83 @@ void RpgmAnalyzer::extractStringsFromJsonValue(const QJsonValue &jsonValue, QJso
             "script", "url"
         };
         
-        for (const QString &key : obj.keys()) {
+        for (auto it = obj.constBegin(); it != obj.constEnd(); ++it) {
+            const QString key = it.key();
             // Skip blacklisted keys entirely
             if (blacklistedKeys.contains(key)) {
                 continue;
             }
             
-            QJsonValue val = obj[key];
-            QString newKeyPath = currentKeyPath.isEmpty() ? key : currentKeyPath + "." + key;
+            const QJsonValue val = it.value();
             
             if (val.isString()) {
                 // Only extract if key is whitelisted
                 if (whitelistedKeys.contains(key)) {
-                    extractStringsFromJsonValue(val, extractedStrings, filePath, newKeyPath);
+                    keyPath.pushKey(key);
+                    extractStringsFromJsonValue(val, extractedStrings, keyPath, unknownEventCodes);
+                    keyPath.pop();
                 }
             } else if (val.isArray() || val.isObject()) {
                 // Recurse to find nested whitelisted keys
-                extractStringsFromJsonValue(val, extractedStrings, filePath, newKeyPath);
+                keyPath.pushKey(key);
+                extractStringsFromJsonValue(val, extractedStrings, keyPath, unknownEventCodes);
+                keyPath.pop();
             }
         }
     } else if (jsonValue.isArray()) {
-        QJsonArray arr = jsonValue.toArray();
+        const QJsonArray arr = jsonValue.toArray();
+        // Message boxes only occur in the command lists of events, common events and troop pages
+        static const QString listKey = QStringLiteral("list");
+        const bool probeDialogue = m_mergeDialogue && !keyPath.isEmpty()
+                                   && !keyPath.at(keyPath.size() - 1).isIndex()
+                                   && keyPath.at(keyPath.size() - 1).key == listKey;
+        int probeFrom = 0; // Commands before this index belong to a run that was already probed
         for (int i = 0; i < arr.size(); ++i) {
-            QString newKeyPath = currentKeyPath.isEmpty()
-                ? QString::number(i)
-                : currentKeyPath + "[" + QString::number(i) + "]";
-            extractStringsFromJsonValue(arr[i], extractedStrings, filePath, newKeyPath);
-        }
-    }
-}
-
-bool RpgmAnalyzer::isSystemString(const QString &text)
-{
-    // Empty or whitespace only
-    if (text.trimmed().isEmpty()) {
-        return true;
-    }
-
-    // Pure numbers
-    bool isNumber;
-    text.toDouble(&isNumber);
-    if (isNumber) {
-        return true;
-    }
-
-    // Paths (contains /)
-    if (text.contains('/')) {
-        return true;
-    }
-
-    // URLs
-    static QRegularExpression urlPattern(
-        QStringLiteral("^(https?|ftp|file)://"),
-        QRegularExpression::CaseInsensitiveOption
-    );
-    if (urlPattern.match(text).hasMatch()) {
-        return true;
-    }
-
-    // File extensions
-    static QRegularExpression fileExtPattern(
-        QStringLiteral("\\.(png|jpg|jpeg|gif|bmp|wav|ogg|m4a|mp3|json|js)$"),
-        QRegularExpression::CaseInsensitiveOption
-    );
-    if (fileExtPattern.match(text).hasMatch()) {
-        return true;
-    }
+            if (probeDialogue && i >= probeFrom) {
+                // A message box is a run of Show Text (401) or Scrolling Text (405) lines
+                static const QString codeKey = QStringLiteral("code");
+                static const QString parametersKey = QStringLiteral("parameters");
+                QStringList lines;
+                int runCode = 0;
+                int end = i;
+                for (; end < arr.size(); ++end) {
+                    const QJsonObject command = arr.at(end).toObject();
+                    const int code = command.value(codeKey).toInt();
+                    const QJsonArray params = command.value(parametersKey).toArray();
+                    if ((code != 401 && code != 405) || (runCode != 0 && code != runCode)
+                        || params.isEmpty() || !params.at(0).isString()) {
+                        break;
+                    }
+                    runCode = code;
+                    lines.append(params.at(0).toString());
+                }
 
-    // RPG Maker system prefixes
-    static QStringList systemPrefixes = {
-        "img/", "audio/", "data/", "js/", "fonts/",
-        "Actor", "Class", "Skill", "Item", "Weapon", "Armor",
-        "Enemy", "Troop", "State", "Animation", "Tileset",
-        "CommonEvent", "System", "MapInfo"
-    };
+                if (lines.size() > 1) {
+                    const QString text = lines.join(QLatin1Char('\n'));
+                    if (!text.trimmed().isEmpty() && !isSystemString(text)) {
+                        QJsonObject entry;
+                        entry.insert(QStringLiteral("source"), text);
+                        entry.insert(QStringLiteral("key"), dialogueKey(keyPath, i, end - 1));
+                        extractedStrings.append(entry);
+                        i = end - 1;
+                        continue;
+                    }
+                }
+                // Not merged: the lines of the run are extracted one by one below, without
+                // probing the rest of the run again
+                probeFrom = qMax(end, i + 1);
+            }
 
-    for (const QString &prefix : systemPrefixes) {
-        if (text.startsWith(prefix, Qt::CaseInsensitive)) {
-            return true;
+            keyPath.pushIndex(i);
+            extractStringsFromJsonValue(arr.at(i), extractedStrings, keyPath, unknownEventCodes);
+            keyPath.pop();
         }
     }
+}
 
-    // RPG Maker control codes (\c[1], \n[1], \v[1], \i[1])
-    static QRegularExpression controlCodePattern(
-        QStringLiteral("^\\\\[a-z]\\[\\d+\\]$"),
-        QRegularExpression::CaseInsensitiveOption
-    );
-    if (controlCodePattern.match(text.trimmed()).hasMatch()) {
-        return true;
-    }
-
-    // Generic event names (EV001, EV030, etc.)
-    static QRegularExpression eventNamePattern(
-        QStringLiteral("^EV\\d{3,}$"),
-        QRegularExpression::CaseInsensitiveOption
-    );
-    if (eventNamePattern.match(text).hasMatch()) {
-        return true;
-    }
-
-    // Plugin command patterns (technical strings)
-    static QRegularExpression pluginCommandPattern(
-        QStringLiteral("^[A-Z][a-zA-Z]+ (open|close|add|remove|set|get|show|hide|enable|disable)"),
-        QRegularExpression::CaseInsensitiveOption
-    );
-    if (pluginCommandPattern.match(text).hasMatch()) {
-        return true;
-    }
-
-    // Variable references ($gameVariables, $gameSwitches, etc.)
-    if (text.contains(QStringLiteral("$game"), Qt::CaseInsensitive)) {
-        return true;
-    }
-
-    // Only symbols/punctuation (no actual text)
-    static QRegularExpression symbolOnlyPattern(
-        QStringLiteral("^[^a-zA-Z0-9\\p{Thai}\\p{Han}\\p{Hiragana}\\p{Katakana}\\p{Hangul}\\p{Cyrillic}\\p{Arabic}]+$")
-    );
-    if (symbolOnlyPattern.match(text).hasMatch()) {
-        return true;
-    }
-
-    // (Removed short string checks per user request to support short choices like "Yes"/"No")
-
-    return false;
+bool RpgmAnalyzer::isSystemString(const QString &text) const
+{
+    return SystemStringClassifier::isSystemString(text);
 }
 
 
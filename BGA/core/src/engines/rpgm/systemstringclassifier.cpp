@@ -0,0 +1,477 @@
+#include "core/engines/rpgm/systemstringclassifier.h"
+
+#include <QtCore/QLatin1StringView>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QStringList>
+
+#include <array>
+#include <vector>
+
+namespace core { namespace engines { namespace rpgm {
+
+namespace {
+
+// Patterns shared by the reference implementation and the fallbacks of the fast path.
+const QRegularExpression &fileExtPattern()
+{
+    static const QRegularExpression pattern(
+        QStringLiteral("\\.(png|jpg|jpeg|gif|bmp|wav|ogg|m4a|mp3|json|js)$"),
+        QRegularExpression::CaseInsensitiveOption
+    );
+    return pattern;
+}
+
+const QRegularExpression &controlCodePattern()
+{
+    static const QRegularExpression pattern(
+        QStringLiteral("^\\\\[a-z]\\[\\d+\\]$"),
+        QRegularExpression::CaseInsensitiveOption
+    );
+    return pattern;
+}
+
+const QRegularExpression &pluginCommandPattern()
+{
+    static const QRegularExpression pattern(
+        QStringLiteral("^[A-Z][a-zA-Z]+ (open|close|add|remove|set|get|show|hide|enable|disable)"),
+        QRegularExpression::CaseInsensitiveOption
+    );
+    return pattern;
+}
+
+const QRegularExpression &symbolOnlyPattern()
+{
+    static const QRegularExpression pattern(
+        QStringLiteral("^[^a-zA-Z0-9\\p{Thai}\\p{Han}\\p{Hiragana}\\p{Katakana}\\p{Hangul}\\p{Cyrillic}\\p{Arabic}]+$")
+    );
+    return pattern;
+}
+
+const QStringList &systemPrefixes()
+{
+    static const QStringList prefixes = {
+        "img/", "audio/", "data/", "js/", "fonts/",
+        "Actor", "Class", "Skill", "Item", "Weapon", "Armor",
+        "Enemy", "Troop", "State", "Animation", "Tileset",
+        "CommonEvent", "System", "MapInfo"
+    };
+    return prefixes;
+}
+
+// Characters that case-insensitive matching can fold onto ASCII letters used by the rules
+// (long s, Kelvin sign, dotted and dotless i). Windows containing one are left to the regexes.
+bool isCaselessTrap(char16_t c)
+{
+    return c == 0x017F || c == 0x212A || c == 0x0130 || c == 0x0131;
+}
+
+bool containsCaselessTrap(QStringView text)
+{
+    for (const QChar c : text) {
+        if (isCaselessTrap(c.unicode())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool isAsciiLetter(char16_t c)
+{
+    return (c >= u'a' && c <= u'z') || (c >= u'A' && c <= u'Z');
+}
+
+bool isAsciiDigit(char16_t c)
+{
+    return c >= u'0' && c <= u'9';
+}
+
+char16_t asciiLower(char16_t c)
+{
+    return (c >= u'A' && c <= u'Z') ? char16_t(c + (u'a' - u'A')) : c;
+}
+
+// `lowerPrefix` must be lower-case ASCII.
+bool startsWithAsciiCaseless(QStringView text, QLatin1StringView lowerPrefix)
+{
+    if (text.size() < lowerPrefix.size()) {
+        return false;
+    }
+    for (qsizetype i = 0; i < lowerPrefix.size(); ++i) {
+        if (asciiLower(text[i].unicode()) != char16_t(lowerPrefix[i].unicode())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool endsWithAsciiCaseless(QStringView text, QLatin1StringView lowerSuffix)
+{
+    return text.size() >= lowerSuffix.size()
+        && startsWithAsciiCaseless(text.last(lowerSuffix.size()), lowerSuffix);
+}
+
+// Letters that certainly belong to one of the scripts the symbol-only rule accepts.
+bool isDefinitelyScriptLetter(char16_t c)
+{
+    return (c >= 0x0E01 && c <= 0x0E30)    // Thai consonants and vowels
+        || (c >= 0x3041 && c <= 0x3096)    // Hiragana
+        || (c >= 0x30A1 && c <= 0x30FA)    // Katakana
+        || (c >= 0x4E00 && c <= 0x9FA5)    // CJK unified ideographs (Unicode 1.1)
+        || (c >= 0xAC00 && c <= 0xD7A3)    // Hangul syllables
+        || (c >= 0x0410 && c <= 0x044F)    // Basic Cyrillic
+        || (c >= 0x0621 && c <= 0x063A);   // Arabic letters
+}
+
+// Lower-case ASCII prefix trie of the name-like system prefixes. The path prefixes ("img/", ...)
+// are left out: anything starting with them contains '/' and is caught earlier.
+class PrefixTrie {
+public:
+    PrefixTrie()
+    {
+        m_nodes.emplace_back();
+        for (const QString &prefix : systemPrefixes()) {
+            if (prefix.contains(u'/')) {
+                continue;
+            }
+            int node = 0;
+            for (const QChar c : prefix) {
+                const int edge = asciiLower(c.unicode()) - u'a';
+                if (m_nodes[node].next[edge] == 0) {
+                    m_nodes[node].next[edge] = static_cast<int>(m_nodes.size());
+                    m_nodes.emplace_back();
+                }
+                node = m_nodes[node].next[edge];
+            }
+            m_nodes[node].terminal = true;
+        }
+    }
+
+    bool matchesPrefixOf(QStringView text) const
+    {
+        int node = 0;
+        for (const QChar c : text) {
+            const char16_t lower = asciiLower(c.unicode());
+            if (lower < u'a' || lower > u'z') {
+                return false;
+            }
+            node = m_nodes[node].next[lower - u'a'];
+            if (node == 0) {
+                return false;
+            }
+            if (m_nodes[node].terminal) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Longest prefix; beyond it the trie cannot match
+    static constexpr qsizetype kMaxDepth = 11;
+
+private:
+    struct Node {
+        std::array<int, 26> next{};
+        bool terminal = false;
+    };
+    std::vector<Node> m_nodes;
+};
+
+const PrefixTrie &prefixTrie()
+{
+    static const PrefixTrie trie;
+    return trie;
+}
+
+// QString::toDouble only accepts text whose first non-space character is a digit, a sign, a
+// decimal point, or the start of "inf"/"nan"; everything else skips the conversion.
+bool isNumber(const QString &text, qsizetype firstNonSpace)
+{
+    if (firstNonSpace >= text.size()) {
+        return false;
+    }
+    const char16_t c = text[firstNonSpace].unicode();
+    const bool candidate = isAsciiDigit(c) || c == u'+' || c == u'-' || c == u'.' || c == 0x2212
+        || c == u'i' || c == u'I' || c == u'n' || c == u'N';
+    if (!candidate) {
+        return false;
+    }
+    bool ok = false;
+    text.toDouble(&ok);
+    return ok;
+}
+
+bool hasSystemExtension(const QString &text)
+{
+    // `$` also matches in front of a single trailing newline
+    const QStringView view(text);
+    if (containsCaselessTrap(view.last(qMin<qsizetype>(6, view.size())))) {
+        return fileExtPattern().match(text).hasMatch();
+    }
+
+    static const QLatin1StringView extensions[] = {
+        QLatin1StringView(".png"), QLatin1StringView(".jpg"), QLatin1StringView(".jpeg"),
+        QLatin1StringView(".gif"), QLatin1StringView(".bmp"), QLatin1StringView(".wav"),
+        QLatin1StringView(".ogg"), QLatin1StringView(".m4a"), QLatin1StringView(".mp3"),
+        QLatin1StringView(".json"), QLatin1StringView(".js")
+    };
+    auto endsWithExtension = [](QStringView tail) {
+        for (const QLatin1StringView &extension : extensions) {
+            if (endsWithAsciiCaseless(tail, extension)) {
+                return true;
+            }
+        }
+        return false;
+    };
+    return endsWithExtension(view) || (view.endsWith(u'\n') && endsWithExtension(view.chopped(1)));
+}
+
+bool hasSystemPrefix(const QString &text)
+{
+    const QStringView head = QStringView(text).first(qMin(PrefixTrie::kMaxDepth, text.size()));
+    if (containsCaselessTrap(head)) {
+        for (const QString &prefix : systemPrefixes()) {
+            if (text.startsWith(prefix, Qt::CaseInsensitive)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    return prefixTrie().matchesPrefixOf(head);
+}
+
+// \c[1], \n[12], ... on the trimmed text
+bool isControlCode(const QString &text, QStringView trimmed)
+{
+    if (trimmed.size() < 5 || trimmed[0] != u'\\' || trimmed[2] != u'[' || trimmed.back() != u']') {
+        return false;
+    }
+    const char16_t letter = trimmed[1].unicode();
+    if (isCaselessTrap(letter)) {
+        return controlCodePattern().match(text.trimmed()).hasMatch();
+    }
+    if (!isAsciiLetter(letter)) {
+        return false;
+    }
+    for (qsizetype i = 3; i < trimmed.size() - 1; ++i) {
+        if (!isAsciiDigit(trimmed[i].unicode())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// EV001, ev030, ... (optionally followed by one newline)
+bool isEventName(QStringView text)
+{
+    if (text.endsWith(u'\n')) {
+        text.chop(1);
+    }
+    if (text.size() < 5 || asciiLower(text[0].unicode()) != u'e' || asciiLower(text[1].unicode()) != u'v') {
+        return false;
+    }
+    for (qsizetype i = 2; i < text.size(); ++i) {
+        if (!isAsciiDigit(text[i].unicode())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// "EnemyBook open", "Quest add", ...
+bool isPluginCommand(const QString &text)
+{
+    qsizetype run = 0;
+    bool trap = false;
+    while (run < text.size() && (isAsciiLetter(text[run].unicode()) || isCaselessTrap(text[run].unicode()))) {
+        trap = trap || isCaselessTrap(text[run].unicode());
+        ++run;
+    }
+    if (run < 2 || run >= text.size() || text[run] != u' ') {
+        return false;
+    }
+
+    const QStringView word = QStringView(text).sliced(run + 1);
+    if (trap || containsCaselessTrap(word.first(qMin<qsizetype>(7, word.size())))) {
+        return pluginCommandPattern().match(text).hasMatch();
+    }
+
+    static const QLatin1StringView verbs[] = {
+        QLatin1StringView("open"), QLatin1StringView("close"), QLatin1StringView("add"),
+        QLatin1StringView("remove"), QLatin1StringView("set"), QLatin1StringView("get"),
+        QLatin1StringView("show"), QLatin1StringView("hide"), QLatin1StringView("enable"),
+        QLatin1StringView("disable")
+    };
+    for (const QLatin1StringView &verb : verbs) {
+        if (startsWithAsciiCaseless(word, verb)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+bool SystemStringClassifier::isSystemString(const QString &text)
+{
+    // One pass collects everything the unanchored rules need
+    const qsizetype size = text.size();
+    qsizetype firstNonSpace = -1;
+    qsizetype lastNonSpace = -1;
+    bool hasSlash = false;
+    bool hasDollar = false;
+    bool isAscii = true;
+    bool hasAsciiAlnum = false;
+    bool hasScriptLetter = false;
+
+    const QChar *data = text.constData();
+    for (qsizetype i = 0; i < size; ++i) {
+        const char16_t c = data[i].unicode();
+        if (c < 0x80) {
+            if (c == u'/') {
+                hasSlash = true;
+            } else if (c == u'$') {
+                hasDollar = true;
+            } else if (isAsciiLetter(c) || isAsciiDigit(c)) {
+                hasAsciiAlnum = true;
+            }
+        } else {
+            isAscii = false;
+            hasScriptLetter = hasScriptLetter || isDefinitelyScriptLetter(c);
+            if (QChar::isSurrogate(c)) {
+                // QRegularExpression refuses to match invalid UTF-16 at all
+                if (!QChar::isHighSurrogate(c) || i + 1 >= size || !data[i + 1].isLowSurrogate()) {
+                    return isSystemStringReference(text);
+                }
+                ++i;
+                if (firstNonSpace < 0) {
+                    firstNonSpace = i - 1;
+                }
+                lastNonSpace = i;
+                continue;
+            }
+        }
+        if (!data[i].isSpace()) {
+            if (firstNonSpace < 0) {
+                firstNonSpace = i;
+            }
+            lastNonSpace = i;
+        }
+    }
+
+    // Empty or whitespace only
+    if (firstNonSpace < 0) {
+        return true;
+    }
+
+    // Paths (contains /); this also covers URLs and the "img/"-style prefixes
+    if (hasSlash) {
+        return true;
+    }
+
+    if (isNumber(text, firstNonSpace)) {
+        return true;
+    }
+
+    if (hasSystemExtension(text) || hasSystemPrefix(text)) {
+        return true;
+    }
+
+    const QStringView trimmed = QStringView(text).sliced(firstNonSpace, lastNonSpace - firstNonSpace + 1);
+    if (isControlCode(text, trimmed) || isEventName(text) || isPluginCommand(text)) {
+        return true;
+    }
+
+    // Variable references ($gameVariables, $gameSwitches, etc.)
+    if (hasDollar) {
+        for (qsizetype i = text.indexOf(u'$'); i >= 0; i = text.indexOf(u'$', i + 1)) {
+            if (startsWithAsciiCaseless(QStringView(text).sliced(i + 1), QLatin1StringView("game"))) {
+                return true;
+            }
+        }
+    }
+
+    // Only symbols/punctuation (no actual text)
+    if (hasAsciiAlnum || hasScriptLetter) {
+        return false;
+    }
+    if (isAscii) {
+        return true;
+    }
+    return symbolOnlyPattern().match(text).hasMatch();
+}
+
+bool SystemStringClassifier::isSystemStringReference(const QString &text)
+{
+    // Empty or whitespace only
+    if (text.trimmed().isEmpty()) {
+        return true;
+    }
+
+    // Pure numbers
+    bool isNumber;
+    text.toDouble(&isNumber);
+    if (isNumber) {
+        return true;
+    }
+
+    // Paths (contains /)
+    if (text.contains('/')) {
+        return true;
+    }
+
+    // URLs
+    static const QRegularExpression urlPattern(
+        QStringLiteral("^(https?|ftp|file)://"),
+        QRegularExpression::CaseInsensitiveOption
+    );
+    if (urlPattern.match(text).hasMatch()) {
+        return true;
+    }
+
+    // File extensions
+    if (fileExtPattern().match(text).hasMatch()) {
+        return true;
+    }
+
+    // RPG Maker system prefixes
+    for (const QString &prefix : systemPrefixes()) {
+        if (text.startsWith(prefix, Qt::CaseInsensitive)) {
+            return true;
+        }
+    }
+
+    // RPG Maker control codes (\c[1], \n[1], \v[1], \i[1])
+    if (controlCodePattern().match(text.trimmed()).hasMatch()) {
+        return true;
+    }
+
+    // Generic event names (EV001, EV030, etc.)
+    static const QRegularExpression eventNamePattern(
+        QStringLiteral("^EV\\d{3,}$"),
+        QRegularExpression::CaseInsensitiveOption
+    );
+    if (eventNamePattern.match(text).hasMatch()) {
+        return true;
+    }
+
+    // Plugin command patterns (technical strings)
+    if (pluginCommandPattern().match(text).hasMatch()) {
+        return true;
+    }
+
+    // Variable references ($gameVariables, $gameSwitches, etc.)
+    if (text.contains(QStringLiteral("$game"), Qt::CaseInsensitive)) {
+        return true;
+    }
+
+    // Only symbols/punctuation (no actual text)
+    if (symbolOnlyPattern().match(text).hasMatch()) {
+        return true;
+    }
+
+    // (Removed short string checks per user request to support short choices like "Yes"/"No")
+
+    return false;
+}
+
+} } } // namespace core::engines::rpgm
@@ -1,4 +1,7 @@
 #include "core/gameanalyzer.h"
+#include "core/analyzerpayload.h"
+
+#include <QtCore/QJsonObject>
 
 namespace core {
 
@@ -8,4 +11,37 @@ AnalyzerOutput IGameAnalyzer::analyze(const QString &inputPath)
     return {};
 }
 
+AnalysisStatus IGameAnalyzer::analyzeStream(const QString &inputPath, IAnalysisSink &sink, QString *errorMessage)
+{
+    const AnalyzerOutput output = analyze(inputPath);
+    if (!output.errorMessage.isEmpty()) {
+        if (errorMessage) {
+            *errorMessage = output.errorMessage;
+        }
+        return AnalysisStatus::Failed;
+    }
+
+    QJsonObject root;
+    if (!AnalyzerPayload::decode(output, &root, errorMessage)) {
+        return AnalysisStatus::Failed;
+    }
+
+    const QJsonArray fonts = root.value(QStringLiteral("fonts")).toArray();
+    if (!fonts.isEmpty()) {
+        sink.fontsFound(fonts);
+    }
+    const QList<AnalyzerPayload::FileRecord> files = AnalyzerPayload::files(root);
+    const int fileCount = static_cast<int>(files.size());
+    for (int i = 0; i < fileCount; ++i) {
+        if (sink.isCancelled()) {
+            return AnalysisStatus::Cancelled;
+        }
+        if (!files.at(i).entries.isEmpty()) {
+            sink.entriesExtracted(files.at(i).path, files.at(i).entries);
+        }
+        sink.progress(i + 1, fileCount);
+    }
+    return AnalysisStatus::Finished;
+}
+
 } // namespace core
@@ -0,0 +1,441 @@
+#include "core/jsonpatchtree.h"
+
+#include <QtCore/QVarLengthArray>
+
+#include <cstring>
+
+namespace core {
+
+namespace {
+
+constexpr int kMaxDepth = 512;
+
+bool isAsciiDigits(QByteArrayView text)
+{
+    if (text.isEmpty()) {
+        return false;
+    }
+    for (const char c : text) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+struct JsonPatchTree::LocateState {
+    QByteArrayView json;
+    QList<JsonSplice> *splices;
+    QList<KeyPath> *unresolved;
+    KeyPath path;
+};
+
+void JsonPatchTree::insert(const KeyPath &path, const QString &value)
+{
+    if (path.isEmpty()) {
+        return;
+    }
+
+    int node = 0;
+    for (qsizetype i = 0; i < path.size(); ++i) {
+        node = child(node, path.at(i));
+    }
+
+    if (!m_nodes[node].value) {
+        ++m_valueCount;
+    }
+    m_nodes[node].value = value;
+}
+
+int JsonPatchTree::child(int node, const KeyPath::Segment &segment)
+{
+    const int next = static_cast<int>(m_nodes.size());
+    if (segment.isIndex()) {
+        const auto it = m_nodes[node].indexChildren.constFind(segment.index);
+        if (it != m_nodes[node].indexChildren.constEnd()) {
+            return it.value();
+        }
+        m_nodes[node].indexChildren.insert(segment.index, next);
+    } else {
+        const auto it = m_nodes[node].keyChildren.constFind(segment.key);
+        if (it != m_nodes[node].keyChildren.constEnd()) {
+            return it.value();
+        }
+        m_nodes[node].keyChildren.insert(segment.key, next);
+    }
+    m_nodes.append(Node());
+    return next;
+}
+
+qsizetype JsonPatchTree::apply(QJsonDocument &doc, QList<KeyPath> *unresolved) const
+{
+    KeyPath path;
+    qsizetype applied = 0;
+
+    // Take the root out of the document first so it is the only owner of its data and
+    // modifying it does not copy the whole tree.
+    if (doc.isObject()) {
+        QJsonObject obj = doc.object();
+        doc = QJsonDocument();
+        applied = applyObject(0, obj, path, unresolved);
+        doc.setObject(obj);
+    } else if (doc.isArray()) {
+        QJsonArray arr = doc.array();
+        doc = QJsonDocument();
+        applied = applyArray(0, arr, path, unresolved);
+        doc.setArray(arr);
+    } else {
+        collectPaths(0, path, unresolved);
+    }
+
+    return applied;
+}
+
+qsizetype JsonPatchTree::applyObject(int node, QJsonObject &obj, KeyPath &path, QList<KeyPath> *unresolved) const
+{
+    const Node &current = m_nodes.at(node);
+    qsizetype applied = 0;
+
+    auto visit = [&](const QString &key, int childNode) {
+        const QJsonObject::iterator slot = obj.find(key);
+        if (slot == obj.end()) {
+            collectPaths(childNode, path, unresolved);
+            return;
+        }
+        // Null the slot while the child is modified so the child holds the only reference
+        QJsonValue value = slot.value();
+        slot.value() = QJsonValue();
+        applied += applyValue(childNode, value, path, unresolved);
+        slot.value() = value;
+    };
+
+    for (auto it = current.keyChildren.constBegin(); it != current.keyChildren.constEnd(); ++it) {
+        path.pushKey(it.key());
+        visit(it.key(), it.value());
+        path.pop();
+    }
+    // Index segments name members when the container turns out to be an object
+    for (auto it = current.indexChildren.constBegin(); it != current.indexChildren.constEnd(); ++it) {
+        path.pushIndex(it.key());
+        visit(QString::number(it.key()), it.value());
+        path.pop();
+    }
+
+    return applied;
+}
+
+qsizetype JsonPatchTree::applyArray(int node, QJsonArray &arr, KeyPath &path, QList<KeyPath> *unresolved) const
+{
+    const Node &current = m_nodes.at(node);
+    qsizetype applied = 0;
+
+    auto visit = [&](qsizetype index, int childNode) {
+        if (index < 0 || index >= arr.size()) {
+            collectPaths(childNode, path, unresolved);
+            return;
+        }
+        QJsonValue value = arr.at(index);
+        arr.replace(index, QJsonValue());
+        applied += applyValue(childNode, value, path, unresolved);
+        arr.replace(index, value);
+    };
+
+    for (auto it = current.indexChildren.constBegin(); it != current.indexChildren.constEnd(); ++it) {
+        path.pushIndex(it.key());
+        visit(it.key(), it.value());
+        path.pop();
+    }
+    // Numeric member names address elements too ("1.list[0]" on a root array)
+    for (auto it = current.keyChildren.constBegin(); it != current.keyChildren.constEnd(); ++it) {
+        path.pushKey(it.key());
+        bool ok = false;
+        const qsizetype index = it.key().toLongLong(&ok);
+        visit(ok ? index : -1, it.value());
+        path.pop();
+    }
+
+    return applied;
+}
+
+qsizetype JsonPatchTree::applyValue(int node, QJsonValue &value, KeyPath &path, QList<KeyPath> *unresolved) const
+{
+    const Node &current = m_nodes.at(node);
+
+    // A replaced value makes any deeper updates below it moot
+    if (current.value) {
+        value = *current.value;
+        return 1;
+    }
+
+    qsizetype applied = 0;
+    if (value.isObject()) {
+        QJsonObject obj = value.toObject();
+        value = QJsonValue();
+        applied = applyObject(node, obj, path, unresolved);
+        value = obj;
+    } else if (value.isArray()) {
+        QJsonArray arr = value.toArray();
+        value = QJsonValue();
+        applied = applyArray(node, arr, path, unresolved);
+        value = arr;
+    } else {
+        collectPaths(node, path, unresolved);
+    }
+    return applied;
+}
+
+bool JsonPatchTree::locate(QByteArrayView json, QList<JsonSplice> *splices, QList<KeyPath> *unresolved) const
+{
+    LocateState state{json, splices, unresolved, KeyPath()};
+
+    qsizetype pos = JsonScanner::skipWhitespace(json, 0);
+    if (json.size() - pos >= 3 && std::memcmp(json.data() + pos, "\xEF\xBB\xBF", 3) == 0) {
+        pos = JsonScanner::skipWhitespace(json, pos + 3);
+    }
+    if (pos >= json.size() || (json[pos] != '{' && json[pos] != '[')) {
+        return false;
+    }
+    if (!locateValue(0, pos, 0, state)) {
+        return false;
+    }
+    return JsonScanner::skipWhitespace(json, pos) == json.size();
+}
+
+bool JsonPatchTree::locateValue(int node, qsizetype &pos, int depth, LocateState &state) const
+{
+    const Node &current = m_nodes.at(node);
+    if (pos >= state.json.size() || depth > kMaxDepth) {
+        return false;
+    }
+
+    const qsizetype start = pos;
+    if (current.value && node != 0) {
+        pos = JsonScanner::skipValue(state.json, pos);
+        if (pos < 0) {
+            return false;
+        }
+        state.splices->append(JsonSplice{JsonSpan{start, pos - start}, *current.value});
+        return true;
+    }
+
+    switch (state.json[pos]) {
+    case '{':
+        return locateObject(node, pos, depth + 1, state);
+    case '[':
+        return locateArray(node, pos, depth + 1, state);
+    default:
+        pos = JsonScanner::skipValue(state.json, pos);
+        collectPaths(node, state.path, state.unresolved);
+        return pos >= 0;
+    }
+}
+
+bool JsonPatchTree::locateObject(int node, qsizetype &pos, int depth, LocateState &state) const
+{
+    const Node &current = m_nodes.at(node);
+    const QByteArrayView json = state.json;
+    QVarLengthArray<int, 8> matched;
+
+    pos = JsonScanner::skipWhitespace(json, pos + 1);
+    bool closed = pos < json.size() && json[pos] == '}';
+    if (closed) {
+        ++pos;
+    }
+
+    while (!closed) {
+        if (pos >= json.size() || json[pos] != '"') {
+            return false;
+        }
+        const qsizetype keyStart = pos + 1;
+        pos = JsonScanner::skipString(json, pos);
+        if (pos < 0) {
+            return false;
+        }
+        const QByteArrayView rawKey = json.sliced(keyStart, pos - 1 - keyStart);
+
+        pos = JsonScanner::skipWhitespace(json, pos);
+        if (pos >= json.size() || json[pos] != ':') {
+            return false;
+        }
+        pos = JsonScanner::skipWhitespace(json, pos + 1);
+
+        // Member names are matched without allocating unless they contain escapes
+        QString decodedKey;
+        if (rawKey.contains('\\')) {
+            const QByteArray wrapped = "[\"" + rawKey.toByteArray() + "\"]";
+            decodedKey = QJsonDocument::fromJson(wrapped).array().at(0).toString();
+        }
+        const QUtf8StringView utf8Key(rawKey.data(), rawKey.size());
+        auto sameKey = [&](const QString &key) {
+            return decodedKey.isNull() ? QAnyStringView::equal(utf8Key, key) : decodedKey == key;
+        };
+
+        int childNode = -1;
+        for (auto it = current.keyChildren.constBegin(); it != current.keyChildren.constEnd(); ++it) {
+            if (sameKey(it.key())) {
+                childNode = it.value();
+                state.path.pushKey(it.key());
+                break;
+            }
+        }
+        if (childNode < 0 && !current.indexChildren.isEmpty() && isAsciiDigits(rawKey)) {
+            // "01" is not the member apply() would look up for index 1
+            if (rawKey.size() == 1 || rawKey.front() != '0') {
+                const qsizetype index = rawKey.toByteArray().toLongLong();
+                childNode = current.indexChildren.value(index, -1);
+                if (childNode >= 0) {
+                    state.path.pushIndex(index);
+                }
+            }
+        }
+
+        if (childNode >= 0) {
+            if (matched.contains(childNode)) {
+                return false; // Duplicate member: leave the choice of occurrence to the parser
+            }
+            matched.append(childNode);
+            const bool ok = locateValue(childNode, pos, depth, state);
+            state.path.pop();
+            if (!ok) {
+                return false;
+            }
+        } else {
+            pos = JsonScanner::skipValue(json, pos);
+            if (pos < 0) {
+                return false;
+            }
+        }
+
+        pos = JsonScanner::skipWhitespace(json, pos);
+        if (pos >= json.size()) {
+            return false;
+        }
+        if (json[pos] == '}') {
+            ++pos;
+            closed = true;
+        } else if (json[pos] != ',') {
+            return false;
+        } else {
+            pos = JsonScanner::skipWhitespace(json, pos + 1);
+        }
+    }
+
+    // Whatever was not matched does not exist in this object
+    if (state.unresolved && matched.size() < current.keyChildren.size() + current.indexChildren.size()) {
+        for (auto it = current.keyChildren.constBegin(); it != current.keyChildren.constEnd(); ++it) {
+            if (!matched.contains(it.value())) {
+                state.path.pushKey(it.key());
+                collectPaths(it.value(), state.path, state.unresolved);
+                state.path.pop();
+            }
+        }
+        for (auto it = current.indexChildren.constBegin(); it != current.indexChildren.constEnd(); ++it) {
+            if (!matched.contains(it.value())) {
+                state.path.pushIndex(it.key());
+                collectPaths(it.value(), state.path, state.unresolved);
+                state.path.pop();
+            }
+        }
+    }
+    return true;
+}
+
+bool JsonPatchTree::locateArray(int node, qsizetype &pos, int depth, LocateState &state) const
+{
+    const Node &current = m_nodes.at(node);
+    const QByteArrayView json = state.json;
+    qsizetype count = 0;
+
+    pos = JsonScanner::skipWhitespace(json, pos + 1);
+    bool closed = pos < json.size() && json[pos] == ']';
+    if (closed) {
+        ++pos;
+    }
+
+    while (!closed) {
+        int childNode = current.indexChildren.value(count, -1);
+        if (childNode >= 0) {
+            state.path.pushIndex(count);
+        } else if (!current.keyChildren.isEmpty()) {
+            const QString key = QString::number(count);
+            childNode = current.keyChildren.value(key, -1);
+            if (childNode >= 0) {
+                state.path.pushKey(key);
+            }
+        }
+
+        if (childNode >= 0) {
+            const bool ok = locateValue(childNode, pos, depth, state);
+            state.path.pop();
+            if (!ok) {
+                return false;
+            }
+        } else {
+            pos = JsonScanner::skipValue(json, pos);
+            if (pos < 0) {
+                return false;
+            }
+        }
+        ++count;
+
+        pos = JsonScanner::skipWhitespace(json, pos);
+        if (pos >= json.size()) {
+            return false;
+        }
+        if (json[pos] == ']') {
+            ++pos;
+            closed = true;
+        } else if (json[pos] != ',') {
+            return false;
+        } else {
+            pos = JsonScanner::skipWhitespace(json, pos + 1);
+        }
+    }
+
+    // Indices past the end and member names that are not indices do not resolve
+    if (state.unresolved) {
+        for (auto it = current.indexChildren.constBegin(); it != current.indexChildren.constEnd(); ++it) {
+            if (it.key() >= count) {
+                state.path.pushIndex(it.key());
+                collectPaths(it.value(), state.path, state.unresolved);
+                state.path.pop();
+            }
+        }
+        for (auto it = current.keyChildren.constBegin(); it != current.keyChildren.constEnd(); ++it) {
+            bool ok = false;
+            const qsizetype index = it.key().toLongLong(&ok);
+            if (!ok || index < 0 || index >= count || current.indexChildren.contains(index)) {
+                state.path.pushKey(it.key());
+                collectPaths(it.value(), state.path, state.unresolved);
+                state.path.pop();
+            }
+        }
+    }
+    return true;
+}
+
+void JsonPatchTree::collectPaths(int node, KeyPath &path, QList<KeyPath> *out) const
+{
+    if (!out) {
+        return;
+    }
+
+    const Node &current = m_nodes.at(node);
+    if (current.value) {
+        out->append(path);
+    }
+    for (auto it = current.keyChildren.constBegin(); it != current.keyChildren.constEnd(); ++it) {
+        path.pushKey(it.key());
+        collectPaths(it.value(), path, out);
+        path.pop();
+    }
+    for (auto it = current.indexChildren.constBegin(); it != current.indexChildren.constEnd(); ++it) {
+        path.pushIndex(it.key());
+        collectPaths(it.value(), path, out);
+        path.pop();
+    }
+}
+
+} // namespace core
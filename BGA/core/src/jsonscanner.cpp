@@ -0,0 +1,349 @@
+#include "core/jsonscanner.h"
+
+#include <QtCore/QRegularExpression>
+
+#include <algorithm>
+#include <cstring>
+
+namespace core {
+
+namespace {
+
+constexpr int kMaxDepth = 512;
+
+bool isJsonWhitespace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+// Recursive-descent walk that copies the input into `out`, leaving out the values of skipped
+// members. Untouched ranges are copied lazily in one chunk (`copyFrom` marks the first byte
+// that still has to be copied).
+class MemberStripper {
+public:
+    MemberStripper(QByteArrayView json, const QSet<QByteArray> &keys)
+        : m_json(json), m_keys(keys)
+    {
+    }
+
+    bool run()
+    {
+        qsizetype pos = JsonScanner::skipWhitespace(m_json, 0);
+        // Tolerate a UTF-8 BOM in front of the document.
+        if (m_json.size() - pos >= 3 && std::memcmp(m_json.data() + pos, "\xEF\xBB\xBF", 3) == 0) {
+            pos = JsonScanner::skipWhitespace(m_json, pos + 3);
+        }
+        if (!value(pos, 0)) {
+            return false;
+        }
+        if (m_skipped == 0) {
+            return false;
+        }
+        m_out.append(m_json.sliced(m_copyFrom));
+        return true;
+    }
+
+    QByteArray result() const { return m_out; }
+    qsizetype skippedBytes() const { return m_skipped; }
+
+private:
+    bool value(qsizetype &pos, int depth)
+    {
+        if (pos >= m_json.size() || depth > kMaxDepth) {
+            return false;
+        }
+        switch (m_json[pos]) {
+        case '{':
+            return object(pos, depth + 1);
+        case '[':
+            return array(pos, depth + 1);
+        default:
+            pos = JsonScanner::skipValue(m_json, pos);
+            return pos >= 0;
+        }
+    }
+
+    bool object(qsizetype &pos, int depth)
+    {
+        pos = JsonScanner::skipWhitespace(m_json, pos + 1);
+        if (pos < m_json.size() && m_json[pos] == '}') {
+            ++pos;
+            return true;
+        }
+
+        while (pos < m_json.size()) {
+            if (m_json[pos] != '"') {
+                return false;
+            }
+            const qsizetype keyStart = pos + 1;
+            pos = JsonScanner::skipString(m_json, pos);
+            if (pos < 0) {
+                return false;
+            }
+            const QByteArray key = QByteArray::fromRawData(m_json.data() + keyStart, pos - 1 - keyStart);
+
+            pos = JsonScanner::skipWhitespace(m_json, pos);
+            if (pos >= m_json.size() || m_json[pos] != ':') {
+                return false;
+            }
+            pos = JsonScanner::skipWhitespace(m_json, pos + 1);
+
+            if (m_keys.contains(key)) {
+                if (!skipMember(pos)) {
+                    return false;
+                }
+            } else if (!value(pos, depth)) {
+                return false;
+            }
+
+            pos = JsonScanner::skipWhitespace(m_json, pos);
+            if (pos >= m_json.size()) {
+                return false;
+            }
+            if (m_json[pos] == '}') {
+                ++pos;
+                return true;
+            }
+            if (m_json[pos] != ',') {
+                return false;
+            }
+            pos = JsonScanner::skipWhitespace(m_json, pos + 1);
+        }
+        return false;
+    }
+
+    bool array(qsizetype &pos, int depth)
+    {
+        pos = JsonScanner::skipWhitespace(m_json, pos + 1);
+        if (pos < m_json.size() && m_json[pos] == ']') {
+            ++pos;
+            return true;
+        }
+
+        while (pos < m_json.size()) {
+            if (!value(pos, depth)) {
+                return false;
+            }
+            pos = JsonScanner::skipWhitespace(m_json, pos);
+            if (pos >= m_json.size()) {
+                return false;
+            }
+            if (m_json[pos] == ']') {
+                ++pos;
+                return true;
+            }
+            if (m_json[pos] != ',') {
+                return false;
+            }
+            pos = JsonScanner::skipWhitespace(m_json, pos + 1);
+        }
+        return false;
+    }
+
+    bool skipMember(qsizetype &pos)
+    {
+        const qsizetype valueStart = pos;
+        const qsizetype valueEnd = JsonScanner::skipValue(m_json, pos);
+        if (valueEnd < 0) {
+            return false;
+        }
+        pos = valueEnd;
+
+        QByteArrayView replacement;
+        switch (m_json[valueStart]) {
+        case '[': replacement = "[]"; break;
+        case '{': replacement = "{}"; break;
+        case '"': replacement = "\"\""; break;
+        default: return true; // Scalars are already as small as they get
+        }
+
+        if (m_out.isNull()) {
+            m_out.reserve(m_json.size());
+        }
+        m_out.append(m_json.sliced(m_copyFrom, valueStart - m_copyFrom));
+        m_out.append(replacement);
+        m_copyFrom = valueEnd;
+        m_skipped += (valueEnd - valueStart) - replacement.size();
+        return true;
+    }
+
+    QByteArrayView m_json;
+    const QSet<QByteArray> &m_keys;
+    QByteArray m_out;
+    qsizetype m_copyFrom = 0;
+    qsizetype m_skipped = 0;
+};
+
+} // namespace
+
+JsonSkipMatcher::JsonSkipMatcher(const JsonSkipRules &rules)
+{
+    m_rules.reserve(rules.size());
+    for (const JsonSkipRule &rule : rules) {
+        QRegularExpression pattern(QRegularExpression::wildcardToRegularExpression(rule.filePattern),
+                                   QRegularExpression::CaseInsensitiveOption);
+        // Compiled here rather than on the first match, which may come from several workers at once
+        pattern.optimize();
+        m_rules.append({std::move(pattern), rule.keys});
+    }
+}
+
+QSet<QByteArray> JsonSkipMatcher::keysForFile(const QString &fileName) const
+{
+    QSet<QByteArray> keys;
+    for (const CompiledRule &rule : m_rules) {
+        if (rule.pattern.match(fileName).hasMatch()) {
+            keys.unite(rule.keys);
+        }
+    }
+    return keys;
+}
+
+QByteArray JsonScanner::stripMembers(QByteArrayView json, const QSet<QByteArray> &skipKeys, qsizetype *skippedBytes)
+{
+    if (skippedBytes) {
+        *skippedBytes = 0;
+    }
+    if (skipKeys.isEmpty()) {
+        return QByteArray();
+    }
+
+    MemberStripper stripper(json, skipKeys);
+    if (!stripper.run()) {
+        return QByteArray();
+    }
+
+    if (skippedBytes) {
+        *skippedBytes = stripper.skippedBytes();
+    }
+    return stripper.result();
+}
+
+qsizetype JsonScanner::skipWhitespace(QByteArrayView json, qsizetype pos)
+{
+    const qsizetype size = json.size();
+    while (pos < size && isJsonWhitespace(json[pos])) {
+        ++pos;
+    }
+    return pos;
+}
+
+qsizetype JsonScanner::skipString(QByteArrayView json, qsizetype pos)
+{
+    const char *data = json.data();
+    const qsizetype size = json.size();
+    for (qsizetype i = pos + 1; i < size; ++i) {
+        const char c = data[i];
+        if (c == '"') {
+            return i + 1;
+        }
+        if (c == '\\') {
+            ++i; // Skip the escaped byte; \uXXXX digits need no special handling
+        }
+    }
+    return -1;
+}
+
+qsizetype JsonScanner::skipValue(QByteArrayView json, qsizetype pos)
+{
+    const char *data = json.data();
+    const qsizetype size = json.size();
+    if (pos >= size) {
+        return -1;
+    }
+
+    const char first = data[pos];
+    if (first == '"') {
+        return skipString(json, pos);
+    }
+
+    if (first == '[' || first == '{') {
+        // Bracket counting is all we need: strings are the only place brackets may appear
+        // without nesting, and they are skipped as a whole.
+        int depth = 0;
+        for (qsizetype i = pos; i < size; ++i) {
+            const char c = data[i];
+            if (c == '"') {
+                i = skipString(json, i);
+                if (i < 0) {
+                    return -1;
+                }
+                --i;
+            } else if (c == '[' || c == '{') {
+                ++depth;
+            } else if (c == ']' || c == '}') {
+                if (--depth == 0) {
+                    return i + 1;
+                }
+            }
+        }
+        return -1;
+    }
+
+    // Number, true, false or null
+    qsizetype i = pos;
+    while (i < size) {
+        const char c = data[i];
+        if (c == ',' || c == ']' || c == '}' || isJsonWhitespace(c)) {
+            break;
+        }
+        ++i;
+    }
+    return i > pos ? i : -1;
+}
+
+QByteArray JsonScanner::escapeString(QStringView text)
+{
+    static const char hexDigits[] = "0123456789abcdef";
+
+    const QByteArray utf8 = text.toUtf8();
+    QByteArray out;
+    out.reserve(utf8.size() + 2);
+    out.append('"');
+    for (const char c : utf8) {
+        switch (c) {
+        case '"': out.append("\\\""); break;
+        case '\\': out.append("\\\\"); break;
+        case '\b': out.append("\\b"); break;
+        case '\f': out.append("\\f"); break;
+        case '\n': out.append("\\n"); break;
+        case '\r': out.append("\\r"); break;
+        case '\t': out.append("\\t"); break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                out.append("\\u00");
+                out.append(hexDigits[(c >> 4) & 0xf]);
+                out.append(hexDigits[c & 0xf]);
+            } else {
+                out.append(c); // Non-ASCII stays raw UTF-8
+            }
+            break;
+        }
+    }
+    out.append('"');
+    return out;
+}
+
+QByteArray JsonScanner::applySplices(QByteArrayView json, QList<JsonSplice> splices)
+{
+    std::sort(splices.begin(), splices.end(), [](const JsonSplice &a, const JsonSplice &b) {
+        return a.span.offset < b.span.offset;
+    });
+
+    QByteArray out;
+    out.reserve(json.size());
+    qsizetype copyFrom = 0;
+    for (const JsonSplice &splice : splices) {
+        const JsonSpan &span = splice.span;
+        if (span.offset < copyFrom || span.length < 0 || span.offset + span.length > json.size()) {
+            return QByteArray();
+        }
+        out.append(json.sliced(copyFrom, span.offset - copyFrom));
+        out.append(escapeString(splice.value));
+        copyFrom = span.offset + span.length;
+    }
+    out.append(json.sliced(copyFrom));
+    return out;
+}
+
+} // namespace core
@@ -0,0 +1,99 @@
+#include "core/keypath.h"
+
+namespace core {
+
+namespace {
+
+bool isAllDigits(QStringView text)
+{
+    if (text.isEmpty()) {
+        return false;
+    }
+    for (QChar c : text) {
+        if (c < u'0' || c > u'9') {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+QString KeyPath::toString() const
+{
+    QString result;
+    for (qsizetype i = 0; i < m_segments.size(); ++i) {
+        const Segment &segment = m_segments.at(i);
+        if (segment.isIndex()) {
+            // Indices into a root array are written bare ("1.list"), all others in brackets
+            if (i == 0) {
+                result += QString::number(segment.index);
+            } else {
+                result += u'[';
+                result += QString::number(segment.index);
+                result += u']';
+            }
+        } else {
+            if (i > 0) {
+                result += u'.';
+            }
+            result += segment.key;
+        }
+    }
+    return result;
+}
+
+KeyPath KeyPath::fromString(QStringView text, bool *ok)
+{
+    KeyPath path;
+    bool valid = !text.isEmpty();
+    const qsizetype size = text.size();
+    qsizetype i = 0;
+
+    while (valid && i < size) {
+        if (text[i] == u'[') {
+            const qsizetype close = text.indexOf(u']', i + 1);
+            bool numberOk = false;
+            const qlonglong index = close > i ? text.sliced(i + 1, close - i - 1).toLongLong(&numberOk) : -1;
+            if (!numberOk || index < 0) {
+                valid = false;
+                break;
+            }
+            path.pushIndex(index);
+            i = close + 1;
+            continue;
+        }
+
+        if (!path.isEmpty()) {
+            if (text[i] != u'.') {
+                valid = false;
+                break;
+            }
+            ++i;
+        }
+
+        qsizetype end = i;
+        while (end < size && text[end] != u'.' && text[end] != u'[') {
+            ++end;
+        }
+        if (end == i) {
+            valid = false;
+            break;
+        }
+
+        const QStringView name = text.sliced(i, end - i);
+        if (path.isEmpty() && isAllDigits(name)) {
+            path.pushIndex(name.toLongLong());
+        } else {
+            path.pushKey(name.toString());
+        }
+        i = end;
+    }
+
+    if (ok) {
+        *ok = valid;
+    }
+    return valid ? path : KeyPath();
+}
+
+} // namespace core
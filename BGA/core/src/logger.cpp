@@ -0,0 +1,246 @@
+#include "core/logger.h"
+
+#include <QtCore/QDateTime>
+#include <QtCore/QFile>
+#include <QtCore/QStandardPaths>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace core {
+
+namespace {
+
+// Power of two so a position maps to its slot with a mask
+constexpr quint64 kCapacity = 8192;
+constexpr auto kDrainInterval = std::chrono::milliseconds(50);
+
+struct Record {
+    qint64 timestamp = 0;
+    LogLevel level = LogLevel::Info;
+    const char *category = nullptr;
+    QString message;
+};
+
+// Bounded multi-producer queue (Vyukov): a slot whose sequence equals the enqueue position is
+// free, one past it holds a record, and the writer hands it back for the next lap.
+struct Slot {
+    std::atomic<quint64> sequence{0};
+    Record record;
+};
+
+const char *levelName(LogLevel level)
+{
+    switch (level) {
+    case LogLevel::Trace: return "TRACE";
+    case LogLevel::Debug: return "DEBUG";
+    case LogLevel::Info: return "INFO ";
+    case LogLevel::Warning: return "WARN ";
+    case LogLevel::Error: return "ERROR";
+    case LogLevel::Off: break;
+    }
+    return "";
+}
+
+} // namespace
+
+struct Logger::Private {
+    Private()
+        : slots(new Slot[kCapacity])
+        , filePath(QStandardPaths::writableLocation(QStandardPaths::TempLocation) + QStringLiteral("/nst_log.txt"))
+    {
+        for (quint64 i = 0; i < kCapacity; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        writer = std::thread([this] { run(); });
+    }
+
+    bool push(Record &record)
+    {
+        quint64 pos = enqueuePos.load(std::memory_order_relaxed);
+        Slot *slot = nullptr;
+        for (;;) {
+            slot = &slots[pos & (kCapacity - 1)];
+            const quint64 sequence = slot->sequence.load(std::memory_order_acquire);
+            const qint64 diff = static_cast<qint64>(sequence - pos);
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // Full: the writer has not caught up with this lap yet
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+        slot->record = std::move(record);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Writer thread only
+    bool pop(Record &record)
+    {
+        Slot &slot = slots[dequeuePos & (kCapacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+            return false;
+        }
+        record = std::move(slot.record);
+        slot.sequence.store(dequeuePos + kCapacity, std::memory_order_release);
+        ++dequeuePos;
+        return true;
+    }
+
+    void drain(QFile &file)
+    {
+        QByteArray batch;
+        Record record;
+        while (pop(record)) {
+            batch += QDateTime::fromMSecsSinceEpoch(record.timestamp).toString(Qt::ISODateWithMs).toUtf8();
+            batch += ' ';
+            batch += levelName(record.level);
+            batch += " [";
+            batch += record.category;
+            batch += "] ";
+            batch += record.message.toUtf8();
+            batch += '\n';
+        }
+
+        const quint64 lost = dropped.load(std::memory_order_relaxed);
+        if (lost != reportedDropped) {
+            batch += QStringLiteral("%1 WARN  [log] %2 messages dropped, buffer full\n")
+                         .arg(QDateTime::currentDateTime().toString(Qt::ISODateWithMs))
+                         .arg(lost - reportedDropped)
+                         .toUtf8();
+            reportedDropped = lost;
+        }
+
+        if (!batch.isEmpty() && file.isOpen()) {
+            file.write(batch);
+            file.flush();
+        }
+    }
+
+    void run()
+    {
+        QFile file;
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            if (fileChanged) {
+                fileChanged = false;
+                file.close();
+                file.setFileName(filePath);
+                file.open(QIODevice::WriteOnly | QIODevice::Append);
+            }
+            const bool stop = stopping;
+
+            lock.unlock();
+            drain(file);
+            lock.lock();
+
+            written = dequeuePos;
+            flushed.notify_all();
+            if (stop) {
+                break;
+            }
+            wake.wait_for(lock, kDrainInterval, [this] { return stopping || fileChanged || flushTarget > written; });
+        }
+    }
+
+    std::unique_ptr<Slot[]> slots;
+    alignas(64) std::atomic<quint64> enqueuePos{0};
+    alignas(64) quint64 dequeuePos = 0;
+    std::atomic<quint64> dropped{0};
+    quint64 reportedDropped = 0;
+
+    // Only the writer's wake-ups, flush() and the file name take the mutex, never write()
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable flushed;
+    QString filePath;
+    bool fileChanged = true;
+    bool stopping = false;
+    quint64 flushTarget = 0;
+    quint64 written = 0;
+    std::thread writer;
+};
+
+Logger &Logger::instance()
+{
+    static Logger logger;
+    return logger;
+}
+
+Logger::Logger()
+    : d(std::make_unique<Private>())
+{
+}
+
+Logger::~Logger()
+{
+    shutdown();
+}
+
+void Logger::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(d->mutex);
+        if (d->stopping) {
+            return;
+        }
+        d->stopping = true;
+    }
+    // The writer drains what is queued once more before it exits
+    d->wake.notify_one();
+    if (d->writer.joinable()) {
+        d->writer.join();
+    }
+}
+
+void Logger::setLogFile(const QString &filePath)
+{
+    // Earlier records go to the old file, later ones to the new file
+    flush();
+    std::unique_lock<std::mutex> lock(d->mutex);
+    d->filePath = filePath;
+    d->fileChanged = true;
+    d->wake.notify_one();
+    d->flushed.wait(lock, [this] { return !d->fileChanged || d->stopping; });
+}
+
+QString Logger::logFile() const
+{
+    std::lock_guard<std::mutex> lock(d->mutex);
+    return d->filePath;
+}
+
+void Logger::write(LogLevel level, const char *category, QString message)
+{
+    Record record;
+    record.timestamp = QDateTime::currentMSecsSinceEpoch();
+    record.level = level;
+    record.category = category;
+    record.message = std::move(message);
+    if (!d->push(record)) {
+        d->dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Logger::flush()
+{
+    const quint64 target = d->enqueuePos.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(d->mutex);
+    d->flushTarget = std::max(d->flushTarget, target);
+    d->wake.notify_one();
+    d->flushed.wait(lock, [this, target] { return d->written >= target || d->stopping; });
+}
+
+quint64 Logger::droppedCount() const
+{
+    return d->dropped.load(std::memory_order_relaxed);
+}
+
+} // namespace core
@@ -0,0 +1,59 @@
+#include "core/mappedfile.h"
+
+namespace core {
+
+namespace {
+
+// Non-null pointer for an empty file, so isOpen() still reports success
+const char kEmpty[] = "";
+
+} // namespace
+
+bool MappedFile::open(const QString &filePath)
+{
+    close();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+
+    const qint64 fileSize = m_file.size();
+    if (fileSize >= MinimumMapSize) {
+        m_mapped = m_file.map(0, fileSize);
+        if (m_mapped) {
+            m_data = reinterpret_cast<const char *>(m_mapped);
+            m_size = fileSize;
+            return true;
+        }
+        // Not mappable (special file, exotic file system): fall back to reading it
+    }
+
+    m_buffer = m_file.readAll();
+    m_file.close();
+    if (m_buffer.isEmpty() && fileSize > 0) {
+        m_errorString = m_file.errorString();
+        return false;
+    }
+    m_data = m_buffer.isEmpty() ? kEmpty : m_buffer.constData();
+    m_size = m_buffer.size();
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (m_mapped) {
+        m_file.unmap(m_mapped);
+        m_mapped = nullptr;
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_buffer.clear();
+    m_data = nullptr;
+    m_size = 0;
+    m_errorString.clear();
+}
+
+} // namespace core
@@ -0,0 +1,42 @@
+#include "core/stringpool.h"
+
+namespace core {
+
+int StringPool::intern(const QString &text)
+{
+    const auto it = m_ids.constFind(text);
+    if (it != m_ids.constEnd()) {
+        return it.value();
+    }
+
+    const int id = static_cast<int>(m_strings.size());
+    m_strings.append(text);
+    m_ids.insert(m_strings.constLast(), id);
+    return id;
+}
+
+void StringPool::clear()
+{
+    m_strings.clear();
+    m_ids.clear();
+}
+
+QJsonArray StringPool::toJson() const
+{
+    return QJsonArray::fromStringList(m_strings);
+}
+
+StringPool StringPool::fromJson(const QJsonArray &array)
+{
+    StringPool pool;
+    pool.m_strings.reserve(array.size());
+    for (const QJsonValue &value : array) {
+        // Keep ids positional even if the array repeats a text
+        const QString text = value.toString();
+        pool.m_strings.append(text);
+        pool.m_ids.insert(text, static_cast<int>(pool.m_strings.size() - 1));
+    }
+    return pool;
+}
+
+} // namespace core
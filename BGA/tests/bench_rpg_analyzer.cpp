@@ -0,0 +1,470 @@
+#include <QtTest/QtTest>
+#include "core/engines/rpgm/rpganalyzer.h"
+#include "core/engines/rpgm/systemstringclassifier.h"
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QXmlStreamReader>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Count heap traffic for the allocation benchmarks. Replacing the global operators in the
+// executable also covers allocations made inside BGACore on ELF/Mach-O platforms; on Windows
+// the DLL keeps its own CRT heap and the byte counts only reflect this executable.
+static std::atomic<qint64> g_allocatedBytes{0};
+static std::atomic<qint64> g_allocationCount{0};
+
+void *operator new(std::size_t size)
+{
+    g_allocatedBytes.fetch_add(static_cast<qint64>(size), std::memory_order_relaxed);
+    g_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+class RpgAnalyzerBenchmarks : public QObject
+{
+    Q_OBJECT
+
+private:
+    struct CorpusFile {
+        QString path;
+        QJsonDocument doc;
+    };
+
+    // Corpus name ("RPGM", "RPGM-FR", ...) -> parsed data files
+    QMap<QString, QList<CorpusFile>> m_corpora;
+    // Corpus name -> data folder holding a copy of all its files, for analyze()
+    QMap<QString, QString> m_stagedCorpora;
+    QTemporaryDir m_workDir;
+    // Every string value of the corpora, in file order: what isSystemString() sees in practice
+    QStringList m_corpusStrings;
+    // The largest map of the corpora
+    QJsonObject m_largestMap;
+
+    static void collectStrings(const QJsonValue &value, QStringList &out)
+    {
+        if (value.isString()) {
+            out.append(value.toString());
+        } else if (value.isArray()) {
+            for (const QJsonValue &item : value.toArray()) {
+                collectStrings(item, out);
+            }
+        } else if (value.isObject()) {
+            const QJsonObject obj = value.toObject();
+            for (auto it = obj.constBegin(); it != obj.constEnd(); ++it) {
+                collectStrings(it.value(), out);
+            }
+        }
+    }
+
+    // `map` with its events repeated `scale` times under new ids
+    static QJsonObject scaledMap(const QJsonObject &map, int scale)
+    {
+        const QJsonArray events = map.value(QStringLiteral("events")).toArray();
+        QJsonArray scaled{QJsonValue::Null};
+        for (int copy = 0; copy < scale; ++copy) {
+            for (const QJsonValue &value : events) {
+                if (!value.isObject()) {
+                    continue;
+                }
+                QJsonObject event = value.toObject();
+                event.insert(QStringLiteral("id"), scaled.size());
+                scaled.append(event);
+            }
+        }
+        QJsonObject result = map;
+        result.insert(QStringLiteral("events"), scaled);
+        return result;
+    }
+
+    // A map-shaped file of `lines` dialogue commands (100 per event) and the updates of all of them
+    static QJsonArray writeSaveFixture(const QString &filePath, int lines)
+    {
+        QJsonArray events{QJsonValue::Null};
+        QJsonArray texts;
+        for (int first = 0; first < lines; first += 100) {
+            const int eventId = events.size();
+            QJsonArray list;
+            for (int i = first; i < qMin(first + 100, lines); ++i) {
+                list.append(QJsonObject{
+                    {QStringLiteral("code"), 401},
+                    {QStringLiteral("indent"), 0},
+                    {QStringLiteral("parameters"), QJsonArray{QStringLiteral("Line number %1 of the fixture").arg(i)}},
+                });
+                texts.append(QJsonObject{
+                    {QStringLiteral("path"), filePath},
+                    {QStringLiteral("key"), QStringLiteral("events[%1].pages[0].list[%2].parameters[0]").arg(eventId).arg(list.size() - 1)},
+                    {QStringLiteral("text"), QStringLiteral("Ligne numéro %1 du test").arg(i)},
+                });
+            }
+            list.append(QJsonObject{{QStringLiteral("code"), 0}, {QStringLiteral("indent"), 0}, {QStringLiteral("parameters"), QJsonArray{}}});
+            events.append(QJsonObject{
+                {QStringLiteral("id"), eventId},
+                {QStringLiteral("name"), QStringLiteral("EV%1").arg(eventId, 3, 10, QLatin1Char('0'))},
+                {QStringLiteral("pages"), QJsonArray{QJsonObject{{QStringLiteral("list"), list}}}},
+            });
+        }
+
+        QFile file(filePath);
+        if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            file.write(QJsonDocument(QJsonObject{{QStringLiteral("events"), events}}).toJson(QJsonDocument::Indented));
+        }
+        return texts;
+    }
+
+    static QJsonArray extractAll(core::engines::rpgm::RpgmAnalyzer &analyzer, const QList<CorpusFile> &files, bool variantRoundTrip)
+    {
+        QJsonArray all;
+        for (const CorpusFile &file : files) {
+            // The round trip reproduces what analyze() used to do before walking the document.
+            const QJsonArray strings = variantRoundTrip
+                ? analyzer.extractStrings(QJsonDocument::fromVariant(file.doc.toVariant()), file.path)
+                : analyzer.extractStrings(file.doc, file.path);
+            for (const QJsonValue &entry : strings) {
+                all.append(entry);
+            }
+        }
+        return all;
+    }
+
+    void addCorpusRows()
+    {
+        QTest::addColumn<QString>("corpus");
+        QTest::addColumn<bool>("variantRoundTrip");
+
+        for (auto it = m_corpora.constBegin(); it != m_corpora.constEnd(); ++it) {
+            QTest::newRow(qPrintable(it.key() + QStringLiteral("/variant-roundtrip"))) << it.key() << true;
+            QTest::newRow(qPrintable(it.key() + QStringLiteral("/direct"))) << it.key() << false;
+        }
+    }
+
+private slots:
+    void initTestCase()
+    {
+        QDir corpusRoot(QStringLiteral(BGA_TEST_CORPUS_DIR));
+        QVERIFY2(corpusRoot.exists(), qPrintable(corpusRoot.path()));
+
+        const QStringList corpusDirs = corpusRoot.entryList(QStringList{QStringLiteral("RPGM*")}, QDir::Dirs | QDir::NoDotAndDotDot);
+        for (const QString &corpus : corpusDirs) {
+            QDirIterator it(corpusRoot.filePath(corpus), QStringList{QStringLiteral("*.json")}, QDir::Files, QDirIterator::Subdirectories);
+            while (it.hasNext()) {
+                const QString path = it.next();
+                QFile file(path);
+                if (!file.open(QIODevice::ReadOnly)) {
+                    continue;
+                }
+                // RPGM-SyntaxError deliberately contains broken files; they have nothing to walk.
+                const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+                if (!doc.isNull()) {
+                    m_corpora[corpus].append({path, doc});
+                }
+            }
+        }
+
+        QVERIFY(!m_corpora.isEmpty());
+
+        qsizetype largestMapSize = -1;
+        for (const QList<CorpusFile> &files : std::as_const(m_corpora)) {
+            for (const CorpusFile &file : files) {
+                collectStrings(file.doc.isArray() ? QJsonValue(file.doc.array()) : QJsonValue(file.doc.object()), m_corpusStrings);
+                const QJsonObject obj = file.doc.object();
+                const qsizetype events = obj.value(QStringLiteral("events")).toArray().size();
+                if (QFileInfo(file.path).fileName().startsWith(QLatin1String("Map")) && events > largestMapSize) {
+                    largestMapSize = events;
+                    m_largestMap = obj;
+                }
+            }
+        }
+        QVERIFY(!m_largestMap.isEmpty());
+
+        // The corpora are loose files in arbitrary folders; analyze() expects a data folder
+        QVERIFY(m_workDir.isValid());
+        for (auto it = m_corpora.constBegin(); it != m_corpora.constEnd(); ++it) {
+            const QDir dataDir(m_workDir.filePath(it.key() + QStringLiteral("/data")));
+            QVERIFY(QDir().mkpath(dataDir.path()));
+            QDirIterator files(corpusRoot.filePath(it.key()), QStringList{QStringLiteral("*.json")}, QDir::Files, QDirIterator::Subdirectories);
+            while (files.hasNext()) {
+                const QFileInfo source(files.next());
+                QString name = source.fileName();
+                for (int suffix = 2; dataDir.exists(name); ++suffix) {
+                    name = source.completeBaseName() + QStringLiteral("_%1.json").arg(suffix);
+                }
+                QVERIFY(QFile::copy(source.filePath(), dataDir.filePath(name)));
+            }
+            m_stagedCorpora.insert(it.key(), dataDir.path());
+        }
+    }
+
+    void extractionTime_data()
+    {
+        addCorpusRows();
+    }
+
+    void extractionTime()
+    {
+        QFETCH(QString, corpus);
+        QFETCH(bool, variantRoundTrip);
+
+        core::engines::rpgm::RpgmAnalyzer analyzer;
+        const QList<CorpusFile> &files = m_corpora[corpus];
+
+        QBENCHMARK {
+            QJsonArray strings = extractAll(analyzer, files, variantRoundTrip);
+            Q_UNUSED(strings);
+        }
+    }
+
+    void extractionAllocations_data()
+    {
+        addCorpusRows();
+    }
+
+    void extractionAllocations()
+    {
+        QFETCH(QString, corpus);
+        QFETCH(bool, variantRoundTrip);
+
+        core::engines::rpgm::RpgmAnalyzer analyzer;
+        const QList<CorpusFile> &files = m_corpora[corpus];
+
+        const qint64 bytesBefore = g_allocatedBytes.load();
+        const qint64 countBefore = g_allocationCount.load();
+        const QJsonArray strings = extractAll(analyzer, files, variantRoundTrip);
+        const qint64 bytes = g_allocatedBytes.load() - bytesBefore;
+        const qint64 count = g_allocationCount.load() - countBefore;
+
+        qInfo() << corpus << (variantRoundTrip ? "variant-roundtrip" : "direct")
+                << "entries:" << strings.size() << "allocations:" << count;
+        QTest::setBenchmarkResult(bytes, QTest::BytesAllocated);
+    }
+
+    void extractLargeMap_data()
+    {
+        QTest::addColumn<int>("scale");
+        QTest::newRow("x1") << 1;
+        QTest::newRow("x10") << 10;
+        QTest::newRow("x50") << 50;
+    }
+
+    void extractLargeMap()
+    {
+        // extractStrings() is the public entry of extractStringsFromJsonValue()
+        QFETCH(int, scale);
+
+        core::engines::rpgm::RpgmAnalyzer analyzer;
+        const QJsonDocument map(scaledMap(m_largestMap, scale));
+        const QString path = QStringLiteral("Map001.json");
+
+        qsizetype entries = 0;
+        QBENCHMARK {
+            entries = analyzer.extractStrings(map, path).size();
+        }
+        QVERIFY(entries > 0);
+    }
+
+    void isSystemString_data()
+    {
+        QTest::addColumn<bool>("reference");
+        QTest::newRow("classifier") << false;
+        QTest::newRow("reference") << true;
+    }
+
+    void isSystemString()
+    {
+        using core::engines::rpgm::SystemStringClassifier;
+        QFETCH(bool, reference);
+
+        int systemStrings = 0;
+        QBENCHMARK {
+            systemStrings = 0;
+            for (const QString &text : std::as_const(m_corpusStrings)) {
+                const bool isSystem = reference ? SystemStringClassifier::isSystemStringReference(text)
+                                                : SystemStringClassifier::isSystemString(text);
+                systemStrings += isSystem ? 1 : 0;
+            }
+        }
+        QVERIFY(systemStrings > 0);
+    }
+
+    void saveUpdates_data()
+    {
+        using SaveMode = core::engines::rpgm::RpgmAnalyzer::SaveMode;
+        QTest::addColumn<int>("updates");
+        QTest::addColumn<int>("saveMode");
+        for (int updates : {1000, 10000}) {
+            const QString size = QStringLiteral("%1k").arg(updates / 1000);
+            QTest::newRow(qPrintable(size + QStringLiteral("/patch"))) << updates << int(SaveMode::Patch);
+            QTest::newRow(qPrintable(size + QStringLiteral("/reserialize"))) << updates << int(SaveMode::Reserialize);
+        }
+    }
+
+    void saveUpdates()
+    {
+        QFETCH(int, updates);
+        QFETCH(int, saveMode);
+
+        const QString filePath = m_workDir.filePath(QStringLiteral("save/Map001.json"));
+        QVERIFY(QDir().mkpath(QFileInfo(filePath).path()));
+        const QJsonArray texts = writeSaveFixture(filePath, updates);
+        QCOMPARE(texts.size(), updates);
+
+        // Every iteration writes the same translations again: the paths resolve the same way
+        core::engines::rpgm::RpgmAnalyzer analyzer;
+        analyzer.setSaveMode(static_cast<core::engines::rpgm::RpgmAnalyzer::SaveMode>(saveMode));
+        bool saved = false;
+        QBENCHMARK {
+            saved = analyzer.save(QFileInfo(filePath).path(), texts);
+        }
+        QVERIFY(saved);
+    }
+
+    void analyzeCorpus_data()
+    {
+        QTest::addColumn<QString>("corpus");
+        for (auto it = m_stagedCorpora.constBegin(); it != m_stagedCorpora.constEnd(); ++it) {
+            QTest::newRow(qPrintable(it.key())) << it.key();
+        }
+    }
+
+    void analyzeCorpus()
+    {
+        QFETCH(QString, corpus);
+        const QString dataPath = m_stagedCorpora.value(corpus);
+
+        QBENCHMARK {
+            // A fresh analyzer per run: no spans or cache carried over
+            core::engines::rpgm::RpgmAnalyzer analyzer;
+            const core::AnalyzerOutput output = analyzer.analyze(dataPath);
+            QVERIFY(!output.payload.isEmpty());
+        }
+    }
+
+    void extractionOutputMatches_data()
+    {
+        QTest::addColumn<QString>("corpus");
+        for (auto it = m_corpora.constBegin(); it != m_corpora.constEnd(); ++it) {
+            QTest::newRow(qPrintable(it.key())) << it.key();
+        }
+    }
+
+    void extractionOutputMatches()
+    {
+        // The direct walk must see exactly what the variant round trip saw.
+        QFETCH(QString, corpus);
+
+        core::engines::rpgm::RpgmAnalyzer analyzer;
+        const QList<CorpusFile> &files = m_corpora[corpus];
+        QCOMPARE(extractAll(analyzer, files, false), extractAll(analyzer, files, true));
+    }
+};
+
+namespace {
+
+// Converts the XML log of a run into {"revision", "timestamp", "qtVersion", "results": [...]}
+// with one {"function", "tag", "metric", "value", "iterations"} object per benchmark result.
+bool writeJsonReport(const QString &xmlPath, const QString &jsonPath)
+{
+    QFile xmlFile(xmlPath);
+    if (!xmlFile.open(QIODevice::ReadOnly)) {
+        qWarning() << "No benchmark log at" << xmlPath;
+        return false;
+    }
+
+    QJsonArray results;
+    QString function;
+    QXmlStreamReader xml(&xmlFile);
+    while (!xml.atEnd()) {
+        if (xml.readNext() != QXmlStreamReader::StartElement) {
+            continue;
+        }
+        const QXmlStreamAttributes attributes = xml.attributes();
+        if (xml.name() == QLatin1String("TestFunction")) {
+            function = attributes.value(QLatin1String("name")).toString();
+        } else if (xml.name() == QLatin1String("BenchmarkResult")) {
+            results.append(QJsonObject{
+                {QStringLiteral("function"), function},
+                {QStringLiteral("tag"), attributes.value(QLatin1String("tag")).toString()},
+                {QStringLiteral("metric"), attributes.value(QLatin1String("metric")).toString()},
+                {QStringLiteral("value"), attributes.value(QLatin1String("value")).toDouble()},
+                {QStringLiteral("iterations"), attributes.value(QLatin1String("iterations")).toInt()},
+            });
+        }
+    }
+    if (xml.hasError()) {
+        qWarning() << "Unreadable benchmark log:" << xml.errorString();
+        return false;
+    }
+
+    const QJsonObject report{
+        // Set by the caller (e.g. to `git rev-parse HEAD`) so runs can be matched to commits
+        {QStringLiteral("revision"), qEnvironmentVariable("BGA_BENCHMARK_REVISION")},
+        {QStringLiteral("timestamp"), QDateTime::currentDateTimeUtc().toString(Qt::ISODate)},
+        {QStringLiteral("qtVersion"), QString::fromLatin1(qVersion())},
+        {QStringLiteral("results"), results},
+    };
+
+    QFile jsonFile(jsonPath);
+    if (!jsonFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Failed to open" << jsonPath;
+        return false;
+    }
+    jsonFile.write(QJsonDocument(report).toJson(QJsonDocument::Indented));
+    return true;
+}
+
+} // namespace
+
+// QTEST_MAIN, plus "-json <file>" to also export the results as JSON. QtTest has no JSON
+// logger, so the run is additionally logged as XML and converted afterwards.
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTEST_SET_MAIN_SOURCE_PATH
+
+    QStringList args = app.arguments();
+    QString jsonPath;
+    const qsizetype jsonIndex = args.indexOf(QStringLiteral("-json"));
+    if (jsonIndex > 0 && jsonIndex + 1 < args.size()) {
+        jsonPath = args.at(jsonIndex + 1);
+        args.remove(jsonIndex, 2);
+    }
+
+    QTemporaryDir logDir;
+    const QString xmlPath = logDir.filePath(QStringLiteral("results.xml"));
+    if (!jsonPath.isEmpty()) {
+        // With several loggers every one needs "-o"; keep the console output by default
+        if (!args.contains(QStringLiteral("-o"))) {
+            args << QStringLiteral("-o") << QStringLiteral("-,txt");
+        }
+        args << QStringLiteral("-o") << xmlPath + QStringLiteral(",xml");
+    }
+
+    RpgAnalyzerBenchmarks benchmarks;
+    const int result = QTest::qExec(&benchmarks, args);
+    if (!jsonPath.isEmpty() && !writeJsonReport(xmlPath, jsonPath)) {
+        return result != 0 ? result : EXIT_FAILURE;
+    }
+    return result;
+}
+
+#include "bench_rpg_analyzer.moc"
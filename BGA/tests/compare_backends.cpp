@@ -0,0 +1,377 @@
+// Differential benchmark of the analyzer backends: the legacy C++ RpgmAnalyzer and the Rust
+// engine behind RustAnalyzerBridge. Every Unit-Test/RPGM* corpus, and scaled-up copies of the
+// corpora that have maps, is analyzed by both; each run happens in a child process so its
+// peak RSS is its own. Exits with 1 if the backends extracted different entries.
+
+#include "core/analyzerpayload.h"
+#include "core/bga_rust_bridge.h"
+#include "core/engines/rpgm/rpganalyzer.h"
+
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QDirIterator>
+#include <QtCore/QElapsedTimer>
+#include <QtCore/QFile>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QProcess>
+#include <QtCore/QRegularExpression>
+#include <QtCore/QSet>
+#include <QtCore/QTemporaryDir>
+#include <QtCore/QTextStream>
+
+#include <algorithm>
+#include <utility>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+const QStringList kBackends = {QStringLiteral("cpp"), QStringLiteral("rust")};
+
+struct RunResult {
+    QString error;
+    double wallMs = 0;
+    qint64 peakRssBytes = -1;
+    qint64 entries = 0;
+    QSet<QByteArray> entrySet;
+};
+
+qint64 peakRssBytes()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<qint64>(counters.PeakWorkingSetSize);
+    }
+    return -1;
+#elif defined(Q_OS_UNIX)
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return -1;
+    }
+#if defined(Q_OS_DARWIN)
+    return static_cast<qint64>(usage.ru_maxrss); // bytes
+#else
+    return static_cast<qint64>(usage.ru_maxrss) * 1024; // kilobytes
+#endif
+#else
+    return -1;
+#endif
+}
+
+// Child process: analyze `dataPath` with one backend, write its entries (one compact JSON
+// array [path, key, source] per line, paths relative to `dataPath`) to `entriesPath` and print
+// the measurements as one JSON object.
+int runWorker(const QString &backend, const QString &dataPath, const QString &entriesPath, int threads)
+{
+    std::unique_ptr<core::IGameAnalyzer> analyzer;
+    if (backend == QLatin1String("cpp")) {
+        analyzer = std::make_unique<core::engines::rpgm::RpgmAnalyzer>();
+    } else {
+        analyzer = core::createRustAnalyzer(QStringLiteral("rpgm"));
+    }
+    analyzer->setParallelism(threads);
+
+    QJsonObject report;
+    QElapsedTimer timer;
+    timer.start();
+
+    // Decoding is part of the run: the application cannot use a payload it has not read
+    const core::AnalyzerOutput output = analyzer->analyze(dataPath);
+    QJsonObject root;
+    QString errorMessage = output.errorMessage;
+    if (errorMessage.isEmpty()) {
+        core::AnalyzerPayload::decode(output, &root, &errorMessage);
+    }
+    const QList<core::AnalyzerPayload::FileRecord> files = core::AnalyzerPayload::files(root);
+
+    report.insert(QStringLiteral("wallMs"), timer.nsecsElapsed() / 1e6);
+    report.insert(QStringLiteral("peakRssBytes"), peakRssBytes());
+    if (!errorMessage.isEmpty()) {
+        report.insert(QStringLiteral("error"), errorMessage);
+    }
+
+    const QDir dataDir(dataPath);
+    QList<QByteArray> lines;
+    for (const core::AnalyzerPayload::FileRecord &file : files) {
+        const QString relativePath = dataDir.relativeFilePath(file.path);
+        for (const QJsonValue &value : file.entries) {
+            const QJsonObject entry = value.toObject();
+            const QJsonArray line{relativePath, entry.value(QStringLiteral("key")), entry.value(QStringLiteral("source"))};
+            lines.append(QJsonDocument(line).toJson(QJsonDocument::Compact));
+        }
+    }
+    report.insert(QStringLiteral("entries"), lines.size());
+
+    std::sort(lines.begin(), lines.end());
+    QFile entriesFile(entriesPath);
+    if (!entriesFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        QTextStream(stderr) << "Failed to open " << entriesPath << '\n';
+        return EXIT_FAILURE;
+    }
+    for (const QByteArray &line : std::as_const(lines)) {
+        entriesFile.write(line);
+        entriesFile.write("\n");
+    }
+    entriesFile.close();
+
+    QTextStream(stdout) << QJsonDocument(report).toJson(QJsonDocument::Compact) << '\n';
+    return EXIT_SUCCESS;
+}
+
+RunResult runBackend(const QString &backend, const QString &dataPath, const QString &entriesPath, int threads)
+{
+    RunResult result;
+
+    QProcess worker;
+    worker.setProcessChannelMode(QProcess::ForwardedErrorChannel);
+    worker.start(QCoreApplication::applicationFilePath(),
+                 {QStringLiteral("--worker"), backend, QStringLiteral("--threads"), QString::number(threads),
+                  dataPath, entriesPath});
+    if (!worker.waitForFinished(-1) || worker.exitStatus() != QProcess::NormalExit || worker.exitCode() != 0) {
+        result.error = QStringLiteral("worker failed: %1").arg(worker.errorString());
+        return result;
+    }
+
+    // The report is the last line; anything a backend printed before it is ignored
+    const QByteArray output = worker.readAllStandardOutput().trimmed();
+    const QJsonObject report = QJsonDocument::fromJson(output.mid(output.lastIndexOf('\n') + 1)).object();
+    if (report.isEmpty()) {
+        result.error = QStringLiteral("worker printed no report");
+        return result;
+    }
+    result.error = report.value(QStringLiteral("error")).toString();
+    result.wallMs = report.value(QStringLiteral("wallMs")).toDouble();
+    result.peakRssBytes = report.value(QStringLiteral("peakRssBytes")).toInteger(-1);
+    result.entries = report.value(QStringLiteral("entries")).toInteger();
+
+    QFile entriesFile(entriesPath);
+    if (entriesFile.open(QIODevice::ReadOnly)) {
+        while (!entriesFile.atEnd()) {
+            result.entrySet.insert(entriesFile.readLine().chopped(1));
+        }
+    }
+    return result;
+}
+
+// Copies every data file of `corpusPath` (at any depth) into `dataPath`. Map files are copied
+// `scale` times under new map numbers; names taken by an earlier file get a numeric suffix.
+// Returns the number of files written.
+int stageCorpus(const QString &corpusPath, const QString &dataPath, int scale)
+{
+    static const QRegularExpression mapPattern(QStringLiteral("^Map\\d+\\.json$"), QRegularExpression::CaseInsensitiveOption);
+
+    QDir().mkpath(dataPath);
+    const QDir dataDir(dataPath);
+
+    QStringList sources;
+    QDirIterator it(corpusPath, QStringList{QStringLiteral("*.json")}, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        sources.append(it.next());
+    }
+    sources.sort(); // Same staging on every platform
+
+    int written = 0;
+    int nextMapId = 1;
+    auto copyAs = [&](const QString &source, const QString &baseName) {
+        QString name = baseName;
+        for (int suffix = 2; dataDir.exists(name); ++suffix) {
+            name = QFileInfo(baseName).completeBaseName() + QStringLiteral("_%1.json").arg(suffix);
+        }
+        if (QFile::copy(source, dataDir.filePath(name))) {
+            ++written;
+        }
+    };
+
+    for (const QString &source : std::as_const(sources)) {
+        const QString fileName = QFileInfo(source).fileName();
+        if (!mapPattern.match(fileName).hasMatch()) {
+            copyAs(source, fileName);
+            continue;
+        }
+        for (int copy = 0; copy < scale; ++copy) {
+            copyAs(source, QStringLiteral("Map%1.json").arg(nextMapId++, 3, 10, QLatin1Char('0')));
+        }
+    }
+    return written;
+}
+
+bool hasMaps(const QString &corpusPath)
+{
+    QDirIterator it(corpusPath, QStringList{QStringLiteral("Map[0-9]*.json")}, QDir::Files, QDirIterator::Subdirectories);
+    return it.hasNext();
+}
+
+QString formatRow(const QString &project, const QString &backend, const RunResult &run)
+{
+    const double seconds = run.wallMs / 1000.0;
+    const QString rss = run.peakRssBytes >= 0 ? QString::number(run.peakRssBytes / (1024.0 * 1024.0), 'f', 1) : QStringLiteral("n/a");
+    const QString rate = seconds > 0 ? QString::number(qRound64(run.entries / seconds)) : QStringLiteral("n/a");
+    return QStringLiteral("%1 %2 %3 %4 %5 %6")
+        .arg(project, -24)
+        .arg(backend, -7)
+        .arg(QString::number(run.wallMs, 'f', 1), 10)
+        .arg(rss, 10)
+        .arg(run.entries, 9)
+        .arg(rate, 12);
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("BGA Backend Comparison"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Runs the C++ and Rust RPG Maker analyzers on the same projects and compares speed, memory and output"));
+    parser.addHelpOption();
+
+    QCommandLineOption corpusOption(QStringLiteral("corpus"),
+                                    QStringLiteral("Directory holding the RPGM* corpora (default: Unit-Test)."),
+                                    QStringLiteral("dir"),
+                                    QStringLiteral(BGA_TEST_CORPUS_DIR));
+    parser.addOption(corpusOption);
+
+    QCommandLineOption projectOption(QStringLiteral("project"),
+                                     QStringLiteral("Additional data folder to compare as it is, e.g. a generated project. Repeatable."),
+                                     QStringLiteral("dir"));
+    parser.addOption(projectOption);
+
+    QCommandLineOption scaleOption(QStringLiteral("scale"),
+                                   QStringLiteral("Comma-separated copy counts of the corpus maps for the synthetic projects; 0 for none (default: 10)."),
+                                   QStringLiteral("factors"),
+                                   QStringLiteral("10"));
+    parser.addOption(scaleOption);
+
+    QCommandLineOption threadsOption(QStringList{QStringLiteral("j"), QStringLiteral("threads")},
+                                     QStringLiteral("Worker threads of the Rust backend; 0 for one per core (default: 0)."),
+                                     QStringLiteral("count"),
+                                     QStringLiteral("0"));
+    parser.addOption(threadsOption);
+
+    QCommandLineOption diffLimitOption(QStringLiteral("max-diff"),
+                                       QStringLiteral("Differing entries to print per project and side (default: 5)."),
+                                       QStringLiteral("count"),
+                                       QStringLiteral("5"));
+    parser.addOption(diffLimitOption);
+
+    QCommandLineOption workerOption(QStringLiteral("worker"), QStringLiteral("Internal: run one backend."), QStringLiteral("backend"));
+    workerOption.setFlags(QCommandLineOption::HiddenFromHelp);
+    parser.addOption(workerOption);
+
+    parser.process(app);
+
+    const int threads = qMax(0, parser.value(threadsOption).toInt());
+    const QStringList args = parser.positionalArguments();
+
+    if (parser.isSet(workerOption)) {
+        if (args.size() != 2 || !kBackends.contains(parser.value(workerOption))) {
+            return EXIT_FAILURE;
+        }
+        return runWorker(parser.value(workerOption), args.at(0), args.at(1), threads);
+    }
+
+    QList<int> scales;
+    for (const QString &factor : parser.value(scaleOption).split(QLatin1Char(','), Qt::SkipEmptyParts)) {
+        const int scale = factor.trimmed().toInt();
+        if (scale > 0) {
+            scales.append(scale);
+        }
+    }
+
+    QTemporaryDir workDir;
+    if (!workDir.isValid()) {
+        QTextStream(stderr) << "Failed to create a temporary directory" << '\n';
+        return EXIT_FAILURE;
+    }
+
+    // Project name -> data folder handed to both backends
+    QList<std::pair<QString, QString>> projects;
+    const QDir corpusRoot(parser.value(corpusOption));
+    const QStringList corpora = corpusRoot.entryList(QStringList{QStringLiteral("RPGM*")}, QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+    for (const QString &corpus : corpora) {
+        // The corpora are loose files in arbitrary folders; both backends expect a data folder
+        const QString corpusPath = corpusRoot.filePath(corpus);
+        const QString dataPath = workDir.filePath(corpus + QStringLiteral("/data"));
+        if (stageCorpus(corpusPath, dataPath, 1) > 0) {
+            projects.append({corpus, dataPath});
+        }
+        if (!hasMaps(corpusPath)) {
+            continue;
+        }
+        for (int scale : std::as_const(scales)) {
+            const QString name = QStringLiteral("%1-x%2").arg(corpus).arg(scale);
+            const QString scaledPath = workDir.filePath(name + QStringLiteral("/data"));
+            if (stageCorpus(corpusPath, scaledPath, scale) > 0) {
+                projects.append({name, scaledPath});
+            }
+        }
+    }
+    for (const QString &project : parser.values(projectOption)) {
+        projects.append({QFileInfo(project).absoluteFilePath(), QFileInfo(project).absoluteFilePath()});
+    }
+
+    if (projects.isEmpty()) {
+        QTextStream(stderr) << "No RPGM* corpus found in " << corpusRoot.path() << '\n';
+        return EXIT_FAILURE;
+    }
+
+    const int diffLimit = qMax(0, parser.value(diffLimitOption).toInt());
+    QTextStream out(stdout);
+    out << QStringLiteral("%1 %2 %3 %4 %5 %6")
+               .arg(QStringLiteral("project"), -24)
+               .arg(QStringLiteral("backend"), -7)
+               .arg(QStringLiteral("wall ms"), 10)
+               .arg(QStringLiteral("RSS MiB"), 10)
+               .arg(QStringLiteral("entries"), 9)
+               .arg(QStringLiteral("entries/s"), 12)
+        << '\n';
+
+    bool allMatch = true;
+    for (const auto &[name, dataPath] : std::as_const(projects)) {
+        QMap<QString, RunResult> runs;
+        for (const QString &backend : kBackends) {
+            const QString entriesPath = workDir.filePath(QStringLiteral("entries-%1.txt").arg(backend));
+            runs.insert(backend, runBackend(backend, dataPath, entriesPath, threads));
+            const RunResult &run = runs[backend];
+            out << formatRow(name, backend, run) << '\n';
+            if (!run.error.isEmpty()) {
+                // A backend that failed has nothing to compare, which is a mismatch too
+                out << "    error: " << run.error << '\n';
+                allMatch = false;
+            }
+        }
+        out.flush();
+
+        const QSet<QByteArray> &cppEntries = runs[QStringLiteral("cpp")].entrySet;
+        const QSet<QByteArray> &rustEntries = runs[QStringLiteral("rust")].entrySet;
+        if (cppEntries == rustEntries) {
+            continue;
+        }
+        allMatch = false;
+
+        const auto report = [&](const char *side, const QSet<QByteArray> &mine, const QSet<QByteArray> &theirs) {
+            QList<QByteArray> only = QSet<QByteArray>(mine).subtract(theirs).values();
+            if (only.isEmpty()) {
+                return;
+            }
+            std::sort(only.begin(), only.end());
+            out << "    " << only.size() << " entries only in " << side << '\n';
+            for (qsizetype i = 0; i < qMin<qsizetype>(diffLimit, only.size()); ++i) {
+                out << "      " << QString::fromUtf8(only.at(i)) << '\n';
+            }
+        };
+        report("cpp", cppEntries, rustEntries);
+        report("rust", rustEntries, cppEntries);
+    }
+
+    return allMatch ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,193 @@
+#include <QtTest/QtTest>
+#include "core/documentcache.h"
+#include "core/jsonscanner.h"
+#include "core/keypath.h"
+#include "core/logger.h"
+#include "core/mappedfile.h"
+#include "core/stringpool.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QTemporaryDir>
+
+class TestCoreUtilities : public QObject
+{
+    Q_OBJECT
+
+private:
+    std::unique_ptr<QTemporaryDir> tempDir;
+
+    QString filePath(const QString &fileName) const { return tempDir->filePath(fileName); }
+
+    bool writeFile(const QString &fileName, const QByteArray &content) const
+    {
+        QFile file(filePath(fileName));
+        return file.open(QIODevice::WriteOnly) && file.write(content) == content.size();
+    }
+
+private slots:
+    void init()
+    {
+        tempDir = std::make_unique<QTemporaryDir>();
+        QVERIFY(tempDir->isValid());
+    }
+
+    void testKeyPathRoundTrip()
+    {
+        const QStringList paths = {
+            "1.list[0].parameters[0]",
+            "1.pages[0].list[3].parameters[0][2]",
+            "terms.messages.actionFailure",
+            "0[1]",
+            "parameters[4]"
+        };
+        for (const QString &text : paths) {
+            bool ok = false;
+            const core::KeyPath path = core::KeyPath::fromString(text, &ok);
+            QVERIFY2(ok, qPrintable(text));
+            QCOMPARE(path.toString(), text);
+        }
+
+        bool ok = true;
+        QVERIFY(core::KeyPath::fromString(u"list[x]", &ok).isEmpty());
+        QVERIFY(!ok);
+        QVERIFY(core::KeyPath::fromString(u"list..name", &ok).isEmpty());
+        QVERIFY(!ok);
+    }
+
+    void testSkipMatcher()
+    {
+        const core::JsonSkipMatcher matcher({{QStringLiteral("Map*.json"), {"data"}},
+                                             {QStringLiteral("Map*.json"), {"events"}},
+                                             {QStringLiteral("Animations.json"), {"frames"}}});
+        QCOMPARE(matcher.keysForFile("Map001.json"), QSet<QByteArray>({"data", "events"}));
+        QCOMPARE(matcher.keysForFile("animations.JSON"), QSet<QByteArray>({"frames"}));
+        QVERIFY(matcher.keysForFile("MapInfos.txt").isEmpty());
+        QVERIFY(core::JsonSkipMatcher().keysForFile("Map001.json").isEmpty());
+    }
+
+    void testStringPool()
+    {
+        core::StringPool pool;
+        QCOMPARE(pool.intern("Yes"), 0);
+        QCOMPARE(pool.intern("No"), 1);
+        QCOMPARE(pool.intern("Yes"), 0);
+        QCOMPARE(pool.indexOf("No"), 1);
+        QCOMPARE(pool.indexOf("Maybe"), -1);
+        QCOMPARE(core::StringPool::fromJson(pool.toJson()).strings(), pool.strings());
+    }
+
+    void testDocumentCache()
+    {
+        QVERIFY(writeFile("a.json", QByteArray(100, ' ')));
+        QVERIFY(writeFile("b.json", QByteArray(100, ' ')));
+        QVERIFY(writeFile("c.json", QByteArray(100, ' ')));
+
+        auto entryFor = [&](const QString &name) {
+            const QFileInfo info(filePath(name));
+            core::DocumentCache::Entry entry;
+            entry.size = info.size();
+            entry.lastModified = info.lastModified();
+            entry.content = QByteArray(100, ' ');
+            return entry;
+        };
+        auto find = [&](core::DocumentCache &cache, const QString &name, core::DocumentCache::Entry *found) {
+            return cache.find(filePath(name), QFileInfo(filePath(name)), found);
+        };
+
+        core::DocumentCache off;
+        off.insert(filePath("a.json"), entryFor("a.json"));
+        QCOMPARE(off.stats().documents, 0);
+
+        // Room for two files: the least recently used one goes when a third comes in
+        core::DocumentCache cache(250);
+        core::DocumentCache::Entry found;
+        cache.insert(filePath("a.json"), entryFor("a.json"));
+        cache.insert(filePath("b.json"), entryFor("b.json"));
+        QVERIFY(find(cache, "a.json", &found));
+        cache.insert(filePath("c.json"), entryFor("c.json"));
+        QVERIFY(!find(cache, "b.json", &found));
+        QVERIFY(find(cache, "a.json", &found));
+        QCOMPARE(found.content.size(), 100);
+
+        // A file that changed on disk is not served
+        QVERIFY(writeFile("c.json", QByteArray(120, ' ')));
+        QVERIFY(!find(cache, "c.json", &found));
+
+        const core::DocumentCache::Stats stats = cache.stats();
+        QCOMPARE(stats.documents, 1);
+        QCOMPARE(stats.residentBytes, 100);
+        QCOMPARE(stats.hits, 2u);
+        QCOMPARE(stats.misses, 2u);
+        QCOMPARE(stats.evictions, 1u);
+
+        cache.setBudget(0);
+        QCOMPARE(cache.stats().documents, 0);
+
+        // A parsed document is charged well above the size of its text
+        core::DocumentCache::Entry parsed;
+        const QByteArray json = R"({"events":[null,{"pages":[{"list":[{"code":401,"parameters":["Hi"]}]}]}]})";
+        parsed.size = json.size();
+        parsed.document = QJsonDocument::fromJson(json);
+        QVERIFY(core::DocumentCache::cost(parsed) > 2 * json.size());
+    }
+
+    void testMappedFile()
+    {
+        // Read into a buffer below the threshold, mapped above it
+        const QByteArray small = "{\"a\":1}";
+        const QByteArray large(core::MappedFile::MinimumMapSize + 1, 'x');
+        QVERIFY(writeFile("small.json", small));
+        QVERIFY(writeFile("large.json", large));
+        QVERIFY(writeFile("empty.json", QByteArray()));
+
+        core::MappedFile smallFile(filePath("small.json"));
+        QVERIFY(smallFile.isOpen());
+        QCOMPARE(smallFile.bytes(), small);
+
+        core::MappedFile largeFile(filePath("large.json"));
+        QVERIFY(largeFile.isOpen());
+        QCOMPARE(largeFile.size(), large.size());
+        QVERIFY(largeFile.data() == QByteArrayView(large));
+
+        core::MappedFile emptyFile(filePath("empty.json"));
+        QVERIFY(emptyFile.isOpen());
+        QCOMPARE(emptyFile.size(), 0);
+
+        core::MappedFile missing(filePath("missing.json"));
+        QVERIFY(!missing.isOpen());
+        QVERIFY(!missing.errorString().isEmpty());
+
+        largeFile.close();
+        QVERIFY(!largeFile.isOpen());
+    }
+
+    void testLogger()
+    {
+        core::Logger &logger = core::Logger::instance();
+        const QString previousFile = logger.logFile();
+        const core::LogLevel previousLevel = logger.level();
+        logger.setLogFile(filePath("test_log.txt"));
+        logger.setLevel(core::LogLevel::Info);
+
+        for (int i = 0; i < 100; ++i) {
+            BGA_LOG_INFO("test", QStringLiteral("message %1").arg(i));
+            BGA_LOG_DEBUG("test", QStringLiteral("filtered %1").arg(i));
+        }
+        logger.flush();
+
+        logger.setLogFile(previousFile);
+        logger.setLevel(previousLevel);
+
+        QFile file(filePath("test_log.txt"));
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        const QList<QByteArray> lines = file.readAll().split('\n');
+        QCOMPARE(lines.size(), 101); // The last newline leaves an empty tail
+        QVERIFY(lines.first().endsWith("INFO  [test] message 0"));
+        QVERIFY(lines.at(99).endsWith("[test] message 99"));
+        QCOMPARE(logger.droppedCount(), quint64(0));
+    }
+};
+
+QTEST_MAIN(TestCoreUtilities)
+#include "test_core_utilities.moc"
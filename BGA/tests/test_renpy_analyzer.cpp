@@ -0,0 +1,65 @@
+#include <QtTest/QtTest>
+#include "core/engines/renpy/renpyanalyzer.h"
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+class TestRenpyAnalyzer : public QObject
+{
+    Q_OBJECT
+
+private:
+    std::unique_ptr<QTemporaryDir> tempDir;
+
+    bool writeScript(const QString &fileName, const QByteArray &content) const
+    {
+        QFile file(tempDir->filePath(fileName));
+        return file.open(QIODevice::WriteOnly) && file.write(content) == content.size();
+    }
+
+    // "line: text" for every string the analyzer extracts from the scripts in tempDir
+    QStringList extractedLines()
+    {
+        core::engines::renpy::RenpyAnalyzer analyzer;
+        const core::AnalyzerOutput output = analyzer.analyze(tempDir->path());
+        QStringList lines;
+        for (const QJsonValue &value : QJsonDocument::fromJson(output.payload).array()) {
+            const QJsonObject entry = value.toObject();
+            lines.append(QStringLiteral("%1: %2").arg(entry["line"].toInt()).arg(entry["original"].toString()));
+        }
+        return lines;
+    }
+
+private slots:
+    void init()
+    {
+        tempDir = std::make_unique<QTemporaryDir>();
+        QVERIFY(tempDir->isValid());
+    }
+
+    void testLineEndings()
+    {
+        // Unix, Windows and classic Mac line ends in one file; the last line has none
+        QVERIFY(writeScript("script.rpy", "e \"Hello\"\n\"Choice one\":\r\nmc \"Three\"\rlabel start:\n    \"Narration\""));
+        QCOMPARE(extractedLines(), QStringList({"1: Hello", "2: Choice one", "3: Three", "5: Narration"}));
+    }
+
+    void testByteOrderMark()
+    {
+        // Editors on Windows often save scripts with a BOM; the first line must still match
+        QVERIFY(writeScript("script.rpy", "\xEF\xBB\xBF" "e \"Hello\"\r\nmc \"\xE0\xB8\xAA\xE0\xB8\xA7\xE0\xB8\xB1\xE0\xB8\xAA\xE0\xB8\x94\xE0\xB8\xB5\"\r\n"));
+        QCOMPARE(extractedLines(), QStringList({"1: Hello", QStringLiteral("2: สวัสดี")}));
+    }
+
+    void testMissingPath()
+    {
+        core::engines::renpy::RenpyAnalyzer analyzer;
+        QVERIFY(!analyzer.analyze(tempDir->filePath("missing")).errorMessage.isEmpty());
+        QVERIFY(!analyzer.analyze(tempDir->path()).errorMessage.isEmpty());
+    }
+};
+
+QTEST_MAIN(TestRenpyAnalyzer)
+#include "test_renpy_analyzer.moc"
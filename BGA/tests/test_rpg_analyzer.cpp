@@ -1,14 +1,43 @@
 #include <QtTest/QtTest>
 #include "core/engines/rpgm/rpganalyzer.h"
+#include "core/analyzerpayload.h"
+#include "core/documentcache.h"
 #include <QDir>
 #include <QFile>
 #include <QDirIterator>
 #include <QTemporaryDir>
+#include <QThreadPool>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QDebug>
 
+class RecordingSink : public core::IAnalysisSink
+{
+public:
+    void entriesExtracted(const QString &filePath, const QJsonArray &entries) override
+    {
+        files.append(filePath);
+        for (const QJsonValue &entry : entries) {
+            strings.append(entry);
+        }
+    }
+
+    void progress(int done, int total) override
+    {
+        lastDone = done;
+        lastTotal = total;
+    }
+
+    bool isCancelled() const override { return cancelAfterFiles >= 0 && lastDone >= cancelAfterFiles; }
+
+    QStringList files;
+    QJsonArray strings;
+    int lastDone = 0;
+    int lastTotal = 0;
+    int cancelAfterFiles = -1;
+};
+
 class TestRpgAnalyzer : public QObject
 {
     Q_OBJECT
@@ -17,8 +46,38 @@ private:
     std::unique_ptr<QTemporaryDir> tempDir;
     QString dataPath;
 
+    QString dataFile(const QString &fileName) const { return dataPath + "/" + fileName; }
+
+    bool writeDataFile(const QString &fileName, const QByteArray &content) const
+    {
+        QFile file(dataFile(fileName));
+        return file.open(QIODevice::WriteOnly) && file.write(content) == content.size();
+    }
+
+    QByteArray readDataFile(const QString &fileName) const
+    {
+        QFile file(dataFile(fileName));
+        return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+    }
+
+    // Strings the analyzer extracts from the project in tempDir
+    QJsonArray extractedStrings(core::engines::rpgm::RpgmAnalyzer &analyzer) const
+    {
+        return core::AnalyzerPayload::strings(QJsonDocument::fromJson(analyzer.analyze(tempDir->path()).payload).object());
+    }
+
+    static QJsonObject translation(const QString &path, const QString &key, const QString &text)
+    {
+        QJsonObject entry;
+        entry.insert("path", path);
+        entry.insert("key", key);
+        entry.insert("text", text);
+        return entry;
+    }
+
 private slots:
-    void initTestCase()
+    // Every test starts from an empty project
+    void init()
     {
         tempDir = std::make_unique<QTemporaryDir>();
         QVERIFY(tempDir->isValid());
@@ -63,7 +122,7 @@ private slots:
         core::AnalyzerOutput output = analyzer.analyze(tempDir->path()); 
 
         QJsonDocument outDoc = QJsonDocument::fromJson(output.payload);
-        QJsonArray strings = outDoc.object()["strings"].toArray();
+        QJsonArray strings = core::AnalyzerPayload::strings(outDoc.object());
         
         qDebug() << "==========================================";
         qDebug() << "          EXTRACTION COVERAGE REPORT      ";
@@ -125,7 +184,7 @@ private slots:
         core::AnalyzerOutput output = analyzer.analyze(tempDir->path());
         
         QJsonDocument outDoc = QJsonDocument::fromJson(output.payload);
-        QJsonArray strings = outDoc.object()["strings"].toArray();
+        QJsonArray strings = core::AnalyzerPayload::strings(outDoc.object());
         
         // 3. Verify
         int foundCount = 0;
@@ -147,6 +206,528 @@ private slots:
         QCOMPARE(foundCount, 4);
     }
 
+    void testSkipRulesKeepOutput()
+    {
+        // A map whose tile data and encounters must be skipped without changing the extraction
+        QJsonArray tiles;
+        for (int i = 0; i < 4096; ++i) {
+            tiles.append(i % 7);
+        }
+
+        QJsonObject encounter;
+        encounter.insert("regionSet", QJsonArray{1, 2});
+        encounter.insert("troopId", 3);
+        encounter.insert("weight", 5);
+
+        QJsonObject command;
+        command.insert("code", 401);
+        command.insert("indent", 0);
+        command.insert("parameters", QJsonArray{"Text next to [brackets] and \"quotes\""});
+
+        QJsonObject page;
+        page.insert("list", QJsonArray{command});
+
+        QJsonObject event;
+        event.insert("id", 1);
+        event.insert("name", "Villager");
+        event.insert("pages", QJsonArray{page});
+
+        QJsonObject map;
+        map.insert("displayName", "Town");
+        map.insert("data", tiles);
+        map.insert("encounterList", QJsonArray{encounter});
+        map.insert("events", QJsonArray{QJsonValue::Null, event});
+
+        QVERIFY(writeDataFile("Map001.json", QJsonDocument(map).toJson(QJsonDocument::Compact)));
+
+        core::engines::rpgm::RpgmAnalyzer skipping;
+        core::engines::rpgm::RpgmAnalyzer full;
+        full.setSkipRules({});
+
+        const QJsonArray skippedStrings = extractedStrings(skipping);
+        const QJsonArray fullStrings = extractedStrings(full);
+
+        QVERIFY(!fullStrings.isEmpty());
+        QCOMPARE(skippedStrings, fullStrings);
+    }
+
+    void testEventCommandOverride()
+    {
+        QJsonObject pluginCommand;
+        pluginCommand.insert("code", 356);
+        pluginCommand.insert("indent", 0);
+        pluginCommand.insert("parameters", QJsonArray{"ShowBanner Welcome home"});
+
+        QJsonObject unknown;
+        unknown.insert("code", 0);
+        unknown.insert("indent", 0);
+        unknown.insert("parameters", QJsonArray{});
+
+        QJsonObject event;
+        event.insert("id", 1);
+        event.insert("list", QJsonArray{pluginCommand, unknown, unknown});
+        const QJsonDocument doc(QJsonArray{QJsonValue::Null, event});
+
+        core::engines::rpgm::RpgmAnalyzer analyzer;
+        QMap<int, int> unknownCodes;
+        QVERIFY(analyzer.extractStrings(doc, "CommonEvents.json", &unknownCodes).isEmpty());
+        QCOMPARE(unknownCodes.value(0), 2);
+        QVERIFY(!unknownCodes.contains(356));
+
+        analyzer.setEventCommandRule({356, core::engines::rpgm::EventParameterText::String, 0});
+        const QJsonArray strings = analyzer.extractStrings(doc, "CommonEvents.json");
+        QCOMPARE(strings.size(), 1);
+        QCOMPARE(strings[0].toObject()["key"].toString(), QString("1.list[0].parameters[0]"));
+        QCOMPARE(strings[0].toObject()["source"].toString(), QString("ShowBanner Welcome home"));
+
+        analyzer.resetEventCommandRules();
+        QVERIFY(analyzer.extractStrings(doc, "CommonEvents.json").isEmpty());
+    }
+
+    void testAnalysisCacheReuse()
+    {
+        auto systemFile = [](const QString &title) {
+            QJsonObject system;
+            system.insert("gameTitle", title);
+            return QJsonDocument(system).toJson(QJsonDocument::Compact);
+        };
+        QVERIFY(writeDataFile("System.json", systemFile("First Title")));
+
+        QJsonObject actor;
+        actor.insert("id", 1);
+        actor.insert("name", "Harold");
+        QVERIFY(writeDataFile("Actors.json", QJsonDocument(QJsonArray{QJsonValue::Null, actor}).toJson(QJsonDocument::Compact)));
+
+        const QString manifest = tempDir->filePath("Game_Translation.analysis.json");
+        QCOMPARE(core::AnalysisCache::pathForWorkspace(tempDir->filePath("Game_Translation.nst")), manifest);
+
+        auto analyze = [&](bool cached) {
+            core::engines::rpgm::RpgmAnalyzer analyzer;
+            if (cached) {
+                analyzer.setCacheFile(manifest);
+            }
+            return extractedStrings(analyzer);
+        };
+
+        const QJsonArray first = analyze(true);
+        QVERIFY(QFile::exists(manifest));
+        QCOMPARE(analyze(true), first);
+        QCOMPARE(first, analyze(false));
+
+        // An edited file is analyzed again, the others come from the manifest
+        QVERIFY(writeDataFile("System.json", systemFile("Second, Longer Title")));
+        const QJsonArray second = analyze(true);
+        QCOMPARE(second, analyze(false));
+        QVERIFY(second != first);
+
+        // Skip rules are part of the signature: a manifest written under other rules is not reused
+        core::engines::rpgm::RpgmAnalyzer skipping;
+        skipping.setSkipRules({{QStringLiteral("Actors.json"), {"name"}}});
+        skipping.setCacheFile(manifest);
+        const QJsonArray skipped = extractedStrings(skipping);
+        for (const QJsonValue &entry : skipped) {
+            QVERIFY(entry.toObject()["source"].toString() != "Harold");
+        }
+
+        // Entries written for other extraction rules are ignored
+        core::AnalysisCache foreign(manifest, "another-analyzer");
+        QVERIFY(!foreign.load());
+        QCOMPARE(foreign.size(), 0);
+    }
+
+    void testAnalyzeStreamMatchesAnalyze()
+    {
+        for (int i = 1; i <= 3; ++i) {
+            QJsonObject item;
+            item.insert("id", 1);
+            item.insert("name", QString("Potion %1").arg(i));
+            item.insert("description", QString("Restores %1 HP").arg(i * 100));
+            QVERIFY(writeDataFile(QString("Items%1.json").arg(i), QJsonDocument(QJsonArray{QJsonValue::Null, item}).toJson(QJsonDocument::Compact)));
+        }
+
+        core::engines::rpgm::RpgmAnalyzer analyzer;
+        const QJsonObject root = QJsonDocument::fromJson(analyzer.analyze(tempDir->path()).payload).object();
+        QJsonArray expected;
+        for (const core::AnalyzerPayload::FileRecord &file : core::AnalyzerPayload::files(root)) {
+            for (const QJsonValue &entry : file.entries) {
+                expected.append(entry);
+            }
+        }
+        QCOMPARE(expected.size(), 6);
+
+        RecordingSink sink;
+        QVERIFY(analyzer.analyzeStream(tempDir->path(), sink) == core::AnalysisStatus::Finished);
+        QCOMPARE(sink.strings, expected);
+        QCOMPARE(sink.files.size(), 3);
+        QCOMPARE(sink.lastDone, 3);
+        QCOMPARE(sink.lastTotal, 3);
+
+        RecordingSink cancelling;
+        cancelling.cancelAfterFiles = 1;
+        QVERIFY(analyzer.analyzeStream(tempDir->path(), cancelling) == core::AnalysisStatus::Cancelled);
+        QCOMPARE(cancelling.files.size(), 1);
+    }
+
+    void testParallelMatchesFileByFile()
+    {
+        // Several windows of maps whose sizes differ a lot, so workers finish out of order
+        const int fileCount = qMax(1, QThreadPool::globalInstance()->maxThreadCount()) * 6 + 3;
+        QMap<QString, QByteArray> maps;
+        for (int i = 1; i <= fileCount; ++i) {
+            QJsonArray list;
+            for (int line = 0; line < (i % 7) * 40 + 1; ++line) {
+                list.append(QJsonObject{{"code", 401}, {"indent", 0}, {"parameters", QJsonArray{QString("Map %1 line %2").arg(i).arg(line)}}});
+            }
+            list.append(QJsonObject{{"code", 0}, {"indent", 0}, {"parameters", QJsonArray()}});
+            const QJsonObject page{{"list", list}};
+            const QJsonObject event{{"id", 1}, {"name", QString("EV%1").arg(i)}, {"pages", QJsonArray{page}}};
+            const QJsonObject map{{"displayName", QString("Town %1").arg(i)}, {"events", QJsonArray{QJsonValue::Null, event}}};
+            maps.insert(QString("Map%1.json").arg(i, 3, 10, QChar('0')), QJsonDocument(map).toJson(QJsonDocument::Compact));
+        }
+
+        // Reference: every file analyzed on its own, in name order
+        QStringList expectedFiles;
+        QJsonArray expectedStrings;
+        for (auto it = maps.constBegin(); it != maps.constEnd(); ++it) {
+            QTemporaryDir single;
+            QVERIFY(QDir(single.path()).mkdir("data"));
+            QFile file(single.filePath("data/" + it.key()));
+            QVERIFY(file.open(QIODevice::WriteOnly));
+            file.write(it.value());
+            file.close();
+
+            core::engines::rpgm::RpgmAnalyzer analyzer;
+            RecordingSink sink;
+            QVERIFY(analyzer.analyzeStream(single.path(), sink) == core::AnalysisStatus::Finished);
+            QCOMPARE(sink.files.size(), 1);
+            expectedFiles.append(it.key());
+            for (const QJsonValue &entry : std::as_const(sink.strings)) {
+                expectedStrings.append(entry);
+            }
+        }
+
+        for (auto it = maps.constBegin(); it != maps.constEnd(); ++it) {
+            QVERIFY(writeDataFile(it.key(), it.value()));
+        }
+        core::engines::rpgm::RpgmAnalyzer analyzer;
+        RecordingSink sink;
+        QVERIFY(analyzer.analyzeStream(tempDir->path(), sink) == core::AnalysisStatus::Finished);
+
+        QStringList files;
+        for (const QString &path : std::as_const(sink.files)) {
+            files.append(QFileInfo(path).fileName());
+        }
+        QCOMPARE(files, expectedFiles);
+        QCOMPARE(sink.strings, expectedStrings);
+        QCOMPARE(sink.lastDone, fileCount);
+    }
+
+    void testAnalyzeStreamReportsFailures()
+    {
+        core::engines::rpgm::RpgmAnalyzer analyzer;
+        RecordingSink sink;
+        QString error;
+
+        // Nothing to analyze
+        QVERIFY(analyzer.analyzeStream(tempDir->filePath("missing"), sink, &error) == core::AnalysisStatus::Failed);
+        QVERIFY(error.contains("missing"));
+        error.clear();
+        QVERIFY(analyzer.analyzeStream(tempDir->path(), sink, &error) == core::AnalysisStatus::Failed);
+        QVERIFY(!error.isEmpty());
+
+        // Every file unreadable
+        QVERIFY(writeDataFile("Items.json", "[null,{\"name\":"));
+        error.clear();
+        QVERIFY(analyzer.analyzeStream(tempDir->path(), sink, &error) == core::AnalysisStatus::Failed);
+        QVERIFY(!error.isEmpty());
+        QVERIFY(!analyzer.analyze(tempDir->path()).errorMessage.isEmpty());
+        QVERIFY(sink.files.isEmpty());
+    }
+
+    void testCborPayloadMatchesJson()
+    {
+        QJsonObject item;
+        item.insert("id", 7);
+        item.insert("name", "Elixir \u00e9\u0e01\U0001F600");
+        item.insert("price", 12.5);
+        item.insert("consumable", true);
+        QVERIFY(writeDataFile("Items.json", QJsonDocument(QJsonArray{QJsonValue::Null, item}).toJson(QJsonDocument::Compact)));
+
+        core::engines::rpgm::RpgmAnalyzer analyzer;
+        const core::AnalyzerOutput json = analyzer.analyze(tempDir->path());
+        analyzer.setOutputFormat(core::kCborPayloadFormat);
+        const core::AnalyzerOutput cbor = analyzer.analyze(tempDir->path());
+        QCOMPARE(cbor.format, QString(core::kCborPayloadFormat));
+        QVERIFY(cbor.payload.size() < json.payload.size());
+
+        QJsonObject fromJson;
+        QJsonObject fromCbor;
+        QVERIFY(core::AnalyzerPayload::decode(json, &fromJson));
+        QVERIFY(core::AnalyzerPayload::decode(cbor, &fromCbor));
+        QCOMPARE(fromCbor, fromJson);
+        QVERIFY(!core::AnalyzerPayload::files(fromCbor).isEmpty());
+
+        core::AnalyzerOutput truncated = cbor;
+        truncated.payload.chop(3);
+        QString error;
+        QVERIFY(!core::AnalyzerPayload::decode(truncated, &fromCbor, &error));
+        QVERIFY(!error.isEmpty());
+    }
+
+    void testPayloadSchemaVersions()
+    {
+        QJsonObject hello{{"source", "Hello"}, {"key", "0"}, {"path", "/game/data/A.json"}};
+        QJsonObject bye{{"source", "Bye"}, {"key", "1"}, {"path", "/game/data/B.json"}};
+        QJsonObject again{{"source", "Again"}, {"key", "2"}, {"path", "/game/data/A.json"}};
+
+        // Schema 1: flat list, grouped by path in order of first appearance
+        const QJsonObject v1{{"strings", QJsonArray{hello, bye, again}}};
+        const QList<core::AnalyzerPayload::FileRecord> v1Files = core::AnalyzerPayload::files(v1);
+        QCOMPARE(v1Files.size(), 2);
+        QCOMPARE(v1Files[0].path, QString("/game/data/A.json"));
+        QCOMPARE(v1Files[0].entries, (QJsonArray{hello, again}));
+        QCOMPARE(v1Files[1].entries, QJsonArray{bye});
+
+        // Schema 2: path stored once per file, put back by strings()
+        QJsonObject plainHello = hello;
+        plainHello.remove("path");
+        const QJsonObject v2 = core::AnalyzerPayload::makeResult({{"/game/data/A.json", QJsonArray{plainHello}}});
+        QCOMPARE(v2["schemaVersion"].toInt(), core::AnalyzerPayload::SchemaVersion);
+        QCOMPARE(core::AnalyzerPayload::files(v2).size(), 1);
+        QCOMPARE(core::AnalyzerPayload::strings(v2), QJsonArray{hello});
+    }
+
+    void testPayloadPoolsRepeatedStrings()
+    {
+        // The same name in two files is written once and resolved for both entries
+        for (const QString &fileName : {QString("Items.json"), QString("Weapons.json")}) {
+            QJsonObject item;
+            item.insert("id", 1);
+            item.insert("name", "Potion");
+            QVERIFY(writeDataFile(fileName, QJsonDocument(QJsonArray{QJsonValue::Null, item}).toJson(QJsonDocument::Compact)));
+        }
+
+        core::engines::rpgm::RpgmAnalyzer analyzer;
+        const core::AnalyzerOutput output = analyzer.analyze(tempDir->path());
+        QCOMPARE(output.stringPool, QStringList{"Potion"});
+
+        QJsonObject root;
+        QVERIFY(core::AnalyzerPayload::decode(output, &root));
+        QCOMPARE(root["pool"].toArray().size(), 1);
+        const QJsonArray strings = core::AnalyzerPayload::strings(root);
+        QCOMPARE(strings.size(), 2);
+        for (const QJsonValue &entry : strings) {
+            QCOMPARE(entry.toObject()["source"].toString(), QString("Potion"));
+            QVERIFY(!entry.toObject().contains("sourceId"));
+        }
+    }
+
+    void testSaveManyUpdates()
+    {
+        const QString mockFilePath = dataFile("save_many_test.json");
+
+        QJsonArray list;
+        for (int i = 0; i < 50; ++i) {
+            QJsonObject command;
+            command.insert("code", 401);
+            command.insert("indent", 0);
+            command.insert("parameters", QJsonArray{QString("Line %1").arg(i)});
+            list.append(command);
+        }
+        QJsonObject choices;
+        choices.insert("code", 102);
+        choices.insert("indent", 0);
+        choices.insert("parameters", QJsonArray{QJsonArray{"Yes", "No"}, 1});
+        list.append(choices);
+
+        QJsonObject event;
+        event.insert("id", 1);
+        event.insert("list", list);
+
+        QVERIFY(writeDataFile("save_many_test.json", QJsonDocument(QJsonArray{QJsonValue::Null, event}).toJson()));
+
+        QJsonArray texts;
+        for (int i = 0; i < 50; ++i) {
+            texts.append(translation(mockFilePath, QString("1.list[%1].parameters[0]").arg(i), QString("Translated %1").arg(i)));
+        }
+        texts.append(translation(mockFilePath, "1.list[50].parameters[0][1]", "Nope"));
+        // Paths that do not resolve are skipped without touching anything else
+        texts.append(translation(mockFilePath, "1.list[99].parameters[0]", "Lost"));
+
+        core::engines::rpgm::RpgmAnalyzer analyzer;
+        QVERIFY(analyzer.save(tempDir->path(), texts));
+
+        const QJsonArray checkRoot = QJsonDocument::fromJson(readDataFile("save_many_test.json")).array();
+
+        QCOMPARE(checkRoot.size(), 2);
+        QVERIFY(checkRoot[0].isNull());
+        const QJsonObject checkEvent = checkRoot[1].toObject();
+        QCOMPARE(checkEvent["id"].toInt(), 1);
+        const QJsonArray checkList = checkEvent["list"].toArray();
+        QCOMPARE(checkList.size(), 51);
+        for (int i = 0; i < 50; ++i) {
+            const QJsonObject command = checkList[i].toObject();
+            QCOMPARE(command["code"].toInt(), 401);
+            QCOMPARE(command["parameters"].toArray()[0].toString(), QString("Translated %1").arg(i));
+        }
+        const QJsonArray checkChoices = checkList[50].toObject()["parameters"].toArray();
+        QCOMPARE(checkChoices[0].toArray(), (QJsonArray{"Yes", "Nope"}));
+        QCOMPARE(checkChoices[1].toInt(), 1);
+    }
+
+    void testSavePatchKeepsFormatting()
+    {
+        const QString filePath = dataFile("CommonEvents.json");
+
+        // Compact like the files RPG Maker deploys, with an escaped quote in the text
+        const QByteArray original =
+            "[null,{\"id\":1,\"list\":[{\"code\":401,\"indent\":0,\"parameters\":[\"Say \\\"hi\\\"\"]},"
+            "{\"code\":401,\"indent\":0,\"parameters\":[\"Second line\"]}],\"name\":\"Greeting\"}]";
+        QVERIFY(writeDataFile("CommonEvents.json", original));
+
+        // Spans recorded by analyze()
+        core::engines::rpgm::RpgmAnalyzer analyzer;
+        QCOMPARE(extractedStrings(analyzer).size(), 3);
+        QVERIFY(analyzer.save(tempDir->path(), QJsonArray{translation(filePath, "1.list[0].parameters[0]", "Dis \"salut\"\n")}));
+
+        QByteArray expected = original;
+        expected.replace("\"Say \\\"hi\\\"\"", "\"Dis \\\"salut\\\"\\n\"");
+        QCOMPARE(readDataFile("CommonEvents.json"), expected);
+
+        // Spans located at save time by an analyzer that never saw the file
+        core::engines::rpgm::RpgmAnalyzer fresh;
+        QVERIFY(fresh.save(tempDir->path(), QJsonArray{translation(filePath, "1.name", "Salutation")}));
+        expected.replace("\"Greeting\"", "\"Salutation\"");
+        QCOMPARE(readDataFile("CommonEvents.json"), expected);
+
+        const QJsonArray list = QJsonDocument::fromJson(readDataFile("CommonEvents.json")).array()[1].toObject()["list"].toArray();
+        QCOMPARE(list[0].toObject()["parameters"].toArray()[0].toString(), QString("Dis \"salut\"\n"));
+        QCOMPARE(list[1].toObject()["parameters"].toArray()[0].toString(), QString("Second line"));
+    }
+
+    void testSaveManyFiles()
+    {
+        auto mapName = [](int i) { return QString("Map%1.json").arg(i, 3, 10, QChar('0')); };
+
+        QJsonArray texts;
+        for (int i = 1; i <= 20; ++i) {
+            QVERIFY(writeDataFile(mapName(i), "{\"displayName\":\"Town\",\"events\":[]}"));
+            texts.append(translation(dataFile(mapName(i)), "displayName", QString("Ville %1").arg(i)));
+        }
+        // A file that cannot be read fails the save without stopping the others
+        texts.append(translation(dataFile("Missing.json"), "displayName", "Lost"));
+
+        core::engines::rpgm::RpgmAnalyzer analyzer;
+        QVERIFY(!analyzer.save(tempDir->path(), texts));
+
+        for (int i = 1; i <= 20; ++i) {
+            QCOMPARE(QJsonDocument::fromJson(readDataFile(mapName(i))).object()["displayName"].toString(), QString("Ville %1").arg(i));
+        }
+        // Files are replaced atomically: no backups or temporary files are left behind
+        const QStringList leftovers = QDir(dataPath).entryList(QDir::Files);
+        QCOMPARE(leftovers.size(), 20);
+        QVERIFY(!QFile::exists(dataFile("Missing.json")));
+    }
+
+    void testSaveUsesResidentDocuments()
+    {
+        QVERIFY(writeDataFile("Map001.json",
+                              "{\"displayName\":\"Town\",\"events\":[null,{\"id\":1,\"pages\":[{\"list\":"
+                              "[{\"code\":401,\"indent\":0,\"parameters\":[\"Hello\"]}]}]}]}"));
+
+        auto translate = [&](const QString &text) {
+            return QJsonArray{translation(dataFile("Map001.json"), "events[1].pages[0].list[0].parameters[0]", text)};
+        };
+        auto savedText = [&]() {
+            const QJsonObject root = QJsonDocument::fromJson(readDataFile("Map001.json")).object();
+            return root["events"].toArray()[1].toObject()["pages"].toArray()[0].toObject()["list"].toArray()[0]
+                .toObject()["parameters"].toArray()[0].toString();
+        };
+
+        const core::engines::rpgm::RpgmAnalyzer::SaveMode modes[] = {
+            core::engines::rpgm::RpgmAnalyzer::SaveMode::Patch,
+            core::engines::rpgm::RpgmAnalyzer::SaveMode::Reserialize,
+        };
+        for (const auto mode : modes) {
+            core::engines::rpgm::RpgmAnalyzer analyzer;
+            analyzer.setSaveMode(mode);
+            analyzer.setDocumentCacheBudget(1024 * 1024);
+            analyzer.analyze(tempDir->path());
+            QCOMPARE(analyzer.documentCacheStats().documents, 1);
+
+            // Each save finds what the previous step left behind
+            QVERIFY(analyzer.save(tempDir->path(), translate("Bonjour")));
+            QCOMPARE(savedText(), QString("Bonjour"));
+            QVERIFY(analyzer.save(tempDir->path(), translate("Salut")));
+            QCOMPARE(savedText(), QString("Salut"));
+
+            const core::DocumentCache::Stats stats = analyzer.documentCacheStats();
+            QCOMPARE(stats.hits, 2u);
+            QCOMPARE(stats.misses, 0u);
+        }
+    }
+
+    void testMergeDialogue()
+    {
+        const QByteArray original =
+            "[null,{\"id\":1,\"list\":[{\"code\":101,\"indent\":0,\"parameters\":[\"Actor1\",0,0,2,\"Harold\"]},"
+            "{\"code\":401,\"indent\":0,\"parameters\":[\"First line\"]},"
+            "{\"code\":401,\"indent\":0,\"parameters\":[\"Second line\"]},"
+            "{\"code\":401,\"indent\":0,\"parameters\":[\"Third line\"]},"
+            "{\"code\":401,\"indent\":0,\"parameters\":[\"Alone\"]},"
+            "{\"code\":0,\"indent\":0,\"parameters\":[]}],\"name\":\"Talk\"}]";
+        QVERIFY(writeDataFile("CommonEvents.json", original));
+
+        auto sourcesByKey = [&](core::engines::rpgm::RpgmAnalyzer &analyzer) {
+            QMap<QString, QString> sources;
+            for (const QJsonValue &value : extractedStrings(analyzer)) {
+                sources.insert(value.toObject()["key"].toString(), value.toObject()["source"].toString());
+            }
+            return sources;
+        };
+        auto lines = [&]() {
+            QStringList texts;
+            const QJsonArray list = QJsonDocument::fromJson(readDataFile("CommonEvents.json")).array()[1].toObject()["list"].toArray();
+            for (int i = 1; i <= 4; ++i) {
+                texts.append(list[i].toObject()["parameters"].toArray()[0].toString());
+            }
+            return texts;
+        };
+
+        core::engines::rpgm::RpgmAnalyzer lineByLine;
+        QVERIFY(sourcesByKey(lineByLine).contains("1.list[2].parameters[0]"));
+
+        // The whole run is one unit; the speaker name stays on its own
+        core::engines::rpgm::RpgmAnalyzer analyzer;
+        analyzer.setMergeDialogue(true);
+        const QMap<QString, QString> sources = sourcesByKey(analyzer);
+        QCOMPARE(sources.value("1.list[1..4].parameters[0]"), QString("First line\nSecond line\nThird line\nAlone"));
+        QCOMPARE(sources.value("1.list[0].parameters[4]"), QString("Harold"));
+        QVERIFY(!sources.contains("1.list[2].parameters[0]"));
+
+        auto translate = [&](const QString &text) {
+            return QJsonArray{translation(dataFile("CommonEvents.json"), "1.list[1..4].parameters[0]", text)};
+        };
+
+        // Fewer lines than the original leaves the rest empty
+        QVERIFY(analyzer.save(tempDir->path(), translate("Erste\nZweite")));
+        QCOMPARE(lines(), QStringList({"Erste", "Zweite", "", ""}));
+
+        // More lines than the original stay together in the last one
+        analyzer.setSaveMode(core::engines::rpgm::RpgmAnalyzer::SaveMode::Reserialize);
+        QVERIFY(analyzer.save(tempDir->path(), translate("1\n2\n3\n4\n5")));
+        QCOMPARE(lines(), QStringList({"1", "2", "3", "4\n5"}));
+
+        // Only a trailing "[a..b].parameters[0]" is a range; keys with ".." anywhere else are
+        // rejected instead of being expanded
+        const QByteArray saved = readDataFile("CommonEvents.json");
+        for (const QString &key : {QStringLiteral("1.list[1..4].indent"), QStringLiteral("1..list[1..4].parameters[0]"),
+                                   QStringLiteral("1.list[1..4].parameters[0][0]")}) {
+            QVERIFY(analyzer.save(tempDir->path(), QJsonArray{translation(dataFile("CommonEvents.json"), key, "A\nB")}));
+            QCOMPARE(readDataFile("CommonEvents.json"), saved);
+        }
+    }
+
     void testSave()
     {
         // 1. Setup a simple mock file
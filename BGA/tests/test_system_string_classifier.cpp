@@ -0,0 +1,105 @@
+#include <QtTest/QtTest>
+#include "core/engines/rpgm/systemstringclassifier.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+
+using core::engines::rpgm::SystemStringClassifier;
+
+class TestSystemStringClassifier : public QObject
+{
+    Q_OBJECT
+
+private:
+    static void collectStrings(const QJsonValue &value, QSet<QString> &out)
+    {
+        if (value.isString()) {
+            out.insert(value.toString());
+        } else if (value.isArray()) {
+            for (const QJsonValue &item : value.toArray()) {
+                collectStrings(item, out);
+            }
+        } else if (value.isObject()) {
+            const QJsonObject obj = value.toObject();
+            for (auto it = obj.constBegin(); it != obj.constEnd(); ++it) {
+                out.insert(it.key());
+                collectStrings(it.value(), out);
+            }
+        }
+    }
+
+    static void compareVerdicts(const QSet<QString> &strings)
+    {
+        int mismatches = 0;
+        for (const QString &text : strings) {
+            const bool fast = SystemStringClassifier::isSystemString(text);
+            const bool reference = SystemStringClassifier::isSystemStringReference(text);
+            if (fast != reference) {
+                qWarning() << "Verdict mismatch for" << text << "fast:" << fast << "reference:" << reference;
+                ++mismatches;
+            }
+        }
+        QCOMPARE(mismatches, 0);
+    }
+
+private slots:
+    void corpusMatchesReference()
+    {
+        // Every string value and member name of the sample projects
+        QDir corpusRoot(QStringLiteral(BGA_TEST_CORPUS_DIR));
+        QVERIFY2(corpusRoot.exists(), qPrintable(corpusRoot.path()));
+
+        QSet<QString> strings;
+        QDirIterator it(corpusRoot.path(), QStringList{QStringLiteral("*.json")}, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            QFile file(it.next());
+            if (!file.open(QIODevice::ReadOnly)) {
+                continue;
+            }
+            const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+            collectStrings(doc.isArray() ? QJsonValue(doc.array()) : QJsonValue(doc.object()), strings);
+        }
+
+        QVERIFY(strings.size() > 1000);
+        compareVerdicts(strings);
+    }
+
+    void edgeCasesMatchReference()
+    {
+        const QSet<QString> strings = {
+            // Whitespace and numbers
+            "", " ", "\t\n", QString(QChar(0x3000)), "42", " 42 ", "-1.5e3", ".5", "5.", "+7",
+            "inf", "-INF", "nan", "NaN", "infinity", "1,000", "0x10", "12abc", QString(QChar(0x2212)) + "1",
+            // Paths, URLs and extensions
+            "img/faces/Actor1", "https://example.com", "ftp:x", "Actor1.png", "ACTOR1.PNG", "song.ogg\n",
+            "song.ogg\n\n", "data.json", "script.js", "x.jpeg", "x.jpg ", ".png", "file.j" + QString(QChar(0x017F)),
+            "file.JSON" + QString(QChar(0x017F)),
+            // Prefixes
+            "Actor", "actors", "SKILL up", "Sk", "CommonEventX", "commonevent", "MapInfos", "Tilesets",
+            QString(QChar(0x017F)) + "kill", "S" + QString(QChar(0x212A)) + "ill", QString(QChar(0x0130)) + "tem",
+            "Ite" + QString(QChar(0x0131)), "Hello", "Weap",
+            // Control codes and event names
+            "\\c[1]", " \\N[12] ", "\\v[]", "\\1[2]", "\\c[1]x", "\\" + QString(QChar(0x017F)) + "[3]",
+            "EV001", "ev0301", "EV01", "EV001\n", "EV001 ", "EV001\n\n",
+            // Plugin commands
+            "EnemyBook open", "Quest add 1", "questlog SHOW", "A open", "Ab openness", "Ab  open",
+            "Plugin-Name open", "Enemy" + QString(QChar(0x017F)) + "ook open", "Ab " + QString(QChar(0x017F)) + "et",
+            "Ab d" + QString(QChar(0x0131)) + "sable", "Hello there",
+            // Variables
+            "$gameVariables", "Gold: $GAMEParty", "$gam", "$ game",
+            // Symbols and scripts
+            "!!!", "...", "…", "。。", "あ", "ー", "一", "ก", "฿", "가",
+            "Ж", "ب", "é", "café", "★☆", "Ａ", "\U0001F600", "\U00020000",
+            // Lone surrogates
+            QString(QChar(0xD800)), "EnemyBook open" + QString(QChar(0xDC00)), "!" + QString(QChar(0xD83D))
+        };
+        compareVerdicts(strings);
+    }
+};
+
+QTEST_MAIN(TestSystemStringClassifier)
+#include "test_system_string_classifier.moc"
@@ -0,0 +1,769 @@
+#include <QtCore/QCommandLineParser>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QJsonArray>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QRandomGenerator>
+#include <QtCore/QTextStream>
+
+namespace {
+
+// Generates the data/ folder of an RPG Maker MV or MZ project. The same seed and settings
+// always produce the same files, byte for byte.
+struct GeneratorSettings {
+    quint32 seed = 1;
+    bool mz = true;
+    int maps = 100;
+    int eventsPerMap = 20;
+    int messagesPerPage = 6;  // Show Text commands per event page, on average
+    int pluginCommandPercent = 5; // Share of filler commands that are plugin commands
+    int commonEvents = 50;
+    int troops = 30;
+    int databaseEntries = 100; // Per database file (Actors, Items, Skills, ...)
+};
+
+const char *const kWords[] = {
+    "the", "a", "you", "we", "they", "it", "this", "that", "there", "here",
+    "is", "was", "will", "can", "must", "should", "have", "find", "bring", "take",
+    "see", "know", "think", "remember", "forget", "open", "close", "fight", "run", "wait",
+    "sword", "shield", "potion", "key", "door", "gate", "castle", "village", "forest", "cave",
+    "king", "queen", "knight", "merchant", "witch", "dragon", "slime", "ghost", "child", "elder",
+    "old", "new", "dark", "bright", "strange", "quiet", "ancient", "broken", "golden", "hidden",
+    "north", "south", "tonight", "tomorrow", "again", "never", "always", "soon", "already", "still",
+    "and", "but", "so", "because", "if", "when", "with", "without", "from", "into",
+};
+
+const char *const kForeignLines[] = {
+    "こんにちは、旅の人。",
+    "この先は危険だぞ。",
+    "ありがとうございます！",
+    "สวัสดีครับ นักเดินทาง",
+    "ระวังตัวด้วยนะ",
+    "Bonjour, voyageur.",
+    "Das Tor ist verschlossen.",
+};
+
+// Lines every game repeats; they make the string pool realistic
+const char *const kCommonLines[] = {
+    "...", "Yes.", "No.", "Thank you!", "Hmm...", "What?!", "I see.", "Let's go!", "Welcome!", "Goodbye.",
+};
+
+const char *const kSyllables[] = {
+    "ka", "ri", "to", "na", "el", "mor", "dra", "sil", "vin", "lo",
+    "ga", "ren", "tha", "is", "ur", "bel", "cor", "fae", "lun", "zen",
+};
+
+const char *const kDatabaseFiles[] = {
+    "Actors", "Classes", "Skills", "Items", "Weapons", "Armors", "Enemies", "States",
+};
+
+class ProjectGenerator {
+public:
+    explicit ProjectGenerator(const GeneratorSettings &settings)
+        : m_settings(settings), m_random(settings.seed)
+    {
+    }
+
+    // Writes every file into `dataPath`. Returns false and sets `errorMessage` on I/O errors.
+    bool generate(const QString &dataPath, QString *errorMessage)
+    {
+        if (!QDir().mkpath(dataPath)) {
+            *errorMessage = QStringLiteral("Failed to create %1").arg(dataPath);
+            return false;
+        }
+        m_dataDir = QDir(dataPath);
+
+        // Fixed order, so the random stream is consumed the same way on every run
+        for (const char *name : kDatabaseFiles) {
+            if (!write(QString::fromLatin1(name) + QStringLiteral(".json"), QJsonDocument(databaseFile(QString::fromLatin1(name))), errorMessage)) {
+                return false;
+            }
+        }
+        if (!write(QStringLiteral("System.json"), QJsonDocument(systemFile()), errorMessage)
+            || !write(QStringLiteral("Tilesets.json"), QJsonDocument(tilesetsFile()), errorMessage)
+            || !write(QStringLiteral("Animations.json"), QJsonDocument(animationsFile()), errorMessage)
+            || !write(QStringLiteral("CommonEvents.json"), QJsonDocument(commonEventsFile()), errorMessage)
+            || !write(QStringLiteral("Troops.json"), QJsonDocument(troopsFile()), errorMessage)
+            || !write(QStringLiteral("MapInfos.json"), QJsonDocument(mapInfosFile()), errorMessage)) {
+            return false;
+        }
+        for (int mapId = 1; mapId <= m_settings.maps; ++mapId) {
+            const QString name = QStringLiteral("Map%1.json").arg(mapId, 3, 10, QLatin1Char('0'));
+            if (!write(name, QJsonDocument(mapFile()), errorMessage)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int filesWritten() const { return m_filesWritten; }
+    qint64 bytesWritten() const { return m_bytesWritten; }
+    qint64 textsGenerated() const { return m_textsGenerated; }
+
+private:
+    bool write(const QString &fileName, const QJsonDocument &doc, QString *errorMessage)
+    {
+        // RPG Maker writes its data files without indentation
+        const QByteArray bytes = doc.toJson(QJsonDocument::Compact);
+        QFile file(m_dataDir.filePath(fileName));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(bytes) != bytes.size()) {
+            *errorMessage = QStringLiteral("Failed to write %1: %2").arg(file.fileName(), file.errorString());
+            return false;
+        }
+        ++m_filesWritten;
+        m_bytesWritten += bytes.size();
+        return true;
+    }
+
+    int roll(int lowest, int highest) { return m_random.bounded(lowest, highest + 1); }
+    bool chance(int percent) { return m_random.bounded(100) < percent; }
+
+    template <size_t N>
+    QString pick(const char *const (&items)[N])
+    {
+        return QString::fromUtf8(items[m_random.bounded(static_cast<int>(N))]);
+    }
+
+    QString name()
+    {
+        QString result;
+        const int syllables = roll(2, 3);
+        for (int i = 0; i < syllables; ++i) {
+            result += pick(kSyllables);
+        }
+        result[0] = result.at(0).toUpper();
+        return result;
+    }
+
+    // One translatable text. Most are unique sentences; some are the lines every game repeats,
+    // others carry the control codes translators have to keep.
+    QString text()
+    {
+        ++m_textsGenerated;
+        const int kind = m_random.bounded(100);
+        if (kind < 15) {
+            return pick(kCommonLines);
+        }
+        if (kind < 20) {
+            return pick(kForeignLines);
+        }
+
+        QStringList words;
+        const int count = roll(3, 12);
+        for (int i = 0; i < count; ++i) {
+            words.append(pick(kWords));
+        }
+        QString sentence = words.join(QLatin1Char(' '));
+        sentence[0] = sentence.at(0).toUpper();
+        sentence += QLatin1Char(chance(20) ? '?' : (chance(20) ? '!' : '.'));
+
+        if (kind < 28) {
+            sentence.prepend(QStringLiteral("\\N[%1], ").arg(roll(1, 8)));
+        } else if (kind < 34) {
+            sentence = QStringLiteral("\\C[%1]%2\\C[0]").arg(roll(1, 31)).arg(sentence);
+        } else if (kind < 38) {
+            sentence += QStringLiteral(" (\\V[%1] left)").arg(roll(1, 50));
+        }
+        return sentence;
+    }
+
+    static QJsonObject command(int code, int indent, const QJsonArray &parameters)
+    {
+        return QJsonObject{
+            {QStringLiteral("code"), code},
+            {QStringLiteral("indent"), indent},
+            {QStringLiteral("parameters"), parameters},
+        };
+    }
+
+    static QJsonObject audio(const QString &name)
+    {
+        return QJsonObject{
+            {QStringLiteral("name"), name},
+            {QStringLiteral("pan"), 0},
+            {QStringLiteral("pitch"), 100},
+            {QStringLiteral("volume"), 90},
+        };
+    }
+
+    void appendMessage(QJsonArray &list, int indent)
+    {
+        QJsonArray setup{pick(kSyllables) + QStringLiteral("_face"), roll(0, 7), 0, 2};
+        if (m_settings.mz) {
+            setup.append(chance(70) ? name() : QString()); // Speaker name
+        }
+        list.append(command(101, indent, setup));
+        const int lines = roll(1, 4);
+        for (int i = 0; i < lines; ++i) {
+            list.append(command(401, indent, {text()}));
+        }
+    }
+
+    void appendChoices(QJsonArray &list, int indent)
+    {
+        QJsonArray choices;
+        const int count = roll(2, 4);
+        for (int i = 0; i < count; ++i) {
+            choices.append(text());
+        }
+        list.append(command(102, indent, {choices, 1, 0, 2, 0}));
+        for (int i = 0; i < count; ++i) {
+            list.append(command(402, indent, {i, choices.at(i)}));
+            if (chance(60)) {
+                appendMessage(list, indent + 1);
+            }
+            list.append(command(0, indent + 1, {}));
+        }
+        list.append(command(404, indent, {}));
+    }
+
+    void appendPluginCommand(QJsonArray &list, int indent)
+    {
+        if (m_settings.mz) {
+            const QJsonObject args{
+                {QStringLiteral("text"), chance(50) ? text() : QString()},
+                {QStringLiteral("id"), QString::number(roll(1, 99))},
+            };
+            list.append(command(357, indent, {QStringLiteral("Bga%1Core").arg(name()), QStringLiteral("show"), QString(), args}));
+        } else {
+            list.append(command(356, indent, {QStringLiteral("%1 open %2").arg(name()).arg(roll(1, 20))}));
+        }
+    }
+
+    // Commands without translatable text that real events are full of
+    void appendFiller(QJsonArray &list, int indent)
+    {
+        if (chance(m_settings.pluginCommandPercent)) {
+            appendPluginCommand(list, indent);
+            return;
+        }
+        switch (m_random.bounded(9)) {
+        case 0:
+            list.append(command(121, indent, {roll(1, 100), roll(1, 100), roll(0, 1)}));
+            break;
+        case 1:
+            list.append(command(122, indent, {roll(1, 50), roll(1, 50), 0, 0, roll(0, 999)}));
+            break;
+        case 2:
+            list.append(command(250, indent, {audio(QStringLiteral("Decision%1").arg(roll(1, 3)))}));
+            break;
+        case 3:
+            list.append(command(230, indent, {roll(10, 60)}));
+            break;
+        case 4:
+            list.append(command(231, indent, {roll(1, 10), QStringLiteral("pic_%1").arg(name().toLower()), 0, 0, 0, 0, 100, 100, 255, 0}));
+            break;
+        case 5:
+            list.append(command(108, indent, {QStringLiteral("TODO: %1").arg(pick(kWords))}));
+            break;
+        case 6:
+            list.append(command(355, indent, {QStringLiteral("$gameVariables.setValue(%1, %2);").arg(roll(1, 50)).arg(roll(0, 99))}));
+            break;
+        case 7:
+            list.append(command(123, indent, {QStringLiteral("A"), 0}));
+            break;
+        default:
+            list.append(command(201, indent, {0, roll(1, qMax(1, m_settings.maps)), roll(0, 16), roll(0, 12), 2, 0}));
+            break;
+        }
+    }
+
+    // An event command list with about `messages` Show Text commands
+    QJsonArray commandList(int messages)
+    {
+        QJsonArray list;
+        for (int i = 0; i < messages; ++i) {
+            appendFiller(list, 0);
+            if (chance(10)) {
+                list.append(command(111, 0, {0, roll(1, 100), 0}));
+                appendMessage(list, 1);
+                list.append(command(0, 1, {}));
+                list.append(command(412, 0, {}));
+            } else if (chance(8)) {
+                appendChoices(list, 0);
+            } else if (chance(3)) {
+                list.append(command(105, 0, {2, false}));
+                list.append(command(405, 0, {text()}));
+                list.append(command(405, 0, {text()}));
+            } else if (chance(2)) {
+                list.append(command(320, 0, {roll(1, m_settings.databaseEntries), name()}));
+            } else {
+                appendMessage(list, 0);
+            }
+        }
+        list.append(command(0, 0, {}));
+        return list;
+    }
+
+    int messageCount()
+    {
+        const int mean = m_settings.messagesPerPage;
+        return mean > 0 ? roll(mean / 2, mean + mean / 2) : 0;
+    }
+
+    static QJsonArray traits()
+    {
+        return QJsonArray{QJsonObject{
+            {QStringLiteral("code"), 23},
+            {QStringLiteral("dataId"), 0},
+            {QStringLiteral("value"), 1},
+        }};
+    }
+
+    QJsonObject databaseEntry(const QString &file, int id)
+    {
+        QJsonObject entry{
+            {QStringLiteral("id"), id},
+            {QStringLiteral("name"), name()},
+            {QStringLiteral("note"), chance(10) ? QStringLiteral("<tag:%1>").arg(roll(1, 9)) : QString()},
+            {QStringLiteral("iconIndex"), roll(0, 300)},
+            {QStringLiteral("traits"), traits()},
+        };
+        if (file == QLatin1String("Actors")) {
+            entry.insert(QStringLiteral("nickname"), name());
+            const QString firstLine = text(); // Separate statements: operands of + are unsequenced
+            entry.insert(QStringLiteral("profile"), firstLine + QLatin1Char('\n') + text());
+            entry.insert(QStringLiteral("battlerName"), QStringLiteral("Actor%1_%2").arg(roll(1, 3)).arg(roll(1, 8)));
+            entry.insert(QStringLiteral("characterName"), QStringLiteral("Actor%1").arg(roll(1, 3)));
+            entry.insert(QStringLiteral("characterIndex"), roll(0, 7));
+            entry.insert(QStringLiteral("faceName"), QStringLiteral("Actor%1").arg(roll(1, 3)));
+            entry.insert(QStringLiteral("faceIndex"), roll(0, 7));
+            entry.insert(QStringLiteral("classId"), roll(1, m_settings.databaseEntries));
+            entry.insert(QStringLiteral("equips"), QJsonArray{roll(0, 9), roll(0, 9), 0, 0, 0});
+            entry.insert(QStringLiteral("initialLevel"), 1);
+            entry.insert(QStringLiteral("maxLevel"), 99);
+        } else if (file == QLatin1String("Classes")) {
+            entry.insert(QStringLiteral("expParams"), QJsonArray{30, 20, 30, 30});
+            entry.insert(QStringLiteral("learnings"), QJsonArray{QJsonObject{
+                {QStringLiteral("level"), roll(1, 50)},
+                {QStringLiteral("note"), QString()},
+                {QStringLiteral("skillId"), roll(1, m_settings.databaseEntries)},
+            }});
+            QJsonArray params;
+            for (int i = 0; i < 8; ++i) {
+                QJsonArray curve;
+                for (int level = 0; level < 100; ++level) {
+                    curve.append(100 + level * roll(1, 20));
+                }
+                params.append(curve);
+            }
+            entry.insert(QStringLiteral("params"), params);
+        } else if (file == QLatin1String("Skills") || file == QLatin1String("Items")) {
+            entry.insert(QStringLiteral("description"), text());
+            entry.insert(QStringLiteral("animationId"), roll(0, 120));
+            entry.insert(QStringLiteral("damage"), QJsonObject{
+                {QStringLiteral("critical"), false},
+                {QStringLiteral("elementId"), 0},
+                {QStringLiteral("formula"), QStringLiteral("a.atk * %1 - b.def * 2").arg(roll(2, 6))},
+                {QStringLiteral("type"), 1},
+                {QStringLiteral("variance"), 20},
+            });
+            entry.insert(QStringLiteral("effects"), QJsonArray{});
+            entry.insert(QStringLiteral("scope"), roll(0, 11));
+            entry.insert(QStringLiteral("speed"), 0);
+            entry.insert(QStringLiteral("successRate"), 100);
+            if (file == QLatin1String("Skills")) {
+                entry.insert(QStringLiteral("message1"), QStringLiteral(" casts %1!").arg(name()));
+                entry.insert(QStringLiteral("message2"), QString());
+                entry.insert(QStringLiteral("mpCost"), roll(0, 50));
+                entry.insert(QStringLiteral("stypeId"), roll(1, 2));
+            } else {
+                entry.insert(QStringLiteral("consumable"), true);
+                entry.insert(QStringLiteral("price"), roll(1, 100) * 10);
+            }
+        } else if (file == QLatin1String("Weapons") || file == QLatin1String("Armors")) {
+            entry.insert(QStringLiteral("description"), text());
+            entry.insert(QStringLiteral("params"), QJsonArray{0, 0, roll(1, 50), roll(0, 30), 0, 0, 0, 0});
+            entry.insert(QStringLiteral("price"), roll(1, 100) * 50);
+            entry.insert(QStringLiteral("etypeId"), roll(1, 5));
+            entry.insert(file == QLatin1String("Weapons") ? QStringLiteral("wtypeId") : QStringLiteral("atypeId"), roll(1, 6));
+        } else if (file == QLatin1String("Enemies")) {
+            entry.insert(QStringLiteral("battlerName"), QStringLiteral("enemy_%1").arg(name().toLower()));
+            entry.insert(QStringLiteral("battlerHue"), 0);
+            entry.insert(QStringLiteral("exp"), roll(1, 500));
+            entry.insert(QStringLiteral("gold"), roll(1, 500));
+            entry.insert(QStringLiteral("params"), QJsonArray{roll(50, 900), 0, roll(5, 60), roll(5, 60), 10, 10, 10, 10});
+            entry.insert(QStringLiteral("actions"), QJsonArray{QJsonObject{
+                {QStringLiteral("conditionParam1"), 0},
+                {QStringLiteral("conditionParam2"), 0},
+                {QStringLiteral("conditionType"), 0},
+                {QStringLiteral("rating"), 5},
+                {QStringLiteral("skillId"), 1},
+            }});
+            entry.insert(QStringLiteral("dropItems"), QJsonArray{});
+        } else if (file == QLatin1String("States")) {
+            for (int i = 1; i <= 4; ++i) {
+                entry.insert(QStringLiteral("message%1").arg(i), chance(60) ? QStringLiteral(" is %1!").arg(pick(kWords)) : QString());
+            }
+            entry.insert(QStringLiteral("restriction"), roll(0, 4));
+            entry.insert(QStringLiteral("minTurns"), 1);
+            entry.insert(QStringLiteral("maxTurns"), roll(1, 5));
+            entry.insert(QStringLiteral("priority"), roll(0, 100));
+        }
+        return entry;
+    }
+
+    QJsonArray databaseFile(const QString &file)
+    {
+        QJsonArray entries{QJsonValue()};
+        for (int id = 1; id <= m_settings.databaseEntries; ++id) {
+            entries.append(databaseEntry(file, id));
+        }
+        return entries;
+    }
+
+    QJsonObject systemFile()
+    {
+        QJsonArray switches{QString()};
+        QJsonArray variables{QString()};
+        for (int i = 1; i <= 100; ++i) {
+            switches.append(QStringLiteral("sw_%1").arg(name().toLower()));
+            variables.append(QStringLiteral("var_%1").arg(name().toLower()));
+        }
+
+        const QJsonObject messages{
+            {QStringLiteral("actionFailure"), QStringLiteral("There was no effect on %1!")},
+            {QStringLiteral("actorDamage"), QStringLiteral("%1 took %2 damage!")},
+            {QStringLiteral("defeat"), QStringLiteral("%1 was defeated.")},
+            {QStringLiteral("emerge"), QStringLiteral("%1 emerged!")},
+            {QStringLiteral("escapeFailure"), QStringLiteral("However, it was unable to escape!")},
+            {QStringLiteral("obtainGold"), QStringLiteral("%1\\G found!")},
+            {QStringLiteral("victory"), QStringLiteral("%1 was victorious!")},
+        };
+
+        return QJsonObject{
+            {QStringLiteral("gameTitle"), QStringLiteral("%1 Chronicles").arg(name())},
+            {QStringLiteral("currencyUnit"), QStringLiteral("G")},
+            {QStringLiteral("locale"), QStringLiteral("en_US")},
+            {QStringLiteral("versionId"), static_cast<qint64>(m_settings.seed)},
+            {QStringLiteral("elements"), QJsonArray{QString(), QStringLiteral("Physical"), QStringLiteral("Fire"), QStringLiteral("Ice")}},
+            {QStringLiteral("skillTypes"), QJsonArray{QString(), QStringLiteral("Magic"), QStringLiteral("Special")}},
+            {QStringLiteral("weaponTypes"), QJsonArray{QString(), QStringLiteral("Dagger"), QStringLiteral("Sword")}},
+            {QStringLiteral("armorTypes"), QJsonArray{QString(), QStringLiteral("General Armor"), QStringLiteral("Magic Armor")}},
+            {QStringLiteral("equipTypes"), QJsonArray{QString(), QStringLiteral("Weapon"), QStringLiteral("Shield"), QStringLiteral("Head")}},
+            {QStringLiteral("switches"), switches},
+            {QStringLiteral("variables"), variables},
+            {QStringLiteral("titleBgm"), audio(QStringLiteral("Theme6"))},
+            {QStringLiteral("terms"), QJsonObject{
+                {QStringLiteral("basic"), QJsonArray{QStringLiteral("Level"), QStringLiteral("Lv"), QStringLiteral("HP"), QStringLiteral("HP")}},
+                {QStringLiteral("commands"), QJsonArray{QStringLiteral("Fight"), QStringLiteral("Escape"), QStringLiteral("Attack"), QStringLiteral("Guard")}},
+                {QStringLiteral("params"), QJsonArray{QStringLiteral("Max HP"), QStringLiteral("Max MP"), QStringLiteral("Attack")}},
+                {QStringLiteral("messages"), messages},
+            }},
+        };
+    }
+
+    static QJsonArray tilesetsFile()
+    {
+        QJsonArray flags;
+        for (int i = 0; i < 8192; ++i) {
+            flags.append(i % 16 == 0 ? 16 : 0);
+        }
+        return QJsonArray{QJsonValue(), QJsonObject{
+            {QStringLiteral("id"), 1},
+            {QStringLiteral("flags"), flags},
+            {QStringLiteral("mode"), 1},
+            {QStringLiteral("name"), QStringLiteral("Field")},
+            {QStringLiteral("note"), QString()},
+            {QStringLiteral("tilesetNames"), QJsonArray{QStringLiteral("Outside_A1"), QStringLiteral("Outside_A2"), QStringLiteral("Outside_B")}},
+        }};
+    }
+
+    QJsonArray animationsFile()
+    {
+        QJsonArray animations{QJsonValue()};
+        for (int id = 1; id <= qMax(1, m_settings.databaseEntries / 4); ++id) {
+            QJsonArray frames;
+            for (int frame = 0; frame < 12; ++frame) {
+                // One cell per frame; QJsonArray{QJsonArray{...}} would copy instead of nesting
+                QJsonArray cells;
+                cells.append(QJsonArray{roll(0, 99), roll(-100, 100), roll(-100, 100), 100, 0, 0, 255, 1});
+                frames.append(cells);
+            }
+            animations.append(QJsonObject{
+                {QStringLiteral("id"), id},
+                {QStringLiteral("animation1Name"), QStringLiteral("Hit%1").arg(roll(1, 3))},
+                {QStringLiteral("frames"), frames},
+                {QStringLiteral("name"), name()},
+                {QStringLiteral("position"), 1},
+                {QStringLiteral("timings"), QJsonArray{QJsonObject{
+                    {QStringLiteral("flashColor"), QJsonArray{255, 255, 255, 170}},
+                    {QStringLiteral("flashDuration"), 5},
+                    {QStringLiteral("flashScope"), 1},
+                    {QStringLiteral("frame"), 0},
+                    {QStringLiteral("se"), audio(QStringLiteral("Slash1"))},
+                }}},
+            });
+        }
+        return animations;
+    }
+
+    QJsonArray commonEventsFile()
+    {
+        QJsonArray events{QJsonValue()};
+        for (int id = 1; id <= m_settings.commonEvents; ++id) {
+            events.append(QJsonObject{
+                {QStringLiteral("id"), id},
+                {QStringLiteral("list"), commandList(messageCount())},
+                {QStringLiteral("name"), QStringLiteral("CE_%1").arg(name())},
+                {QStringLiteral("switchId"), 1},
+                {QStringLiteral("trigger"), 0},
+            });
+        }
+        return events;
+    }
+
+    QJsonArray troopsFile()
+    {
+        QJsonArray troops{QJsonValue()};
+        for (int id = 1; id <= m_settings.troops; ++id) {
+            QJsonArray members;
+            const int count = roll(1, 4);
+            for (int i = 0; i < count; ++i) {
+                members.append(QJsonObject{
+                    {QStringLiteral("enemyId"), roll(1, m_settings.databaseEntries)},
+                    {QStringLiteral("hidden"), false},
+                    {QStringLiteral("x"), 200 + i * 150},
+                    {QStringLiteral("y"), 400},
+                });
+            }
+            // Battle event: usually a short exchange on the first turn
+            const QJsonObject page{
+                {QStringLiteral("conditions"), QJsonObject{
+                    {QStringLiteral("turnA"), 0},
+                    {QStringLiteral("turnB"), 0},
+                    {QStringLiteral("turnValid"), true},
+                }},
+                {QStringLiteral("list"), commandList(roll(0, 2))},
+                {QStringLiteral("span"), 0},
+            };
+            troops.append(QJsonObject{
+                {QStringLiteral("id"), id},
+                {QStringLiteral("members"), members},
+                {QStringLiteral("name"), name() + QStringLiteral(" x%1").arg(count)},
+                {QStringLiteral("pages"), QJsonArray{page}},
+            });
+        }
+        return troops;
+    }
+
+    QJsonArray mapInfosFile()
+    {
+        QJsonArray infos{QJsonValue()};
+        for (int id = 1; id <= m_settings.maps; ++id) {
+            infos.append(QJsonObject{
+                {QStringLiteral("id"), id},
+                {QStringLiteral("expanded"), false},
+                {QStringLiteral("name"), QStringLiteral("MAP%1").arg(id, 3, 10, QLatin1Char('0'))},
+                {QStringLiteral("order"), id},
+                {QStringLiteral("parentId"), id > 1 && chance(30) ? roll(1, id - 1) : 0},
+                {QStringLiteral("scrollX"), 0},
+                {QStringLiteral("scrollY"), 0},
+            });
+        }
+        return infos;
+    }
+
+    QJsonObject eventPage(int pageIndex)
+    {
+        const QJsonObject conditions{
+            {QStringLiteral("actorId"), 1},
+            {QStringLiteral("actorValid"), false},
+            {QStringLiteral("itemId"), 1},
+            {QStringLiteral("itemValid"), false},
+            {QStringLiteral("selfSwitchCh"), QStringLiteral("A")},
+            {QStringLiteral("selfSwitchValid"), pageIndex > 0},
+            {QStringLiteral("switch1Id"), 1},
+            {QStringLiteral("switch1Valid"), false},
+            {QStringLiteral("switch2Id"), 1},
+            {QStringLiteral("switch2Valid"), false},
+            {QStringLiteral("variableId"), 1},
+            {QStringLiteral("variableValid"), false},
+            {QStringLiteral("variableValue"), 0},
+        };
+        const QJsonObject image{
+            {QStringLiteral("characterIndex"), roll(0, 7)},
+            {QStringLiteral("characterName"), QStringLiteral("People%1").arg(roll(1, 4))},
+            {QStringLiteral("direction"), 2},
+            {QStringLiteral("pattern"), 1},
+            {QStringLiteral("tileId"), 0},
+        };
+        const QJsonObject moveRoute{
+            {QStringLiteral("list"), QJsonArray{QJsonObject{{QStringLiteral("code"), 0}, {QStringLiteral("parameters"), QJsonArray{}}}}},
+            {QStringLiteral("repeat"), true},
+            {QStringLiteral("skippable"), false},
+            {QStringLiteral("wait"), false},
+        };
+        return QJsonObject{
+            {QStringLiteral("conditions"), conditions},
+            {QStringLiteral("directionFix"), false},
+            {QStringLiteral("image"), image},
+            {QStringLiteral("list"), commandList(messageCount())},
+            {QStringLiteral("moveFrequency"), 3},
+            {QStringLiteral("moveRoute"), moveRoute},
+            {QStringLiteral("moveSpeed"), 3},
+            {QStringLiteral("moveType"), roll(0, 1)},
+            {QStringLiteral("priorityType"), 1},
+            {QStringLiteral("stepAnime"), false},
+            {QStringLiteral("through"), false},
+            {QStringLiteral("trigger"), roll(0, 3)},
+            {QStringLiteral("walkAnime"), true},
+        };
+    }
+
+    QJsonObject mapFile()
+    {
+        const int width = roll(17, 40);
+        const int height = roll(13, 30);
+
+        // Six tile layers, as in the editor's output; dominated by a few ground tiles
+        QJsonArray tiles;
+        for (int i = 0; i < width * height * 6; ++i) {
+            tiles.append(i < width * height ? 2816 + 48 * m_random.bounded(4) : (chance(5) ? roll(1, 255) : 0));
+        }
+
+        QJsonArray events{QJsonValue()};
+        for (int id = 1; id <= m_settings.eventsPerMap; ++id) {
+            QJsonArray pages;
+            const int pageCount = chance(25) ? 2 : 1;
+            for (int page = 0; page < pageCount; ++page) {
+                pages.append(eventPage(page));
+            }
+            events.append(QJsonObject{
+                {QStringLiteral("id"), id},
+                {QStringLiteral("name"), QStringLiteral("EV%1").arg(id, 3, 10, QLatin1Char('0'))},
+                {QStringLiteral("note"), QString()},
+                {QStringLiteral("pages"), pages},
+                {QStringLiteral("x"), roll(0, width - 1)},
+                {QStringLiteral("y"), roll(0, height - 1)},
+            });
+        }
+
+        return QJsonObject{
+            {QStringLiteral("autoplayBgm"), true},
+            {QStringLiteral("autoplayBgs"), false},
+            {QStringLiteral("battleback1Name"), QString()},
+            {QStringLiteral("battleback2Name"), QString()},
+            {QStringLiteral("bgm"), audio(QStringLiteral("Town%1").arg(roll(1, 3)))},
+            {QStringLiteral("bgs"), audio(QString())},
+            {QStringLiteral("data"), tiles},
+            {QStringLiteral("disableDashing"), false},
+            {QStringLiteral("displayName"), chance(50) ? QStringLiteral("%1 %2").arg(name()).arg(pick(kWords)) : QString()},
+            {QStringLiteral("encounterList"), QJsonArray{QJsonObject{
+                {QStringLiteral("regionSet"), QJsonArray{}},
+                {QStringLiteral("troopId"), roll(1, qMax(1, m_settings.troops))},
+                {QStringLiteral("weight"), 5},
+            }}},
+            {QStringLiteral("encounterStep"), 30},
+            {QStringLiteral("events"), events},
+            {QStringLiteral("height"), height},
+            {QStringLiteral("note"), QString()},
+            {QStringLiteral("parallaxLoopX"), false},
+            {QStringLiteral("parallaxLoopY"), false},
+            {QStringLiteral("parallaxName"), QString()},
+            {QStringLiteral("parallaxShow"), true},
+            {QStringLiteral("parallaxSx"), 0},
+            {QStringLiteral("parallaxSy"), 0},
+            {QStringLiteral("scrollType"), 0},
+            {QStringLiteral("specifyBattleback"), false},
+            {QStringLiteral("tilesetId"), 1},
+            {QStringLiteral("width"), width},
+        };
+    }
+
+    GeneratorSettings m_settings;
+    QRandomGenerator m_random;
+    QDir m_dataDir;
+    int m_filesWritten = 0;
+    qint64 m_bytesWritten = 0;
+    qint64 m_textsGenerated = 0;
+};
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName(QStringLiteral("BGA Project Generator"));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Writes a synthetic RPG Maker MV/MZ data folder for scale testing. "
+                                                    "The same seed and settings always give the same files."));
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument(QStringLiteral("output"), QStringLiteral("Project directory; the files go to its data/ folder"));
+
+    const GeneratorSettings defaults;
+    auto intOption = [&](const QString &name, const QString &description, int defaultValue) {
+        QCommandLineOption option(name, QStringLiteral("%1 (default: %2).").arg(description).arg(defaultValue),
+                                  QStringLiteral("n"), QString::number(defaultValue));
+        parser.addOption(option);
+        return option;
+    };
+
+    const QCommandLineOption seedOption = intOption(QStringLiteral("seed"), QStringLiteral("Random seed"), static_cast<int>(defaults.seed));
+    const QCommandLineOption mapsOption = intOption(QStringLiteral("maps"), QStringLiteral("Number of maps"), defaults.maps);
+    const QCommandLineOption eventsOption = intOption(QStringLiteral("events"), QStringLiteral("Events per map"), defaults.eventsPerMap);
+    const QCommandLineOption dialogueOption = intOption(QStringLiteral("dialogue"), QStringLiteral("Average Show Text commands per event page"), defaults.messagesPerPage);
+    const QCommandLineOption pluginOption = intOption(QStringLiteral("plugin-commands"), QStringLiteral("Percentage of non-text commands that are plugin commands"), defaults.pluginCommandPercent);
+    const QCommandLineOption commonEventsOption = intOption(QStringLiteral("common-events"), QStringLiteral("Number of common events"), defaults.commonEvents);
+    const QCommandLineOption troopsOption = intOption(QStringLiteral("troops"), QStringLiteral("Number of troops"), defaults.troops);
+    const QCommandLineOption databaseOption = intOption(QStringLiteral("database"), QStringLiteral("Entries per database file"), defaults.databaseEntries);
+
+    QCommandLineOption formatOption(QStringLiteral("format"),
+                                    QStringLiteral("RPG Maker version to imitate: mv or mz (default: mz)."),
+                                    QStringLiteral("format"),
+                                    QStringLiteral("mz"));
+    parser.addOption(formatOption);
+
+    parser.process(app);
+
+    const QStringList args = parser.positionalArguments();
+    if (args.size() != 1) {
+        parser.showHelp(EXIT_FAILURE);
+    }
+
+    const QString format = parser.value(formatOption).toLower();
+    if (format != QLatin1String("mv") && format != QLatin1String("mz")) {
+        QTextStream(stderr) << "Unknown format: " << format << '\n';
+        return EXIT_FAILURE;
+    }
+
+    GeneratorSettings settings;
+    settings.mz = format == QLatin1String("mz");
+    bool ok = true;
+    const auto readCount = [&](const QCommandLineOption &option, int minimum) {
+        bool valid = false;
+        const int value = parser.value(option).toInt(&valid);
+        if (!valid || value < minimum) {
+            QTextStream(stderr) << "Invalid value for --" << option.names().constFirst() << ": " << parser.value(option) << '\n';
+            ok = false;
+        }
+        return value;
+    };
+    settings.seed = static_cast<quint32>(parser.value(seedOption).toUInt());
+    settings.maps = readCount(mapsOption, 0);
+    settings.eventsPerMap = readCount(eventsOption, 0);
+    settings.messagesPerPage = readCount(dialogueOption, 0);
+    settings.pluginCommandPercent = readCount(pluginOption, 0);
+    settings.commonEvents = readCount(commonEventsOption, 0);
+    settings.troops = readCount(troopsOption, 0);
+    settings.databaseEntries = readCount(databaseOption, 1);
+    if (!ok) {
+        return EXIT_FAILURE;
+    }
+
+    const QString dataPath = QDir(args.at(0)).filePath(QStringLiteral("data"));
+    ProjectGenerator generator(settings);
+    QString errorMessage;
+    if (!generator.generate(dataPath, &errorMessage)) {
+        QTextStream(stderr) << errorMessage << '\n';
+        return EXIT_FAILURE;
+    }
+
+    QTextStream(stdout) << "Wrote " << generator.filesWritten() << " files (" << generator.bytesWritten() / 1024
+                        << " KiB) with about " << generator.textsGenerated() << " texts to " << QDir::toNativeSeparators(dataPath) << '\n';
+    return EXIT_SUCCESS;
+}
@@ -1,8 +1,11 @@
 #include "core/analyzerfactory.h"
+#include "core/analyzerpayload.h"
 
 #include <QtCore/QCoreApplication>
 #include <QtCore/QCommandLineParser>
+#include <QtCore/QElapsedTimer>
 #include <QtCore/QFile>
+#include <QtCore/QJsonArray>
 #include <QtCore/QTextStream>
 
 int main(int argc, char *argv[])
@@ -21,6 +24,22 @@ int main(int argc, char *argv[])
     parser.addPositionalArgument(QStringLiteral("input"), QStringLiteral("Input path"));
     parser.addPositionalArgument(QStringLiteral("output"), QStringLiteral("Output file"));
 
+    QCommandLineOption formatOption(QStringList{QStringLiteral("f"), QStringLiteral("format")},
+                                    QStringLiteral("Payload format to request: json or cbor (default: json)."),
+                                    QStringLiteral("format"),
+                                    QStringLiteral("json"));
+    parser.addOption(formatOption);
+
+    QCommandLineOption threadsOption(QStringList{QStringLiteral("j"), QStringLiteral("threads")},
+                                     QStringLiteral("Worker threads for per-file extraction; 0 for one per core, 1 for a serial run (default: 0)."),
+                                     QStringLiteral("count"),
+                                     QStringLiteral("0"));
+    parser.addOption(threadsOption);
+
+    QCommandLineOption unorderedOption(QStringLiteral("unordered"),
+                                       QStringLiteral("Report files as soon as they are extracted instead of in serial order."));
+    parser.addOption(unorderedOption);
+
     parser.process(app);
 
     const QStringList args = parser.positionalArguments();
@@ -32,13 +51,32 @@ int main(int argc, char *argv[])
     const QString inputPath = args.at(1);
     const QString outputPath = args.at(2);
 
+    const QString formatName = parser.value(formatOption).toLower();
+    if (formatName != QLatin1String("json") && formatName != QLatin1String("cbor")) {
+        QTextStream(stderr) << "Unknown payload format: " << formatName << '\n';
+        return EXIT_FAILURE;
+    }
+
+    bool threadsOk = false;
+    const int threads = parser.value(threadsOption).toInt(&threadsOk);
+    if (!threadsOk || threads < 0) {
+        QTextStream(stderr) << "Invalid thread count: " << parser.value(threadsOption) << '\n';
+        return EXIT_FAILURE;
+    }
+
     auto analyzer = core::createAnalyzer(engine);
     if (!analyzer) {
         QTextStream(stderr) << "Unknown analyzer engine: " << engine << '\n';
         return EXIT_FAILURE;
     }
+    analyzer->setOutputFormat(formatName == QLatin1String("cbor") ? QString(core::kCborPayloadFormat)
+                                                                  : QString(core::kJsonPayloadFormat));
+    analyzer->setParallelism(threads, !parser.isSet(unorderedOption));
 
+    QElapsedTimer timer;
+    timer.start();
     const auto result = analyzer->analyze(inputPath);
+    const qint64 analyzeMs = timer.elapsed();
 
     QFile outputFile(outputPath);
     if (!outputFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
@@ -51,5 +89,21 @@ int main(int argc, char *argv[])
         return EXIT_FAILURE;
     }
 
+    // Decode the payload the way the application does, to compare formats
+    timer.restart();
+    QJsonObject root;
+    QString errorMessage;
+    if (!core::AnalyzerPayload::decode(result, &root, &errorMessage)) {
+        QTextStream(stderr) << errorMessage << '\n';
+        return EXIT_FAILURE;
+    }
+    const qint64 decodeMs = timer.elapsed();
+
+    QTextStream(stderr) << "Format: " << result.format
+                        << ", payload: " << result.payload.size() << " bytes"
+                        << ", entries: " << core::AnalyzerPayload::strings(root).size()
+                        << ", analyze: " << analyzeMs << " ms"
+                        << ", decode: " << decodeMs << " ms" << '\n';
+
     return EXIT_SUCCESS;
 }
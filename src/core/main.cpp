@@ -12,6 +12,7 @@
 
 // Now we can include Qt headers
 #include "mainwindow.h"
+#include "core/logger.h"
 
 #include <QApplication>
 #include <QLocale>
@@ -164,6 +165,10 @@ int main(int argc, char *argv[])
     QApplication a(argc, argv);
     std::cerr << "[NST] QApplication created" << std::endl;
 
+    // Drain the log while the writer thread is still alive; the logger's static destructor
+    // runs too late for that on some platforms
+    QObject::connect(&a, &QCoreApplication::aboutToQuit, [] { core::Logger::instance().shutdown(); });
+
     // Fix: Correct resource path for stylesheet (was :/style.qss, needed :/ui/style.qss)
     QFile file(":/ui/style.qss");
     if (file.open(QFile::ReadOnly | QFile::Text)) {
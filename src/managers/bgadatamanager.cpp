@@ -1,15 +1,63 @@
 #include "bgadatamanager.h"
+#include <core/logger.h>
 #include <QThread> // Required for QThread::currentThreadId()
 #include <QDebug>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QFile>
-#include <QTextStream>
 #include <QStandardPaths>
 #include <QDir>
 #include <QFileInfo>
 
+namespace {
+
+// Forwards a streamed analysis to the manager: the entries of each file are reported through
+// entriesLoaded() as soon as the file is done, file progress is mapped onto the 25-90% range.
+class LoadingSink : public core::IAnalysisSink
+{
+public:
+    explicit LoadingSink(BGADataManager *manager)
+        : m_manager(manager)
+    {
+    }
+
+    qsizetype entryCount() const { return m_entryCount; }
+    int fileCount() const { return m_fileCount; }
+
+    void fontsFound(const QJsonArray &fonts) override
+    {
+        m_manager->setLoadedFonts(fonts);
+    }
+
+    void entriesExtracted(const QString &filePath, const QJsonArray &entries) override
+    {
+        m_entryCount += entries.size();
+        m_fileCount++;
+        emit m_manager->entriesLoaded(filePath, entries);
+    }
+
+    void progress(int done, int total) override
+    {
+        if (total > 0) {
+            emit m_manager->progressUpdated(25 + 65 * done / total,
+                                            QString("Analyzing game project... (%1/%2 files)").arg(done).arg(total));
+        }
+    }
+
+    bool isCancelled() const override
+    {
+        return m_manager->isLoadingCancelled();
+    }
+
+private:
+    BGADataManager *m_manager;
+    qsizetype m_entryCount = 0;
+    int m_fileCount = 0;
+};
+
+} // namespace
+
 BGADataManager::BGADataManager(QObject *parent)
     : QObject(parent)
 {
@@ -20,104 +68,119 @@ QJsonArray BGADataManager::loadedFonts() const
     return m_loadedFonts;
 }
 
-QStringList BGADataManager::getAvailableAnalyzers() const
+void BGADataManager::setLoadedFonts(const QJsonArray &fonts)
 {
-    return core::availableAnalyzers();
+    m_loadedFonts = fonts;
+    emit fontsLoaded(m_loadedFonts);
 }
 
-QJsonArray BGADataManager::loadStringsFromGameProject(const QString &engineName, const QString &projectPath)
+void BGADataManager::cancelLoading()
 {
-    qDebug() << "BGADataManager: loadStringsFromGameProject called in thread:" << QThread::currentThreadId();
-    emit progressUpdated(0, "Starting project analysis...");
+    m_loadingCancelled = true;
+}
+
+bool BGADataManager::isLoadingCancelled() const
+{
+    return m_loadingCancelled;
+}
+
+void BGADataManager::setAnalysisCacheFile(const QString &manifestPath)
+{
+    m_analysisCacheFile = manifestPath;
+}
+
+void BGADataManager::setDocumentCacheBudget(qint64 bytes)
+{
+    QMutexLocker analyzerLock(&m_analyzerMutex);
+    m_documentCacheBudget = bytes;
+    if (m_analyzer) {
+        m_analyzer->setDocumentCacheBudget(bytes);
+    }
+}
 
-    QString logFilePath = "bgadatamanager_log.txt";
-    QFile logFile(logFilePath);
-    if (!logFile.open(QIODevice::WriteOnly | QIODevice::Append)) {
-        return QJsonArray();
+core::IGameAnalyzer *BGADataManager::analyzerFor(const QString &engineName)
+{
+    if (!m_analyzer || m_analyzerEngine != engineName) {
+        m_analyzer = core::createAnalyzer(engineName);
+        m_analyzerEngine = m_analyzer ? engineName : QString();
+        if (m_analyzer) {
+            m_analyzer->setDocumentCacheBudget(m_documentCacheBudget);
+        }
     }
-    QTextStream logStream(&logFile);
+    return m_analyzer.get();
+}
 
-    QJsonArray extractedTextsArray;
+QStringList BGADataManager::getAvailableAnalyzers() const
+{
+    return core::availableAnalyzers();
+}
 
-    logStream << "BGADataManager: Creating analyzer for engine: " << engineName << "\n";
-    std::unique_ptr<core::IGameAnalyzer> analyzer = core::createAnalyzer(engineName);
+core::AnalysisStatus BGADataManager::loadStringsFromGameProject(const QString &engineName, const QString &projectPath)
+{
+    BGA_LOG_DEBUG("datamanager", QStringLiteral("loadStringsFromGameProject called in thread: %1")
+                                     .arg(reinterpret_cast<quintptr>(QThread::currentThreadId())));
+    m_loadingCancelled = false;
+    emit progressUpdated(0, "Starting project analysis...");
+
+    BGA_LOG_INFO("datamanager", QStringLiteral("Creating analyzer for engine: %1").arg(engineName));
+    QMutexLocker analyzerLock(&m_analyzerMutex);
+    core::IGameAnalyzer *analyzer = analyzerFor(engineName);
     if (!analyzer) {
         emit errorOccurred(QString("Failed to create analyzer for engine: %1").arg(engineName));
-        logStream << "BGADataManager: Failed to create analyzer." << "\n";
-        logFile.close();
+        BGA_LOG_ERROR("datamanager", QStringLiteral("Failed to create analyzer."));
         emit loadingFinished();
-        return extractedTextsArray;
+        return core::AnalysisStatus::Failed;
+    }
+
+    // Set on every load: the analyzer outlives a project, and an empty path turns the cache off
+    analyzer->setCacheFile(m_analysisCacheFile);
+    if (!m_analysisCacheFile.isEmpty()) {
+        BGA_LOG_INFO("datamanager", QStringLiteral("Using analysis cache: %1").arg(m_analysisCacheFile));
     }
 
     emit progressUpdated(25, "Analyzing game project...");
-    logStream << "BGADataManager: Calling analyzer->analyze for project: " << projectPath << "\n";
-    core::AnalyzerOutput output = analyzer->analyze(projectPath);
-    logStream << "BGADataManager: Analyzer output payload size:" << output.payload.size() << "bytes" << "\n";
-
-    if (!output.errorMessage.isEmpty()) { // Check for error message from analyzer
-        emit errorOccurred(output.errorMessage);
-        logStream << "BGADataManager: Analyzer returned error: " << output.errorMessage << "\n";
-        logFile.close();
+    BGA_LOG_INFO("datamanager", QStringLiteral("Calling analyzer->analyzeStream for project: %1").arg(projectPath));
+
+    // Entries arrive file by file, already grouped, so the project never exists as one big
+    // payload here and needs no regrouping afterwards
+    LoadingSink sink(this);
+    QString errorMessage;
+    const core::AnalysisStatus status = analyzer->analyzeStream(projectPath, sink, &errorMessage);
+
+    if (status == core::AnalysisStatus::Failed) {
+        emit errorOccurred(errorMessage);
+        BGA_LOG_ERROR("datamanager", QStringLiteral("Analyzer returned error: %1").arg(errorMessage));
         emit loadingFinished();
-        return extractedTextsArray; // Return empty array on error
+        return status;
     }
 
-    if (output.payload.isEmpty()) {
-        emit errorOccurred(QString("No data extracted from project: %1").arg(projectPath));
-        logStream << "BGADataManager: No data extracted from project." << "\n";
-        logFile.close();
+    if (status == core::AnalysisStatus::Cancelled) {
+        BGA_LOG_INFO("datamanager", QStringLiteral("Analysis cancelled."));
         emit loadingFinished();
-        return extractedTextsArray;
-    }
-
-    emit progressUpdated(75, "Parsing extracted data...");
-    logStream << "BGADataManager: Before QJsonDocument::fromJson" << "\n";
-    if (output.format == "application/json") {
-        QJsonDocument doc = QJsonDocument::fromJson(output.payload);
-        logStream << "BGADataManager: After QJsonDocument::fromJson" << "\n";
-        if (doc.isNull()) {
-            emit errorOccurred("Invalid JSON output from analyzer.");
-            logStream << "BGADataManager: Invalid JSON output from analyzer." << "\n";
-            logFile.close();
-            emit loadingFinished();
-            return extractedTextsArray;
-        }
-
-        if (doc.isObject()) {
-            QJsonObject rootObj = doc.object();
-            if (rootObj.contains("strings") && rootObj["strings"].isArray()) {
-                extractedTextsArray = rootObj["strings"].toArray();
-            }
-            if (rootObj.contains("fonts") && rootObj["fonts"].isArray()) {
-                m_loadedFonts = rootObj["fonts"].toArray();
-                emit fontsLoaded(m_loadedFonts);
-            }
-        } else if (doc.isArray()) {
-            extractedTextsArray = doc.array();
-        }
-
-        emit progressUpdated(90, QString("Extracted %1 entries.").arg(extractedTextsArray.size()));
-        logStream << "BGADataManager: Extracted " << extractedTextsArray.size() << " entries." << "\n";
-        logStream << "BGADataManager: After extracting entries" << "\n";
+        return status;
+    }
 
-    } else {
-        logStream << "BGADataManager: Unsupported format detected: " << output.format << "\n";
-        emit errorOccurred(QString("Unsupported analyzer output format: %1").arg(output.format));
-        logStream << "BGADataManager: Unsupported analyzer output format." << "\n";
-        logFile.close();
+    if (sink.entryCount() == 0) {
+        emit errorOccurred(QString("No data extracted from project: %1").arg(projectPath));
+        BGA_LOG_WARNING("datamanager", QStringLiteral("No data extracted from project."));
         emit loadingFinished();
-        return extractedTextsArray;
+        return status;
     }
-    logStream << "BGADataManager: loadStringsFromGameProject returning." << "\n";
-    logFile.close();
+
+    emit progressUpdated(90, QString("Extracted %1 entries.").arg(sink.entryCount()));
+    BGA_LOG_INFO("datamanager", QStringLiteral("Extracted %1 entries from %2 files.")
+                                    .arg(sink.entryCount()).arg(sink.fileCount()));
     emit loadingFinished();
-    qDebug() << "BGADataManager: loadStringsFromGameProject finished in thread:" << QThread::currentThreadId();
-    return extractedTextsArray;
+    BGA_LOG_DEBUG("datamanager", QStringLiteral("loadStringsFromGameProject finished in thread: %1")
+                                     .arg(reinterpret_cast<quintptr>(QThread::currentThreadId())));
+    return status;
 }
     
 bool BGADataManager::saveStringsToGameProject(const QString &engineName, const QString &projectPath, const QMap<QString, QJsonArray> &data)
 {
-    std::unique_ptr<core::IGameAnalyzer> analyzer = core::createAnalyzer(engineName);
+    // Same analyzer as the load, which may still hold the parsed game files
+    QMutexLocker analyzerLock(&m_analyzerMutex);
+    core::IGameAnalyzer *analyzer = analyzerFor(engineName);
     if (!analyzer) {
         emit errorOccurred(QString("Failed to create analyzer for engine: %1").arg(engineName));
         return false;
@@ -125,9 +188,14 @@ bool BGADataManager::saveStringsToGameProject(const QString &engineName, const Q
 
     // Convert the QMap<QString, QJsonArray> to a single QJsonArray suitable for the analyzer's save method
     QJsonArray textsToSave;
-    for (const QJsonArray &fileTexts : data.values()) {
-        for (const QJsonValue &value : fileTexts) {
-            textsToSave.append(value);
+    for (auto it = data.constBegin(); it != data.constEnd(); ++it) {
+        for (const QJsonValue &value : it.value()) {
+            // Entries loaded from schema 2 payloads leave the file path to the map key
+            QJsonObject obj = value.toObject();
+            if (!obj.contains("path")) {
+                obj.insert("path", it.key());
+            }
+            textsToSave.append(obj);
         }
     }
 
@@ -177,9 +245,9 @@ bool BGADataManager::exportStringsToGameProject(const QString &engineName, const
     QDir targetDirectory(targetDir);
 
     QSet<QString> filesToProcess;
-    for (const QJsonArray &fileTexts : filteredData.values()) {
-        for (const QJsonValue &value : fileTexts) {
-             filesToProcess.insert(value.toObject()["path"].toString());
+    for (auto it = filteredData.constBegin(); it != filteredData.constEnd(); ++it) {
+        if (!it.value().isEmpty()) {
+            filesToProcess.insert(it.key());
         }
     }
 
@@ -206,10 +274,10 @@ bool BGADataManager::exportStringsToGameProject(const QString &engineName, const
     // Step 2: Create modified data with new paths
     // Create a NEW QJsonArray of all texts, but with paths adjusted to targetDir.
     QJsonArray allTexts;
-    for (const QJsonArray &fileTexts : filteredData.values()) {
-        for (const QJsonValue &val : fileTexts) {
+    for (auto it = filteredData.constBegin(); it != filteredData.constEnd(); ++it) {
+        for (const QJsonValue &val : it.value()) {
             QJsonObject obj = val.toObject();
-            QString originalPath = obj["path"].toString();
+            QString originalPath = it.key();
             QString relativePath = projectDir.relativeFilePath(originalPath);
             QString newPath = targetDirectory.filePath(relativePath);
             
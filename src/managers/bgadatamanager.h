@@ -7,6 +7,9 @@
 #include <QMap>
 #include <QPair>
 #include <QJsonArray>
+#include <QMutex>
+#include <atomic>
+#include <memory>
 
 // Include BGACore headers
 #include <core/gameanalyzer.h>
@@ -19,20 +22,47 @@ public:
     explicit BGADataManager(QObject *parent = nullptr);
 
     QStringList getAvailableAnalyzers() const;
-    QJsonArray loadStringsFromGameProject(const QString &engineName, const QString &projectPath);
+    // Extracted entries are handed out file by file through entriesLoaded() while the analysis
+    // runs; nothing is collected here. Cancelled and Failed loads may have delivered some files.
+    core::AnalysisStatus loadStringsFromGameProject(const QString &engineName, const QString &projectPath);
     bool saveStringsToGameProject(const QString &engineName, const QString &projectPath, const QMap<QString, QJsonArray> &data);
     bool exportStringsToGameProject(const QString &engineName, const QString &projectPath, const QString &targetDir, const QMap<QString, QJsonArray> &data, bool onlyTranslated = true);
     QPair<QString, QString> getScriptDetails(const QString &engineName, const QString &projectPath);
 
     QJsonArray loadedFonts() const;
+    void setLoadedFonts(const QJsonArray &fonts);
+
+    // Thread-safe: asks a running loadStringsFromGameProject() to stop after the current file
+    void cancelLoading();
+    bool isLoadingCancelled() const;
+
+    // Manifest used for incremental re-analysis; empty analyzes every file from scratch
+    void setAnalysisCacheFile(const QString &manifestPath);
+
+    // Memory the analyzer may use to keep parsed game files from load to save, so repeated
+    // saves skip reading and parsing them; 0 turns it off
+    static constexpr qint64 DefaultDocumentCacheBudget = 256 * 1024 * 1024;
+    void setDocumentCacheBudget(qint64 bytes);
 
 signals:
     void errorOccurred(const QString &message);
     void fontsLoaded(const QJsonArray &fonts);
     void progressUpdated(int percentage, const QString &message);
     void loadingFinished();
+    // Emitted from the loading thread as soon as the entries of one game file are extracted
+    void entriesLoaded(const QString &filePath, const QJsonArray &entries);
 
 private:
-    QJsonArray m_loadedFonts;};
+    // Analyzer kept from load to save, so the backend can reuse what it parsed while loading.
+    // Callers must hold m_analyzerMutex.
+    core::IGameAnalyzer *analyzerFor(const QString &engineName);
+
+    std::unique_ptr<core::IGameAnalyzer> m_analyzer;
+    QString m_analyzerEngine;
+    QMutex m_analyzerMutex;
+    QJsonArray m_loadedFonts;
+    QString m_analysisCacheFile;
+    qint64 m_documentCacheBudget = DefaultDocumentCacheBudget;
+    std::atomic_bool m_loadingCancelled{false};};
 
 #endif // BGADATAMANAGER_H
\ No newline at end of file
@@ -1,9 +1,8 @@
 #include "projectdatamanager.h"
+#include "core/logger.h"
 
 #include <QFileInfo>
-#include <QDebug>
 #include <QSet>
-#include <QtConcurrent>
 #include <QJsonDocument>
 #include <QFile>
 #include <QDir>
@@ -13,7 +12,6 @@ ProjectDataManager::ProjectDataManager(QStandardItemModel *fileListModel, QStand
     , m_fileListModel(fileListModel)
     , m_translationModel(translationModel)
 {
-    connect(&m_processingFutureWatcher, &QFutureWatcher<QPair<QMap<QString, QJsonArray>, QStringList>>::finished, this, &ProjectDataManager::onProcessingFinished);
 }
 
 QMap<QString, QJsonArray> &ProjectDataManager::getLoadedGameProjectData()
@@ -28,78 +26,42 @@ QString &ProjectDataManager::getCurrentLoadedFilePath()
 
 void ProjectDataManager::clearAllData()
 {
-    // Disconnect to signal to prevent handling "finished" from the cancelled future
-    disconnect(&m_processingFutureWatcher, nullptr, this, nullptr);
-    m_processingFutureWatcher.cancel();
-    
-    // Do NOT set empty future as it might cause Qt internal crash with complex types
-    // m_processingFutureWatcher.setFuture(...); 
-
     m_loadedGameProjectData.clear();
     m_currentLoadedFilePath.clear();
     m_fileListModel->clear();
     m_translationModel->clear();
-
-    // Reconnect the signal for the future usage
-    connect(&m_processingFutureWatcher, &QFutureWatcher<QPair<QMap<QString, QJsonArray>, QStringList>>::finished, this, &ProjectDataManager::onProcessingFinished);
 }
 
-void ProjectDataManager::onLoadingFinished(const QJsonArray &extractedTextsArray)
+void ProjectDataManager::onEntriesLoaded(const QString &filePath, const QJsonArray &entries)
 {
-    qDebug() << "ProjectDataManager: onLoadingFinished called with " << extractedTextsArray.size() << " entries. Starting background processing.";
-
-    QFuture<QPair<QMap<QString, QJsonArray>, QStringList>> future = QtConcurrent::run([extractedTextsArray]() {
-        qDebug() << "ProjectDataManager (background): Starting processing of" << extractedTextsArray.size() << "entries.";
-        QMap<QString, QJsonArray> fileMap;
-        QSet<QString> filePaths;
-
-        // Log first 5 entries for inspection
-        for (int i = 0; i < 5 && i < extractedTextsArray.size(); ++i) {
-            qDebug() << "ProjectDataManager (background): Sample entry" << i << ":" << extractedTextsArray.at(i).toObject();
-        }
-
-        for (const QJsonValue &value : extractedTextsArray) {
-            QJsonObject obj = value.toObject();
-            QString filePath = obj["path"].toString();
-            if (filePath.isEmpty()) {
-                // Let's log if we find an empty file path
-                if (filePaths.isEmpty()) { // Log only a few times to avoid spam
-                     qDebug() << "ProjectDataManager (background): Found entry with empty 'path' key. Object:" << obj;
-                }
-                continue;
-            }
-
-            fileMap[filePath].append(obj);
-            filePaths.insert(filePath);
-        }
-
-        // Sort by filename
-        QStringList sortedPaths = filePaths.values();
-        std::sort(sortedPaths.begin(), sortedPaths.end(), [](const QString &a, const QString &b) {
-            return QFileInfo(a).fileName() < QFileInfo(b).fileName();
-        });
+    if (filePath.isEmpty() || entries.isEmpty()) {
+        return;
+    }
 
-        qDebug() << "ProjectDataManager (background): Finished processing. Found" << sortedPaths.size() << "unique files.";
-        return qMakePair(fileMap, sortedPaths);
-    });
+    QJsonArray &fileEntries = m_loadedGameProjectData[filePath];
+    const bool newFile = fileEntries.isEmpty();
+    for (const QJsonValue &entry : entries) {
+        fileEntries.append(entry);
+    }
+    if (!newFile) {
+        return;
+    }
 
-    m_processingFutureWatcher.setFuture(future);
+    // Keep the list sorted by file name as files come in
+    const QString fileName = QFileInfo(filePath).fileName();
+    int row = 0;
+    while (row < m_fileListModel->rowCount() && m_fileListModel->item(row)->text() < fileName) {
+        ++row;
+    }
+    QStandardItem *item = new QStandardItem(fileName);
+    item->setData(filePath, Qt::UserRole);
+    m_fileListModel->insertRow(row, item);
 }
 
-void ProjectDataManager::onProcessingFinished()
+void ProjectDataManager::onLoadingFinished()
 {
-    qDebug() << "ProjectDataManager: Background processing finished.";
-    QPair<QMap<QString, QJsonArray>, QStringList> result = m_processingFutureWatcher.result();
-    m_loadedGameProjectData = result.first;
-    
-    m_fileListModel->clear();
-    for (const QString &path : result.second) {
-        QStandardItem *item = new QStandardItem(QFileInfo(path).fileName());
-        item->setData(path, Qt::UserRole);
-        m_fileListModel->appendRow(item);
-    }
-
-    qDebug() << "ProjectDataManager: Models updated. Emitting processingFinished signal.";
+    // The entries and the file list were filled by onEntriesLoaded()
+    BGA_LOG_DEBUG("projectdata", QStringLiteral("Loading finished with %1 files").arg(m_loadedGameProjectData.size()));
     emit processingFinished();
 }
 
@@ -189,7 +151,7 @@ void ProjectDataManager::saveGameProject()
             file.write(doc.toJson());
             file.close();
         } else {
-            qWarning() << "Failed to save file:" << filePath;
+            BGA_LOG_WARNING("projectdata", QStringLiteral("Failed to save file: %1").arg(filePath));
         }
     }
 }
@@ -227,7 +189,7 @@ bool ProjectDataManager::saveTranslationWorkspace(const QString &filePath)
 
     QFile file(filePath);
     if (!file.open(QIODevice::WriteOnly)) {
-        qWarning() << "Failed to open workspace file for writing:" << filePath;
+        BGA_LOG_WARNING("projectdata", QStringLiteral("Failed to open workspace file for writing: %1").arg(filePath));
         return false;
     }
 
@@ -241,7 +203,7 @@ bool ProjectDataManager::loadTranslationWorkspace(const QString &filePath)
 {
     QFile file(filePath);
     if (!file.open(QIODevice::ReadOnly)) {
-        qWarning() << "Failed to open workspace file for reading:" << filePath;
+        BGA_LOG_WARNING("projectdata", QStringLiteral("Failed to open workspace file for reading: %1").arg(filePath));
         return false;
     }
 
@@ -249,7 +211,7 @@ bool ProjectDataManager::loadTranslationWorkspace(const QString &filePath)
     file.close();
 
     if (doc.isNull() || !doc.isObject()) {
-        qWarning() << "Invalid workspace file format.";
+        BGA_LOG_WARNING("projectdata", QStringLiteral("Invalid workspace file format: %1").arg(filePath));
         return false;
     }
 
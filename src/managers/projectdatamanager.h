@@ -7,7 +7,6 @@
 #include <QMap>
 #include <QJsonArray>
 #include <QJsonObject>
-#include <QFutureWatcher>
 #include <QPair>
 #include <QSet>
 #include <QStringList>
@@ -36,13 +35,12 @@ public:
     bool loadTranslationWorkspace(const QString &filePath);
 
 public slots:
-    void onLoadingFinished(const QJsonArray &extractedTextsArray);
+    // Entries of one game file, delivered while the analysis is still running; the file is
+    // listed right away, in file name order
+    void onEntriesLoaded(const QString &filePath, const QJsonArray &entries);
+    void onLoadingFinished();
     void onFileSelected(const QModelIndex &index);
 
-private slots:
-    void onProcessingFinished();
-    
-
 signals:
     void processingFinished();
 
@@ -51,7 +49,6 @@ private:
     QStandardItemModel *m_translationModel;
     QMap<QString, QJsonArray> m_loadedGameProjectData;
     QString m_currentLoadedFilePath;
-    QFutureWatcher<QPair<QMap<QString, QJsonArray>, QStringList>> m_processingFutureWatcher;
     bool m_hideCompleted = false;
     QString m_projectPath;
     QString m_engineName;
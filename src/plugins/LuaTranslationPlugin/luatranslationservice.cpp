@@ -1,6 +1,6 @@
 #include "luatranslationservice.h"
+#include "core/logger.h"
 #include <QFileInfo>
-#include <QDebug>
 #include <QNetworkRequest>
 #include <QNetworkReply>
 #include <QEventLoop>
@@ -80,7 +80,7 @@ bool LuaWorker::initLua()
 
     if (luaL_dofile(L, m_scriptPath.toStdString().c_str()) != LUA_OK) {
         QString error = lua_tostring(L, -1);
-        qCritical() << "Failed to load Lua script:" << m_scriptPath << error;
+        BGA_LOG_ERROR("lua", QStringLiteral("Failed to load Lua script: %1 (%2)").arg(m_scriptPath, error));
         emit errorOccurred(QString("Failed to load script: %1").arg(error));
         lua_close(L);
         L = nullptr;
@@ -94,7 +94,7 @@ int LuaWorker::lua_log(lua_State *L)
     // Get 'this' from upvalue
     LuaWorker* worker = static_cast<LuaWorker*>(lua_touserdata(L, lua_upvalueindex(1)));
     const char* msg = lua_tostring(L, 1);
-    qDebug() << "[Lua]" << msg;
+    BGA_LOG_DEBUG("lua", QString::fromUtf8(msg));
     if (worker) {
         emit worker->logMessage(QString::fromUtf8(msg));
     }
@@ -343,7 +343,7 @@ void LuaWorker::processTranslation(const QString &sourceText)
     // Expect 2 return values: result, error_message
     if (lua_pcall(L, 1, 2, 0) != LUA_OK) {
         QString error = lua_tostring(L, -1);
-        qCritical() << "Error calling on_text_extract:" << error;
+        BGA_LOG_ERROR("lua", QStringLiteral("Error calling on_text_extract: %1").arg(error));
         emit errorOccurred(QString("Lua execution error: %1").arg(error));
         lua_pop(L, 1);
         return;
@@ -382,7 +382,7 @@ void LuaWorker::processBatchTranslation(const QStringList &sourceTexts)
         // Fallback to sequential? Or just error?
         // Let's fallback to sequential for compatibility, but it defeats the purpose of batching.
         // Better to log a warning and do sequential.
-        qWarning() << "Script does not support on_batch_text_extract. Falling back to sequential.";
+        BGA_LOG_WARNING("lua", QStringLiteral("Script does not support on_batch_text_extract. Falling back to sequential."));
         
         QList<qtlingo::TranslationResult> results;
         for (const QString &text : sourceTexts) {
@@ -423,7 +423,7 @@ void LuaWorker::processBatchTranslation(const QStringList &sourceTexts)
     // Expect 2 return values: result_table, error_message
     if (lua_pcall(L, 1, 2, 0) != LUA_OK) {
         QString error = lua_tostring(L, -1);
-        qCritical() << "Error calling on_batch_text_extract:" << error;
+        BGA_LOG_ERROR("lua", QStringLiteral("Error calling on_batch_text_extract: %1").arg(error));
         emit errorOccurred(QString("Lua execution error: %1").arg(error));
         lua_pop(L, 1);
         return;
@@ -4,6 +4,7 @@
 #include "pluginmanagerdialog.h"
 #include "loadprojectdialog.h"
 #include "fontmanagerdialog.h"
+#include <core/analysiscache.h>
 
 #include <QFileIconProvider>
 #include <QInputDialog>
@@ -32,7 +33,7 @@ FileTranslationWidget::FileTranslationWidget(TranslationServiceManager *serviceM
     connectManagerSignals();
     setupTimers();
 
-    connect(&m_loadFutureWatcher, &QFutureWatcher<QJsonArray>::finished, this, &FileTranslationWidget::onLoadingFinished);
+    connect(&m_loadFutureWatcher, &QFutureWatcher<core::AnalysisStatus>::finished, this, &FileTranslationWidget::onLoadingFinished);
     connect(ui->fileListView, &QListView::clicked, m_projectDataManager, &ProjectDataManager::onFileSelected);
 }
 
@@ -147,6 +148,10 @@ void FileTranslationWidget::connectManagerSignals()
             this, &FileTranslationWidget::onBGADataError);
     connect(m_bgaDataManager, &BGADataManager::fontsLoaded, 
             this, &FileTranslationWidget::onFontsLoaded);
+    // Queued from the loading thread. The calls are posted before the load future finishes, so
+    // every file has been delivered by the time onLoadingFinished() runs.
+    connect(m_bgaDataManager, &BGADataManager::entriesLoaded,
+            m_projectDataManager, &ProjectDataManager::onEntriesLoaded, Qt::QueuedConnection);
     connect(m_bgaDataManager, &BGADataManager::progressUpdated, this, [this](int value, const QString &message) {
         if (m_progressDialog) {
             m_progressDialog->setValue(value);
@@ -283,12 +288,19 @@ void FileTranslationWidget::onNewProject(const QString &engineName, const QStrin
     m_progressDialog->setWindowModality(Qt::WindowModal);
     m_progressDialog->setValue(0);
     m_progressDialog->setLabelText(tr("Analyzing game project..."));
+    // Closing the dialog (Esc) stops the analysis after the file being extracted
+    connect(m_progressDialog, &QDialog::rejected, m_bgaDataManager, &BGADataManager::cancelLoading, Qt::DirectConnection);
     m_progressDialog->show();
 
     m_isImporting = true; // Set flag start
 
+    // Unchanged game files are reused from the manifest next to the workspace
+    m_bgaDataManager->setAnalysisCacheFile(m_currentProjectFile.isEmpty()
+        ? QString()
+        : core::AnalysisCache::pathForWorkspace(m_currentProjectFile));
+
     // Use lambda to call BGADataManager
-    QFuture<QJsonArray> future = QtConcurrent::run([this, engineName, projectPath]() {
+    QFuture<core::AnalysisStatus> future = QtConcurrent::run([this, engineName, projectPath]() {
         return m_bgaDataManager->loadStringsFromGameProject(engineName, projectPath);
     });
     
@@ -321,13 +333,19 @@ void FileTranslationWidget::onLoadingFinished()
         m_progressDialog = nullptr;
     }
     
-    QJsonArray extractedTextsArray = m_loadFutureWatcher.result();
-    if (extractedTextsArray.isEmpty()) {
+    const core::AnalysisStatus status = m_loadFutureWatcher.result();
+    if (status != core::AnalysisStatus::Finished) {
+        // Cancelled by the user, or failed with the error already reported: drop the files that
+        // were delivered before the analysis stopped
+        m_projectDataManager->clearAllData();
+        return;
+    }
+    if (m_projectDataManager->getLoadedGameProjectData().isEmpty()) {
         QMessageBox::warning(this, tr("Warning"), tr("No translatable text found in this project.\nCheck if the format is supported (RPG Maker MV/MZ)."));
         return;
     }
 
-    m_projectDataManager->onLoadingFinished(extractedTextsArray);
+    m_projectDataManager->onLoadingFinished();
 
     // Auto-save MOVED to onProjectProcessingFinished
 }
@@ -125,7 +125,7 @@ private:
     ProjectDataManager *m_projectDataManager;
     
     CustomProgressDialog *m_progressDialog;
-    QFutureWatcher<QJsonArray> m_loadFutureWatcher;
+    QFutureWatcher<core::AnalysisStatus> m_loadFutureWatcher;
     
     // Settings (cached locally for use in translation jobs)
     QString m_apiKey;